@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Helpers shared by the benchmarks.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <magic_enum.hpp>
+
+#include "clap/debug/allocation_stats.h"
+
+namespace asap::clap::bench {
+
+/*!
+ * \brief Report the throughput of a benchmark which processes `tokens` tokens
+ * made of `bytes` bytes in each iteration.
+ *
+ * In addition to the tokens and bytes per second, the average time spent per
+ * token and per byte is reported in the `t/token` and `t/byte` counters.
+ */
+inline void ReportThroughput(
+    benchmark::State &state, std::size_t tokens, std::size_t bytes) {
+  const auto iterations = static_cast<std::int64_t>(state.iterations());
+  state.SetItemsProcessed(iterations * static_cast<std::int64_t>(tokens));
+  state.SetBytesProcessed(iterations * static_cast<std::int64_t>(bytes));
+  state.counters["t/token"] = benchmark::Counter(static_cast<double>(tokens),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+  state.counters["t/byte"] = benchmark::Counter(static_cast<double>(bytes),
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+}
+
+/*!
+ * \brief Report the allocations counted since the last call to
+ * `debug::ResetAllocationStats()`, averaged per iteration.
+ *
+ * The `allocs` and `alloc_bytes` counters are the totals for all the parsing
+ * phases, and each phase with allocations gets its own `allocs:<phase>`
+ * counter.
+ */
+inline void ReportAllocations(benchmark::State &state) {
+  const auto stats = debug::GetAllocationStats();
+  const auto total = stats.Total();
+  state.counters["allocs"] =
+      benchmark::Counter(static_cast<double>(total.allocations),
+          benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes"] = benchmark::Counter(
+      static_cast<double>(total.bytes), benchmark::Counter::kAvgIterations);
+  for (const auto phase : magic_enum::enum_values<debug::ParsePhase>()) {
+    const auto allocations = stats.Of(phase).allocations;
+    if (phase != debug::ParsePhase::None && allocations != 0) {
+      state.counters["allocs:" + std::string{magic_enum::enum_name(phase)}] =
+          benchmark::Counter(static_cast<double>(allocations),
+              benchmark::Counter::kAvgIterations);
+    }
+  }
+}
+
+} // namespace asap::clap::bench
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "cli_fixtures.h"
+#include "clap/command_line_context.h"
+#include "clap/parse_session.h"
+
+#include <cstdint>
+#include <string>
+
+namespace asap::clap::bench {
+
+namespace {
+
+auto ShapeOf(const benchmark::State &state) -> CliShape {
+  return ALL_CLI_SHAPES.at(static_cast<std::size_t>(state.range(0)));
+}
+
+/*
+ * Build phase: create the whole CLI with the fluent builders.
+ */
+void BM_BuildCli(benchmark::State &state) {
+  const auto shape = ShapeOf(state);
+  state.SetLabel(std::string{CliShapeName(shape)});
+  for (auto _ : state) {
+    auto cli = BuildCli(shape);
+    benchmark::DoNotOptimize(cli);
+  }
+}
+BENCHMARK(BM_BuildCli)
+    ->DenseRange(0, ALL_CLI_SHAPES.size() - 1)
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * Parse phase: parse a recorded command line, end to end, with a CLI built
+ * once upfront.
+ */
+void BM_ParseCli(benchmark::State &state) {
+  const auto shape = ShapeOf(state);
+  state.SetLabel(std::string{CliShapeName(shape)});
+  const auto cli = BuildCli(shape);
+  const auto command_line = RecordCommandLine(shape);
+  try {
+    cli->Parse(command_line.Argc(), command_line.Argv());
+  } catch (const CmdLineArgumentsError &error) {
+    state.SkipWithError(error.what());
+    return;
+  }
+
+  debug::ResetAllocationStats();
+  for (auto _ : state) {
+    const auto result = cli->Parse(command_line.Argc(), command_line.Argv());
+    benchmark::DoNotOptimize(result.ovm);
+  }
+  ReportThroughput(state, command_line.Arguments(), command_line.Bytes());
+  ReportAllocations(state);
+}
+BENCHMARK(BM_ParseCli)->DenseRange(0, ALL_CLI_SHAPES.size() - 1);
+
+/*
+ * Parse phase with a `ParseSession`, as done by a long lived process parsing
+ * many command lines with the same CLI: the parsing machinery is created once
+ * and reused by all iterations.
+ */
+void BM_ParseSession(benchmark::State &state) {
+  const auto shape = ShapeOf(state);
+  state.SetLabel(std::string{CliShapeName(shape)});
+  const auto cli = BuildCli(shape);
+  const auto command_line = RecordCommandLine(shape);
+  ParseSession session(*cli);
+  try {
+    session.Parse(command_line.Argc(), command_line.Argv());
+  } catch (const CmdLineArgumentsError &error) {
+    state.SkipWithError(error.what());
+    return;
+  }
+
+  debug::ResetAllocationStats();
+  for (auto _ : state) {
+    const auto &context =
+        session.Parse(command_line.Argc(), command_line.Argv());
+    benchmark::DoNotOptimize(context.ovm);
+  }
+  ReportThroughput(state, command_line.Arguments(), command_line.Bytes());
+  ReportAllocations(state);
+}
+BENCHMARK(BM_ParseSession)->DenseRange(0, ALL_CLI_SHAPES.size() - 1);
+
+/*
+ * The same command line parsed one million times, with a new parse each time
+ * and with a session, to compare the sustained parsing rate of both.
+ */
+constexpr benchmark::IterationCount REPEATED_PARSES = 1'000'000;
+BENCHMARK(BM_ParseCli)
+    ->Arg(static_cast<std::int64_t>(CliShape::GitLike))
+    ->Iterations(REPEATED_PARSES);
+BENCHMARK(BM_ParseSession)
+    ->Arg(static_cast<std::int64_t>(CliShape::GitLike))
+    ->Iterations(REPEATED_PARSES);
+
+} // namespace
+
+} // namespace asap::clap::bench
@@ -0,0 +1,290 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation of the CLI fixtures used by the benchmarks.
+ */
+
+#include "cli_fixtures.h"
+
+#include <common/compilers.h>
+
+#include "clap/fluent/dsl.h"
+
+namespace asap::clap::bench {
+
+namespace {
+
+constexpr std::size_t GIT_GROUPS = 5;
+constexpr std::size_t GIT_SUB_GROUPS = 5;
+constexpr std::size_t GIT_COMMANDS = 6;
+
+constexpr std::array<const char *, 20> KUBECTL_VERBS{"get", "describe",
+    "create", "delete", "apply", "edit", "patch", "label", "annotate", "scale",
+    "rollout", "logs", "exec", "port-forward", "explain", "expose", "autoscale",
+    "cordon", "drain", "taint"};
+constexpr std::size_t KUBECTL_RESOURCES = 150;
+constexpr std::size_t KUBECTL_COMMAND_OPTIONS = 5;
+
+constexpr std::size_t DEFAULT_ONLY_OPTIONS = 500;
+
+auto ShortName(std::size_t index) -> std::string {
+  return std::string(1,
+      static_cast<char>(index < 26 ? 'a' + index : 'A' + (index - 26)));
+}
+
+auto RestOfArguments() -> std::shared_ptr<Option> {
+  return Option::Rest()
+      .About("the files to process")
+      .WithValue<std::string>()
+      .Build();
+}
+
+/*
+ * The 40 options of a git like command: 10 flags with a short name, 10
+ * integer options, 15 string options and 5 repeatable string options.
+ */
+void AddGitLikeOptions(CommandBuilder &builder) {
+  for (std::size_t index = 0; index < 10; ++index) {
+    builder.WithOption(Option::WithKey("flag-" + std::to_string(index))
+                           .About("a boolean flag")
+                           .Short(ShortName(index))
+                           .Long("flag-" + std::to_string(index))
+                           .WithValue<bool>()
+                           .Build());
+  }
+  for (std::size_t index = 0; index < 10; ++index) {
+    builder.WithOption(Option::WithKey("count-" + std::to_string(index))
+                           .About("an integer option")
+                           .Long("count-" + std::to_string(index))
+                           .WithValue<int>()
+                           .DefaultValue(static_cast<int>(index))
+                           .Build());
+  }
+  for (std::size_t index = 0; index < 15; ++index) {
+    builder.WithOption(Option::WithKey("name-" + std::to_string(index))
+                           .About("a string option")
+                           .Long("name-" + std::to_string(index))
+                           .WithValue<std::string>()
+                           .Build());
+  }
+  for (std::size_t index = 0; index < 5; ++index) {
+    builder.WithOption(Option::WithKey("include-" + std::to_string(index))
+                           .About("a repeatable string option")
+                           .Long("include-" + std::to_string(index))
+                           .WithValue<std::string>()
+                           .Repeatable()
+                           .Build());
+  }
+}
+
+auto BuildGitLikeCli() -> std::unique_ptr<Cli> {
+  CliBuilder cli;
+  cli.ProgramName("git").Version("1.0.0").About("a git like tool");
+  for (std::size_t group = 0; group < GIT_GROUPS; ++group) {
+    for (std::size_t sub_group = 0; sub_group < GIT_SUB_GROUPS; ++sub_group) {
+      for (std::size_t command = 0; command < GIT_COMMANDS; ++command) {
+        CommandBuilder builder("group-" + std::to_string(group),
+            "sub-" + std::to_string(sub_group),
+            "cmd-" + std::to_string(command));
+        builder.About("a git like sub-command");
+        AddGitLikeOptions(builder);
+        builder.WithPositionalArguments(RestOfArguments());
+        cli.WithCommand(builder.Build());
+      }
+    }
+  }
+  return cli.WithHelpCommand().WithVersionCommand().Build();
+}
+
+auto KubectlCommonOptions() -> std::shared_ptr<Options> {
+  auto options = std::make_shared<Options>("Global options");
+  options->Add(Option::WithKey("namespace")
+                   .About("the namespace scope for this request")
+                   .Short("n")
+                   .Long("namespace")
+                   .WithValue<std::string>()
+                   .DefaultValue("default")
+                   .Build());
+  options->Add(Option::WithKey("output")
+                   .About("output format")
+                   .Short("o")
+                   .Long("output")
+                   .WithValue<std::string>()
+                   .Build());
+  options->Add(Option::WithKey("selector")
+                   .About("selector (label query) to filter on")
+                   .Short("l")
+                   .Long("selector")
+                   .WithValue<std::string>()
+                   .Build());
+  options->Add(Option::WithKey("all-namespaces")
+                   .About("list the requested objects across all namespaces")
+                   .Short("A")
+                   .Long("all-namespaces")
+                   .WithValue<bool>()
+                   .Build());
+  for (const auto *name : {"kubeconfig", "context", "cluster", "user", "token",
+           "server", "request-timeout", "certificate-authority"}) {
+    options->Add(Option::WithKey(name)
+                     .About("a connection option")
+                     .Long(name)
+                     .WithValue<std::string>()
+                     .Build());
+  }
+  options->Add(Option::WithKey("insecure-skip-tls-verify")
+                   .About("do not check the server certificate")
+                   .Long("insecure-skip-tls-verify")
+                   .WithValue<bool>()
+                   .Build());
+  options->Add(Option::WithKey("verbosity")
+                   .About("log level verbosity")
+                   .Short("v")
+                   .Long("verbosity")
+                   .WithValue<int>()
+                   .DefaultValue(0)
+                   .Build());
+  return options;
+}
+
+auto BuildKubectlLikeCli() -> std::unique_ptr<Cli> {
+  const auto common_options = KubectlCommonOptions();
+  CliBuilder cli;
+  cli.ProgramName("kubectl").Version("1.0.0").About("a kubectl like tool");
+  for (const auto *verb : KUBECTL_VERBS) {
+    for (std::size_t resource = 0; resource < KUBECTL_RESOURCES; ++resource) {
+      CommandBuilder builder(verb, "resource-" + std::to_string(resource));
+      builder.About("a kubectl like sub-command");
+      builder.WithOptions(common_options);
+      for (std::size_t index = 0; index < KUBECTL_COMMAND_OPTIONS; ++index) {
+        builder.WithOption(Option::WithKey("field-" + std::to_string(index))
+                               .About("a command specific option")
+                               .Long("field-" + std::to_string(index))
+                               .WithValue<std::string>()
+                               .Build());
+      }
+      builder.WithPositionalArguments(RestOfArguments());
+      cli.WithCommand(builder.Build());
+    }
+  }
+  return cli.WithHelpCommand().WithVersionCommand().Build();
+}
+
+/*
+ * Options of the default only CLI cycle through flags, integers and strings.
+ * The first 52 options also have a short name.
+ */
+auto BuildDefaultOnlyCli() -> std::unique_ptr<Cli> {
+  CommandBuilder builder(Command::DEFAULT);
+  for (std::size_t index = 0; index < DEFAULT_ONLY_OPTIONS; ++index) {
+    auto option = Option::WithKey("option-" + std::to_string(index));
+    option.About("an option").Long("option-" + std::to_string(index));
+    if (index < 52) {
+      option.Short(ShortName(index));
+    }
+    switch (index % 3) {
+    case 0:
+      builder.WithOption(option.WithValue<bool>().Build());
+      break;
+    case 1:
+      builder.WithOption(option.WithValue<int>().Build());
+      break;
+    default:
+      builder.WithOption(option.WithValue<std::string>().Build());
+    }
+  }
+  builder.WithPositionalArguments(RestOfArguments());
+  return CliBuilder()
+      .ProgramName("tool")
+      .Version("1.0.0")
+      .About("a tool with many options")
+      .WithCommand(builder.Build())
+      .Build();
+}
+
+} // namespace
+
+auto CliShapeName(CliShape shape) -> std::string_view {
+  switch (shape) {
+  case CliShape::GitLike:
+    return "git";
+  case CliShape::KubectlLike:
+    return "kubectl";
+  case CliShape::DefaultOnly:
+    return "default-only";
+  default:
+    ASAP_UNREACHABLE();
+  }
+}
+
+auto BuildCli(CliShape shape) -> std::unique_ptr<Cli> {
+  switch (shape) {
+  case CliShape::GitLike:
+    return BuildGitLikeCli();
+  case CliShape::KubectlLike:
+    return BuildKubectlLikeCli();
+  case CliShape::DefaultOnly:
+    return BuildDefaultOnlyCli();
+  default:
+    ASAP_UNREACHABLE();
+  }
+}
+
+RecordedCommandLine::RecordedCommandLine(std::vector<std::string> args)
+    : args_{std::move(args)} {
+  argv_.reserve(args_.size());
+  for (const auto &arg : args_) {
+    argv_.push_back(arg.c_str());
+  }
+}
+
+auto RecordedCommandLine::Bytes() const -> std::size_t {
+  std::size_t bytes = 0;
+  for (auto arg = std::next(args_.cbegin()); arg != args_.cend(); ++arg) {
+    bytes += arg->size();
+  }
+  return bytes;
+}
+
+auto RecordCommandLine(CliShape shape) -> RecordedCommandLine {
+  switch (shape) {
+  case CliShape::GitLike:
+    return RecordedCommandLine({"git", "group-4", "sub-4", "cmd-5", "-abc",
+        "--name-3=origin", "--count-2", "42", "--include-0", "src",
+        "--include-0", "test", "-j", "--name-14", "value", "file1.txt",
+        "file2.txt"});
+  case CliShape::KubectlLike:
+    return RecordedCommandLine({"kubectl", "get", "resource-142", "-n",
+        "kube-system", "-o", "wide", "--selector=app=web", "-A",
+        "--request-timeout", "30s", "--field-3=x", "--verbosity=4"});
+  case CliShape::DefaultOnly: {
+    std::vector<std::string> args{"tool", "-d", "-g"};
+    for (const std::size_t index :
+        {0, 25, 50, 77, 100, 150, 199, 250, 301, 333, 400, 450, 497, 499}) {
+      const auto name = "--option-" + std::to_string(index);
+      switch (index % 3) {
+      case 0:
+        args.push_back(name);
+        break;
+      case 1:
+        args.push_back(name + "=7");
+        break;
+      default:
+        args.push_back(name);
+        args.emplace_back("value");
+      }
+    }
+    args.emplace_back("file.txt");
+    return RecordedCommandLine(std::move(args));
+  }
+  default:
+    ASAP_UNREACHABLE();
+  }
+}
+
+} // namespace asap::clap::bench
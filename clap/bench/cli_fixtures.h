@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Synthetic, realistically sized command line interfaces, and recorded
+ * command lines for them, used by the end-to-end benchmarks.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clap/cli.h"
+
+namespace asap::clap::bench {
+
+/*!
+ * \brief The shapes of command line interfaces generated by the fixtures.
+ */
+enum class CliShape : std::uint8_t {
+  /*!
+   * A `git` like tool: 150 sub-commands, three path segments deep (5 groups
+   * of 5 sub-groups of 6 commands), each with 40 options of various types.
+   */
+  GitLike,
+  /*!
+   * A `kubectl` like tool: thousands of `verb resource` sub-commands (20
+   * verbs for 150 resources), sharing a group of common options and each with
+   * a few options of its own.
+   */
+  KubectlLike,
+  /*!
+   * A tool with only a default command accepting 500 options.
+   */
+  DefaultOnly,
+};
+
+constexpr std::array<CliShape, 3> ALL_CLI_SHAPES{
+    CliShape::GitLike, CliShape::KubectlLike, CliShape::DefaultOnly};
+
+/*! \brief A short name for the CLI shape, used as a benchmark label. */
+auto CliShapeName(CliShape shape) -> std::string_view;
+
+/*!
+ * \brief Build a command line interface of the given shape, using the fluent
+ * builders API.
+ */
+auto BuildCli(CliShape shape) -> std::unique_ptr<Cli>;
+
+/*!
+ * \brief A command line recorded for a CLI shape, including the program name
+ * as the first argument.
+ */
+class RecordedCommandLine {
+public:
+  explicit RecordedCommandLine(std::vector<std::string> args);
+
+  [[nodiscard]] auto Argc() const -> int {
+    return static_cast<int>(argv_.size());
+  }
+
+  [[nodiscard]] auto Argv() const -> const char ** {
+    return argv_.data();
+  }
+
+  /*! \brief Total size of the arguments, excluding the program name. */
+  [[nodiscard]] auto Bytes() const -> std::size_t;
+
+  /*! \brief Number of arguments, excluding the program name. */
+  [[nodiscard]] auto Arguments() const -> std::size_t {
+    return args_.size() - 1;
+  }
+
+private:
+  std::vector<std::string> args_;
+  mutable std::vector<const char *> argv_;
+};
+
+/*!
+ * \brief A typical command line for the given CLI shape, which parses
+ * successfully.
+ */
+auto RecordCommandLine(CliShape shape) -> RecordedCommandLine;
+
+} // namespace asap::clap::bench
@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief The benchmark helper program, with its command line interface built
+ * at runtime, executed by the cold start benchmarks.
+ *
+ * The exit status is the number of heap allocations made before the command
+ * line is parsed (capped at 254), or 255 if parsing failed.
+ */
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../program_fixtures.h"
+
+auto main(int argc, const char **argv) -> int {
+  using asap::clap::debug::GetAllocationStats;
+  using asap::clap::debug::ParsePhase;
+
+  try {
+    const auto cli = asap::clap::bench::BuildDynamicProgram();
+    const auto allocations_before_parse =
+        GetAllocationStats().Of(ParsePhase::None).allocations;
+
+    const auto result = cli->Parse(argc, argv);
+    static_cast<void>(result);
+    return static_cast<int>(
+        std::min<std::size_t>(allocations_before_parse, 254));
+  } catch (...) {
+    return 255;
+  }
+}
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "program_fixtures.h"
+
+#if defined(ASAP_CLAP_COLD_EXEC_STATIC) &&                                     \
+    defined(ASAP_CLAP_COLD_EXEC_DYNAMIC) && defined(__unix__)
+
+#include <array>
+
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace asap::clap::bench {
+
+namespace {
+
+/*
+ * Run `program` with the helper program's command line, and return its exit
+ * status, or -1 if it could not be run.
+ */
+auto RunProgram(const char *program) -> int {
+  auto argv = PROGRAM_COMMAND_LINE;
+  argv[0] = program;
+  std::array<char *, PROGRAM_COMMAND_LINE.size() + 1> args{};
+  for (std::size_t index = 0; index < argv.size(); ++index) {
+    // posix_spawn does not modify the arguments, despite its signature.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    args.at(index) = const_cast<char *>(argv.at(index));
+  }
+  pid_t pid{};
+  if (posix_spawn(&pid, program, nullptr, nullptr, args.data(), environ) !=
+      0) {
+    return -1;
+  }
+  int status{};
+  if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+    return -1;
+  }
+  return WEXITSTATUS(status);
+}
+
+/*
+ * Cold start: execute a short lived helper program which defines its command
+ * line interface and parses a typical command line, once per iteration. The
+ * `allocs_before_parse` counter is the number of heap allocations the helper
+ * made before parsing.
+ */
+void ColdExec(benchmark::State &state, const char *program) {
+  auto status = RunProgram(program);
+  if (status < 0 || status == 255) {
+    state.SkipWithError("the helper program failed");
+    return;
+  }
+  for (auto _ : state) {
+    status = RunProgram(program);
+    benchmark::DoNotOptimize(status);
+  }
+  state.counters["allocs_before_parse"] = static_cast<double>(status);
+}
+
+void BM_ColdExecStaticCli(benchmark::State &state) {
+  ColdExec(state, ASAP_CLAP_COLD_EXEC_STATIC);
+}
+BENCHMARK(BM_ColdExecStaticCli)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+void BM_ColdExecDynamicCli(benchmark::State &state) {
+  ColdExec(state, ASAP_CLAP_COLD_EXEC_DYNAMIC);
+}
+BENCHMARK(BM_ColdExecDynamicCli)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+} // namespace asap::clap::bench
+
+#endif
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "clap/fluent/dsl.h"
+
+#include <memory>
+#include <string>
+
+namespace asap::clap::bench {
+
+namespace {
+
+/*
+ * Make a command with the given number of options. All options have a long
+ * name; the first 52 also have a short name (a-z, A-Z).
+ */
+auto MakeCommand(std::size_t options_count) -> std::unique_ptr<Command> {
+  CommandBuilder builder(Command::DEFAULT);
+  for (std::size_t index = 0; index < options_count; ++index) {
+    auto option = Option::WithKey("option-" + std::to_string(index));
+    option.Long("option-" + std::to_string(index));
+    if (index < 26) {
+      option.Short(std::string(1, static_cast<char>('a' + index)));
+    } else if (index < 52) {
+      option.Short(std::string(1, static_cast<char>('A' + index - 26)));
+    }
+    builder.WithOption(option.WithValue<std::string>().Build());
+  }
+  return builder.Build();
+}
+
+void BM_FindShortOption(benchmark::State &state) {
+  const auto options_count = static_cast<std::size_t>(state.range(0));
+  const auto command = MakeCommand(options_count);
+  // The last option with a short name, and a name that does not match
+  const std::string found = options_count < 52
+                                ? std::string(1, 'a' + options_count - 1)
+                                : std::string{"Z"};
+  const std::string missing = "0";
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(command->FindShortOption(found));
+    benchmark::DoNotOptimize(command->FindShortOption(missing));
+  }
+  ReportThroughput(state, 2, found.size() + missing.size());
+}
+BENCHMARK(BM_FindShortOption)->RangeMultiplier(10)->Range(10, 10000);
+
+void BM_FindLongOption(benchmark::State &state) {
+  const auto options_count = static_cast<std::size_t>(state.range(0));
+  const auto command = MakeCommand(options_count);
+  // The first option, the last option, and a name that does not match
+  const std::string first = "option-0";
+  const std::string last = "option-" + std::to_string(options_count - 1);
+  const std::string missing = "no-such-option";
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(command->FindLongOption(first));
+    benchmark::DoNotOptimize(command->FindLongOption(last));
+    benchmark::DoNotOptimize(command->FindLongOption(missing));
+  }
+  ReportThroughput(state, 3, first.size() + last.size() + missing.size());
+}
+BENCHMARK(BM_FindLongOption)->RangeMultiplier(10)->Range(10, 10000);
+
+} // namespace
+
+} // namespace asap::clap::bench
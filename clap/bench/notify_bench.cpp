@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace asap::clap::bench {
+
+namespace {
+
+constexpr int INPUTS_COUNT = 10000;
+
+auto MakeCli(bool on_worker_thread, std::size_t &opened)
+    -> std::unique_ptr<Cli> {
+  CliBuilder builder;
+  if (on_worker_thread) {
+    builder.WithNotificationsOnWorkerThread();
+  }
+  // Each input is opened as soon as it is on the command line, as an ingest
+  // tool would do.
+  return builder.ProgramName("ingest")
+      .WithCommand(CommandBuilder(Command::DEFAULT)
+                       .WithOption(Option::WithKey("input")
+                                       .Short("i")
+                                       .WithValue<std::string>()
+                                       .Repeatable()
+                                       .NotifyOnEachValue(
+                                           [&opened](const std::string &path) {
+                                             if (auto *file = std::fopen(
+                                                     path.c_str(), "r")) {
+                                               ++opened;
+                                               std::fclose(file);
+                                             }
+                                           })
+                                       .Build()))
+      .Build();
+}
+
+/*
+ * Parse a long list of inputs which are each opened by a callback, with the
+ * callbacks running on the parser's thread (0) or on a worker thread (1).
+ */
+void BM_ParseWithEachValueCallback(benchmark::State &state) {
+  const auto on_worker_thread = state.range(0) != 0;
+  state.SetLabel(on_worker_thread ? "worker thread" : "parser thread");
+  std::size_t opened = 0;
+  const auto cli = MakeCli(on_worker_thread, opened);
+  std::vector<const char *> argv{"ingest"};
+  for (int input = 0; input < INPUTS_COUNT; ++input) {
+    argv.push_back("-i");
+    argv.push_back("/dev/null");
+  }
+  for (auto _ : state) {
+    const auto result =
+        cli->Parse(static_cast<int>(argv.size()), argv.data());
+    benchmark::DoNotOptimize(result.ovm);
+  }
+  state.counters["opened"] = benchmark::Counter(
+      static_cast<double>(opened), benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * INPUTS_COUNT);
+}
+BENCHMARK(BM_ParseWithEachValueCallback)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+
+} // namespace asap::clap::bench
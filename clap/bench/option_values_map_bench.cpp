@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+#include "clap/option_values_map.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace asap::clap::bench {
+
+namespace {
+
+auto MakeOptionNames(std::size_t count) -> std::vector<std::string> {
+  std::vector<std::string> names;
+  names.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    names.push_back("option-" + std::to_string(index));
+  }
+  return names;
+}
+
+/*
+ * Store one value for each of a number of distinct options, given by the
+ * benchmark argument, in a fresh map.
+ */
+void BM_StoreValueDistinctOptions(benchmark::State &state) {
+  const auto names = MakeOptionNames(static_cast<std::size_t>(state.range(0)));
+  std::size_t bytes = 0;
+  for (const auto &name : names) {
+    bytes += name.size();
+  }
+
+  for (auto _ : state) {
+    OptionValuesMap ovm;
+    for (const auto &name : names) {
+      ovm.StoreValue(name, OptionValue{42, "42", false});
+    }
+    benchmark::DoNotOptimize(ovm);
+  }
+  ReportThroughput(state, names.size(), bytes);
+}
+BENCHMARK(BM_StoreValueDistinctOptions)->RangeMultiplier(10)->Range(10, 1000);
+
+/*
+ * Store a number of values, given by the benchmark argument, for the same
+ * repeatable option.
+ */
+void BM_StoreValueRepeatedOption(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const std::string name = "include";
+  const std::string token = "some/include/path";
+
+  for (auto _ : state) {
+    OptionValuesMap ovm;
+    for (std::size_t index = 0; index < count; ++index) {
+      ovm.StoreValue(name, OptionValue{token, token, false});
+    }
+    benchmark::DoNotOptimize(ovm);
+  }
+  ReportThroughput(state, count, count * token.size());
+}
+BENCHMARK(BM_StoreValueRepeatedOption)->RangeMultiplier(10)->Range(10, 1000);
+
+/*
+ * Parse and store a number of values, given by the benchmark argument, for
+ * the same repeatable option, as the parser does: each value goes into the
+ * typed store of the option, with its token kept in the store's text buffer.
+ * The `bytes/value` counter is the memory used by the store per value.
+ */
+void BM_StoreTypedRepeatedOption(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const std::shared_ptr<Option> option =
+      Option::WithKey("tag").Long("tag").WithValue<int>().Repeatable().Build();
+  std::vector<std::string> tokens;
+  tokens.reserve(count);
+  std::size_t bytes = 0;
+  for (std::size_t index = 0; index < count; ++index) {
+    tokens.push_back(std::to_string(index));
+    bytes += tokens.back().size();
+  }
+
+  for (auto _ : state) {
+    OptionValuesMap ovm;
+    for (const auto &token : tokens) {
+      ovm.StoreValue(*option, token);
+    }
+    benchmark::DoNotOptimize(ovm);
+  }
+  ReportThroughput(state, count, bytes);
+  state.counters["bytes/value"] =
+      static_cast<double>(
+          sizeof(detail::TypedValueStore<int>::Entry) * count + bytes) /
+      static_cast<double>(count);
+}
+BENCHMARK(BM_StoreTypedRepeatedOption)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000);
+
+void BM_ValuesOf(benchmark::State &state) {
+  const auto names = MakeOptionNames(static_cast<std::size_t>(state.range(0)));
+  OptionValuesMap ovm;
+  std::size_t bytes = 0;
+  for (const auto &name : names) {
+    ovm.StoreValue(name, OptionValue{42, "42", false});
+    bytes += name.size();
+  }
+
+  for (auto _ : state) {
+    for (const auto &name : names) {
+      benchmark::DoNotOptimize(ovm.ValuesOf(name).front().GetAs<int>());
+    }
+  }
+  ReportThroughput(state, names.size(), bytes);
+}
+BENCHMARK(BM_ValuesOf)->RangeMultiplier(10)->Range(10, 1000);
+
+/*
+ * Read the values of a number of options, given by the benchmark argument,
+ * from the result of a parse, by key and through option handles. The options
+ * are part of a built `Cli`, so their values are in the slots of their ids in
+ * both cases, and the difference is the cost of looking up the key.
+ */
+class ParsedValues {
+public:
+  explicit ParsedValues(std::size_t count) {
+    CommandBuilder command(Command::DEFAULT);
+    for (const auto &name : MakeOptionNames(count)) {
+      auto option = Option::WithKey(name).Long(name).WithValue<int>();
+      handles_.push_back(option.Handle());
+      command.WithOption(option.Build());
+      arguments_.push_back("--" + name + "=42");
+      names_.push_back(name);
+    }
+    cli_ = CliBuilder().ProgramName("bench").WithCommand(command).Build();
+    std::vector<const char *> argv{"bench"};
+    for (const auto &argument : arguments_) {
+      argv.push_back(argument.c_str());
+    }
+    result_ = std::make_unique<ParseResult>(
+        cli_->Parse(static_cast<int>(argv.size()), argv.data()));
+  }
+
+  [[nodiscard]] auto Names() const -> const std::vector<std::string> & {
+    return names_;
+  }
+  [[nodiscard]] auto Handles() const -> const std::vector<OptionHandle<int>> & {
+    return handles_;
+  }
+  [[nodiscard]] auto Values() const -> const OptionValuesMap & {
+    return result_->ovm;
+  }
+
+private:
+  std::vector<std::string> names_;
+  std::vector<std::string> arguments_;
+  std::vector<OptionHandle<int>> handles_;
+  std::unique_ptr<Cli> cli_;
+  std::unique_ptr<ParseResult> result_;
+};
+
+void BM_ParsedValuesByKey(benchmark::State &state) {
+  const ParsedValues parsed(static_cast<std::size_t>(state.range(0)));
+  const auto &ovm = parsed.Values();
+
+  for (auto _ : state) {
+    for (const auto &name : parsed.Names()) {
+      benchmark::DoNotOptimize(ovm.ValuesOf(name).front().GetAs<int>());
+    }
+  }
+  ReportThroughput(state, parsed.Names().size(), 0);
+}
+BENCHMARK(BM_ParsedValuesByKey)->RangeMultiplier(10)->Range(10, 1000);
+
+void BM_ParsedValuesByHandle(benchmark::State &state) {
+  const ParsedValues parsed(static_cast<std::size_t>(state.range(0)));
+  const auto &ovm = parsed.Values();
+
+  for (auto _ : state) {
+    for (const auto &handle : parsed.Handles()) {
+      benchmark::DoNotOptimize(ovm.ValueOf(handle));
+    }
+  }
+  ReportThroughput(state, parsed.Handles().size(), 0);
+}
+BENCHMARK(BM_ParsedValuesByHandle)->RangeMultiplier(10)->Range(10, 1000);
+
+} // namespace
+
+} // namespace asap::clap::bench
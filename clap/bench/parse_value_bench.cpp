@@ -0,0 +1,221 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "clap/detail/parse_list.h"
+#include "clap/detail/parse_value.h"
+#include "clap/flag_set.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace asap::clap::bench {
+
+namespace {
+
+enum class Color { Red, Green, Blue };
+
+enum class Feature { color, unicode, wrap, pager, hyperlinks, emoji };
+
+// A type that can only be constructed from a string, not assigned from it.
+class Name {
+public:
+  explicit Name(std::string value) : value_{std::move(value)} {
+  }
+
+private:
+  std::string value_;
+};
+
+/*
+ * Run `detail::ParseValue` for the `AssignTo` type on each of the inputs, in
+ * turn, and report the throughput in values and bytes.
+ */
+template <typename AssignTo, std::size_t Size>
+void ParseValues(benchmark::State &state,
+    const std::array<std::string_view, Size> &inputs, AssignTo output) {
+  std::size_t bytes = 0;
+  for (const auto &input : inputs) {
+    bytes += input.size();
+  }
+  for (auto _ : state) {
+    for (const auto &input : inputs) {
+      benchmark::DoNotOptimize(detail::ParseValue(input, output));
+      benchmark::DoNotOptimize(output);
+    }
+  }
+  ReportThroughput(state, inputs.size(), bytes);
+}
+
+void BM_ParseValueSigned(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 4>{"0", "-42", "+20", "-9223372036854775807"},
+      std::int64_t{});
+}
+BENCHMARK(BM_ParseValueSigned);
+
+void BM_ParseValueSignedPrefixed(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 4>{
+          "0xdead_beef", "-0o755", "0b1010_1010", "1_000_000"},
+      std::int64_t{});
+}
+BENCHMARK(BM_ParseValueSignedPrefixed);
+
+/*
+ * Tokens that are not numbers, as the parser sees when it tries the
+ * positional arguments following an option with a numeric value.
+ */
+void BM_ParseValueSignedInvalid(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 5>{"input.txt", "--verbose", "12a", "-",
+          "99999999999999999999"},
+      std::int64_t{});
+}
+BENCHMARK(BM_ParseValueSignedInvalid);
+
+void BM_ParseValueUnsigned(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 3>{"0", "42", "18446744073709551615"},
+      std::uint64_t{});
+}
+BENCHMARK(BM_ParseValueUnsigned);
+
+void BM_ParseValueUnsignedInvalid(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 4>{"-1", "output", "0x", "1__000"},
+      std::uint64_t{});
+}
+BENCHMARK(BM_ParseValueUnsignedInvalid);
+
+void BM_ParseValueBool(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 6>{"1", "t", "true", "OFF", "disable", "-5"},
+      bool{});
+}
+BENCHMARK(BM_ParseValueBool);
+
+void BM_ParseValueChar(benchmark::State &state) {
+  ParseValues(state, std::array<std::string_view, 2>{"x", "65"}, char{});
+}
+BENCHMARK(BM_ParseValueChar);
+
+void BM_ParseValueFloat(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 3>{"0.5", "-3.14159", "6.02e23"}, double{});
+}
+BENCHMARK(BM_ParseValueFloat);
+
+void BM_ParseValueFloatInvalid(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 4>{"input.txt", "1.5.2", "--ratio", "1e999"},
+      double{});
+}
+BENCHMARK(BM_ParseValueFloatInvalid);
+
+void BM_ParseValueString(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 2>{
+          "short", "some/rather/long/path/to/a/file/on/the/disk.txt"},
+      std::string{});
+}
+BENCHMARK(BM_ParseValueString);
+
+void BM_ParseValueConstructible(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 2>{
+          "short", "some/rather/long/path/to/a/file/on/the/disk.txt"},
+      Name{""});
+}
+BENCHMARK(BM_ParseValueConstructible);
+
+void BM_ParseValueEnum(benchmark::State &state) {
+  ParseValues(state, std::array<std::string_view, 3>{"red", "BLUE", "1"},
+      Color::Red);
+}
+BENCHMARK(BM_ParseValueEnum);
+
+void BM_ParseValueEnumInvalid(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 3>{"yellow", "input.txt", "7"}, Color::Red);
+}
+BENCHMARK(BM_ParseValueEnumInvalid);
+
+void BM_ParseValueFlagSet(benchmark::State &state) {
+  ParseValues(state,
+      std::array<std::string_view, 2>{
+          "color,Unicode,wrap", "pager,hyperlinks,emoji,color"},
+      FlagSet<Feature>{});
+}
+BENCHMARK(BM_ParseValueFlagSet);
+
+/*
+ * A comma separated list of shard ids, with as many ids as the benchmark
+ * argument.
+ */
+auto ShardIds(std::size_t count) -> std::string {
+  std::string list;
+  for (std::size_t index = 0; index < count; ++index) {
+    list += std::to_string(100000 + index * 7);
+    list += ',';
+  }
+  list.pop_back();
+  return list;
+}
+
+/*
+ * Convert a whole list of shard ids given as a single token, as a list option
+ * does.
+ */
+void BM_ParseList(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const auto input = ShardIds(count);
+  std::vector<std::uint32_t> output;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(detail::ParseList(input, ',', output));
+    benchmark::DoNotOptimize(output.data());
+  }
+  ReportThroughput(state, count, input.size());
+}
+BENCHMARK(BM_ParseList)->RangeMultiplier(10)->Range(10, 500000)->UseRealTime();
+
+/*
+ * The same list, split into strings which are then converted one by one, for
+ * comparison.
+ */
+void BM_ParseListBySplitting(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const auto input = ShardIds(count);
+  for (auto _ : state) {
+    std::vector<std::string> elements;
+    std::string_view rest{input};
+    while (true) {
+      const auto end = rest.find(',');
+      elements.emplace_back(rest.substr(0, end));
+      if (end == std::string_view::npos) {
+        break;
+      }
+      rest.remove_prefix(end + 1);
+    }
+    std::vector<std::uint32_t> output;
+    for (const auto &element : elements) {
+      std::uint32_t value{};
+      benchmark::DoNotOptimize(detail::ParseValue(element, value));
+      output.push_back(value);
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+  ReportThroughput(state, count, input.size());
+}
+BENCHMARK(BM_ParseListBySplitting)->RangeMultiplier(10)->Range(10, 500000);
+
+} // namespace
+
+} // namespace asap::clap::bench
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief A small helper program described both as a compile time schema and
+ * as a `Cli` built at runtime, used to compare the two.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+#include "clap/schema.h"
+
+namespace asap::clap::bench {
+
+/*! \brief The helper program, described at compile time. */
+inline constexpr auto STATIC_PROGRAM = schema::Program(
+    {"bench", "1.0.0", "A short lived helper program."},
+    schema::Command(schema::Option<bool>("verbose")
+                        .Short("V")
+                        .Long("verbose")
+                        .About("Print more information."),
+        schema::Option<bool>("dry-run")
+            .Short("n")
+            .Long("dry-run")
+            .About("Do not change anything."),
+        schema::Option<int>("jobs").Short("j").Long("jobs").About(
+            "Number of parallel jobs."),
+        schema::Option<unsigned>("retries")
+            .Long("retries")
+            .About("Number of retries on failure."),
+        schema::Option<double>("timeout")
+            .Long("timeout")
+            .About("Timeout in seconds."),
+        schema::Option<std::string>("output")
+            .Short("o")
+            .Long("output")
+            .UserFriendlyName("file")
+            .About("Where to write the output."),
+        schema::Option<std::vector<std::string>>("define")
+            .Short("D")
+            .Long("define")
+            .UserFriendlyName("name=value")
+            .About("Define a variable."),
+        schema::Rest<std::vector<std::string>>("inputs").About(
+            "The input files.")));
+
+/*!
+ * \brief The values of the helper program's options, for CLIs that store them
+ * directly into a struct.
+ */
+struct ProgramConfig {
+  bool verbose{false};
+  bool dry_run{false};
+  int jobs{0};
+  unsigned retries{0};
+  double timeout{0};
+  std::string output;
+  std::vector<std::string> defines;
+  std::vector<std::string> inputs;
+};
+
+/*!
+ * \brief The same helper program as `STATIC_PROGRAM`, built at runtime with
+ * the fluent API.
+ *
+ * When `bind` is `true`, all the options are bound to the members of a
+ * `ProgramConfig`, to be used with `Cli::ParseInto()`.
+ */
+inline auto BuildDynamicProgram(bool bind = false) -> std::unique_ptr<Cli> {
+  const auto flag = [](const char *key, const char *short_name,
+                        const char *about) {
+    return Option::WithKey(key)
+        .About(about)
+        .Short(short_name)
+        .Long(key)
+        .WithValue<bool>()
+        .ImplicitValue(true, "true")
+        .Build();
+  };
+  CommandBuilder command(Command::DEFAULT);
+  command.WithOption(flag("verbose", "V", "Print more information."))
+      .WithOption(flag("dry-run", "n", "Do not change anything."))
+      .WithOption(Option::WithKey("jobs")
+                      .About("Number of parallel jobs.")
+                      .Short("j")
+                      .Long("jobs")
+                      .WithValue<int>()
+                      .Build())
+      .WithOption(Option::WithKey("retries")
+                      .About("Number of retries on failure.")
+                      .Long("retries")
+                      .WithValue<unsigned>()
+                      .Build())
+      .WithOption(Option::WithKey("timeout")
+                      .About("Timeout in seconds.")
+                      .Long("timeout")
+                      .WithValue<double>()
+                      .Build())
+      .WithOption(Option::WithKey("output")
+                      .About("Where to write the output.")
+                      .Short("o")
+                      .Long("output")
+                      .WithValue<std::string>()
+                      .UserFriendlyName("file")
+                      .Build())
+      .WithOption(Option::WithKey("define")
+                      .About("Define a variable.")
+                      .Short("D")
+                      .Long("define")
+                      .WithValue<std::string>()
+                      .Repeatable()
+                      .UserFriendlyName("name=value")
+                      .Build())
+      .WithPositionalArguments(Option::Rest()
+                                   .About("The input files.")
+                                   .WithValue<std::string>()
+                                   .Build());
+  std::shared_ptr<Command> built;
+  if (bind) {
+    built = command.BindTo<ProgramConfig>()
+                .Bind("verbose", &ProgramConfig::verbose)
+                .Bind("dry-run", &ProgramConfig::dry_run)
+                .Bind("jobs", &ProgramConfig::jobs)
+                .Bind("retries", &ProgramConfig::retries)
+                .Bind("timeout", &ProgramConfig::timeout)
+                .Bind("output", &ProgramConfig::output)
+                .Bind("define", &ProgramConfig::defines)
+                .Bind(Option::key_rest, &ProgramConfig::inputs)
+                .Build();
+  } else {
+    built = command.Build();
+  }
+  return CliBuilder()
+      .ProgramName("bench")
+      .Version("1.0.0")
+      .About("A short lived helper program.")
+      .WithHelpCommand()
+      .WithVersionCommand()
+      .WithCommand(std::move(built))
+      .Build();
+}
+
+/*! \brief A typical command line for the helper program. */
+inline constexpr std::array<const char *, 14> PROGRAM_COMMAND_LINE{"bench",
+    "-Vn", "--jobs=8", "--retries", "3", "--timeout=2.5", "-o", "out.txt", "-D",
+    "A=1", "--define=B=2", "first.txt", "second.txt", "third.txt"};
+
+} // namespace asap::clap::bench
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "program_fixtures.h"
+
+#include <any>
+#include <array>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace asap::clap::bench {
+
+namespace {
+
+// The command line, as a mutable array of pointers as in `main()`.
+std::array<const char *, PROGRAM_COMMAND_LINE.size()> command_line{
+    PROGRAM_COMMAND_LINE};
+
+auto CommandLineBytes() -> std::size_t {
+  std::size_t bytes = 0;
+  for (const auto *arg : command_line) {
+    bytes += std::strlen(arg);
+  }
+  return bytes;
+}
+
+/*
+ * Parse a command line with a CLI described by a compile time schema.
+ */
+void BM_ParseSchema(benchmark::State &state) {
+  debug::ResetAllocationStats();
+  for (auto _ : state) {
+    const auto values = STATIC_PROGRAM.Parse(
+        static_cast<int>(command_line.size()), command_line.data());
+    benchmark::DoNotOptimize(values);
+  }
+  ReportThroughput(state, command_line.size() - 1, CommandLineBytes());
+  ReportAllocations(state);
+}
+BENCHMARK(BM_ParseSchema);
+
+/*
+ * Parse the same command line with the equivalent CLI built at runtime.
+ */
+void BM_ParseDynamicCli(benchmark::State &state) {
+  const auto cli = BuildDynamicProgram();
+  debug::ResetAllocationStats();
+  for (auto _ : state) {
+    const auto result = cli->Parse(
+        static_cast<int>(command_line.size()), command_line.data());
+    benchmark::DoNotOptimize(result.ovm);
+  }
+  ReportThroughput(state, command_line.size() - 1, CommandLineBytes());
+  ReportAllocations(state);
+}
+BENCHMARK(BM_ParseDynamicCli);
+
+/*
+ * Parse the same command line with the CLI built at runtime and read all the
+ * values back from the option values map, as a program does after parsing.
+ */
+void BM_ParseDynamicCliAndReadValues(benchmark::State &state) {
+  const auto cli = BuildDynamicProgram();
+  debug::ResetAllocationStats();
+  for (auto _ : state) {
+    const auto result = cli->Parse(
+        static_cast<int>(command_line.size()), command_line.data());
+    ProgramConfig config;
+    const auto &ovm = result.ovm;
+    const auto value_of = [&ovm](const char *key, auto &member) {
+      if (ovm.HasOption(key)) {
+        member = std::any_cast<std::remove_reference_t<decltype(member)>>(
+            ovm.ValuesOf(key).front().Value());
+      }
+    };
+    const auto values_of = [&ovm](const char *key, auto &member) {
+      if (ovm.HasOption(key)) {
+        for (const auto &value : ovm.ValuesOf(key)) {
+          member.push_back(std::any_cast<std::string>(value.Value()));
+        }
+      }
+    };
+    value_of("verbose", config.verbose);
+    value_of("dry-run", config.dry_run);
+    value_of("jobs", config.jobs);
+    value_of("retries", config.retries);
+    value_of("timeout", config.timeout);
+    value_of("output", config.output);
+    values_of("define", config.defines);
+    values_of(Option::key_rest, config.inputs);
+    benchmark::DoNotOptimize(config);
+  }
+  ReportThroughput(state, command_line.size() - 1, CommandLineBytes());
+  ReportAllocations(state);
+}
+BENCHMARK(BM_ParseDynamicCliAndReadValues);
+
+/*
+ * Parse the same command line with the options bound to the members of a
+ * struct, which receives the values directly.
+ */
+void BM_ParseDynamicCliIntoStruct(benchmark::State &state) {
+  const auto cli = BuildDynamicProgram(true);
+  debug::ResetAllocationStats();
+  for (auto _ : state) {
+    ProgramConfig config;
+    const auto result = cli->ParseInto(
+        config, static_cast<int>(command_line.size()), command_line.data());
+    benchmark::DoNotOptimize(config);
+    benchmark::DoNotOptimize(result.ovm);
+  }
+  ReportThroughput(state, command_line.size() - 1, CommandLineBytes());
+  ReportAllocations(state);
+}
+BENCHMARK(BM_ParseDynamicCliIntoStruct);
+
+} // namespace
+
+} // namespace asap::clap::bench
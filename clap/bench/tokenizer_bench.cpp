@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "bench_helpers.h"
+#include "parser/line_splitter.h"
+#include "parser/tokenizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace asap::clap::bench {
+
+namespace {
+
+using parser::Tokenizer;
+using parser::TokenType;
+
+constexpr std::size_t ARGUMENTS_COUNT = 1000;
+
+// The shapes of arguments benchmarked, selected by the benchmark argument.
+constexpr std::array<std::string_view, 5> ARGUMENT_SHAPES{
+    "-a", "--long-option-name", "-abcdefgh", "--x=y", "some/path/to/a/file"};
+
+// The second benchmark argument enables the bulk classification of arguments.
+void BM_TokenizerNextToken(benchmark::State &state) {
+  const std::vector<std::string> storage(
+      ARGUMENTS_COUNT, std::string{ARGUMENT_SHAPES.at(state.range(0))});
+  const std::vector<std::string_view> args(storage.cbegin(), storage.cend());
+  const bool upfront = state.range(1) != 0;
+  state.SetLabel(storage.front() + (upfront ? " (bulk)" : ""));
+
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    Tokenizer tokenizer{args};
+    tokenizer.ClassifyUpfront(upfront);
+    tokens = 0;
+    for (auto token = tokenizer.NextToken();
+         token.first != TokenType::EndOfInput; token = tokenizer.NextToken()) {
+      benchmark::DoNotOptimize(token);
+      ++tokens;
+    }
+  }
+  ReportThroughput(state, tokens, ARGUMENTS_COUNT * storage.front().size());
+}
+BENCHMARK(BM_TokenizerNextToken)
+    ->ArgsProduct({benchmark::CreateDenseRange(
+                       0, ARGUMENT_SHAPES.size() - 1, 1),
+        {0, 1}});
+
+void BM_LineSplitter(benchmark::State &state) {
+  std::string line;
+  for (std::size_t index = 0; index < ARGUMENTS_COUNT / 4; ++index) {
+    line.append(state.range(0) == 0 ? "--region eu-west -n 5 "
+                                    : "--region 'eu west' -n \"5\" ");
+  }
+  state.SetLabel(state.range(0) == 0 ? "plain" : "quoted");
+
+  std::size_t arguments = 0;
+  for (auto _ : state) {
+    parser::LineSplitter splitter{line};
+    std::string_view arg;
+    arguments = 0;
+    while (splitter.NextArgument(arg)) {
+      benchmark::DoNotOptimize(arg);
+      ++arguments;
+    }
+  }
+  ReportThroughput(state, arguments, line.size());
+}
+BENCHMARK(BM_LineSplitter)->DenseRange(0, 1);
+
+#if defined(__linux__)
+// Anonymous resident memory of the process, in bytes, which does not include
+// the pages of memory mapped files that have not been modified.
+auto ResidentAnonymousMemory() -> std::size_t {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("RssAnon:", 0) == 0) {
+      return std::stoull(line.substr(8)) * 1024;
+    }
+  }
+  return 0;
+}
+#endif
+
+/*
+ * Tokenize a large response file, releasing tokens as they are consumed the
+ * same way the parser does. The benchmark arguments are the file size in MiB
+ * and whether the arguments in the file are quoted. Pages containing quoted
+ * arguments are unescaped in place, and therefore become anonymous memory.
+ */
+void BM_ResponseFile(benchmark::State &state) {
+  const auto path = (std::filesystem::temp_directory_path() /
+                     "asap_clap_bench_response_file")
+                        .string();
+  const auto size = static_cast<std::size_t>(state.range(0)) * 1024 * 1024;
+  {
+    std::ofstream file(path, std::ios::binary);
+    const std::string chunk = state.range(1) == 0
+                                  ? "--option=value some/plain/path -x "
+                                  : "--option=value \"some quoted/path\" -x ";
+    for (std::size_t written = 0; written < size; written += chunk.size()) {
+      file << chunk;
+    }
+  }
+  const std::string arg = "@" + path;
+
+  std::size_t tokens = 0;
+  std::size_t peak_memory = 0;
+  for (auto _ : state) {
+#if defined(__linux__)
+    const auto memory_before = ResidentAnonymousMemory();
+#endif
+    const Tokenizer tokenizer{{arg}, ResponseFileOptions{}};
+    std::size_t index = 0;
+    for (auto token = tokenizer.TokenAt(index);
+         token.first != TokenType::EndOfInput;
+         token = tokenizer.TokenAt(index)) {
+      benchmark::DoNotOptimize(token);
+      tokenizer.Release(++index);
+#if defined(__linux__)
+      if (index % (1024 * 1024) == 0) {
+        peak_memory = std::max(peak_memory,
+            std::max(ResidentAnonymousMemory(), memory_before) -
+                memory_before);
+      }
+#endif
+    }
+    tokens = index;
+  }
+  std::remove(path.c_str());
+
+  ReportThroughput(state, tokens, size);
+  state.counters["peak_anon_memory"] = benchmark::Counter(
+      static_cast<double>(peak_memory), benchmark::Counter::kDefaults,
+      benchmark::Counter::kIs1024);
+}
+BENCHMARK(BM_ResponseFile)
+    ->Args({64, 0})
+    ->Args({512, 0})
+    ->Args({512, 1})
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+} // namespace asap::clap::bench
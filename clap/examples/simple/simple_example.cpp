@@ -76,10 +76,10 @@ auto main(int argc, const char **argv) -> int {
               .WithHelpCommand()
               .WithCommand(command_builder);
 
-    const auto context = cli->Parse(argc, argv);
-    const auto command_path = context.active_command->PathAsString();
+    const auto result = cli->Parse(argc, argv);
+    const auto command_path = result.active_command->PathAsString();
 
-    const auto &ovm = context.ovm;
+    const auto &ovm = result.ovm;
 
     if (command_path == Command::VERSION || command_path == Command::HELP ||
         ovm.HasOption(Command::HELP)) {
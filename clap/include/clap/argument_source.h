@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Streaming sources of command line arguments.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <utility>
+
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap {
+
+/*!
+ * \brief The character separating arguments in the data produced by an
+ * `ArgumentSource`.
+ */
+enum class ArgumentDelimiter : std::uint8_t {
+  /*! Arguments are terminated by a NUL character, as produced by
+   * `find -print0` and consumed by `xargs -0`. */
+  Nul,
+  /*! Arguments are terminated by a new line character. */
+  Newline,
+};
+
+/*!
+ * \brief A source of command line arguments read incrementally from a file
+ * descriptor, an input stream or a user supplied callback.
+ *
+ * The data produced by the source is split into arguments on the delimiter
+ * character. The last argument does not need to be terminated by a delimiter.
+ * No quoting or escaping is done: arguments are used exactly as they are.
+ *
+ * Arguments from the source are consumed by the parser as they are read, and
+ * are appended after the arguments from the command line. This allows a
+ * single process to ingest a very large number of arguments, such as the
+ * output of `find ... -print0`, without going through `xargs`.
+ *
+ * **Example**
+ *
+ * ```cpp
+ * // my_tool --verbose < <(find . -name '*.txt' -print0)
+ * const auto context = cli.Parse(argc, argv,
+ *     ArgumentSource::FromFileDescriptor(STDIN_FILENO));
+ * ```
+ */
+class ArgumentSource {
+public:
+  /*!
+   * \brief A function that reads at most `size` bytes into `buffer` and
+   * returns the number of bytes read, or 0 when there is no more data.
+   *
+   * The function may block until data is available. Errors are reported by
+   * throwing an exception derived from `std::exception`.
+   */
+  using ReadFunction =
+      std::function<std::size_t(char *buffer, std::size_t size)>;
+
+  /*!
+   * \brief Make a source reading from the given file descriptor, until the end
+   * of file is reached.
+   *
+   * The file descriptor is not closed by the source.
+   */
+  ASAP_CLAP_API static auto FromFileDescriptor(int fd,
+      ArgumentDelimiter delimiter = ArgumentDelimiter::Nul) -> ArgumentSource;
+
+  /*!
+   * \brief Make a source reading from the given input stream, until the end
+   * of the stream is reached.
+   *
+   * The stream must outlive the source and any parsing using it.
+   */
+  ASAP_CLAP_API static auto FromStream(std::istream &input,
+      ArgumentDelimiter delimiter = ArgumentDelimiter::Nul) -> ArgumentSource;
+
+  /*!
+   * \brief Make a source pulling data from the given callback, until it
+   * returns 0.
+   */
+  ASAP_CLAP_API static auto FromCallback(ReadFunction read,
+      ArgumentDelimiter delimiter = ArgumentDelimiter::Nul) -> ArgumentSource;
+
+  /*!
+   * \brief Read at most `size` bytes into `buffer`.
+   *
+   * \return the number of bytes read, or 0 when there is no more data.
+   */
+  auto Read(char *buffer, std::size_t size) const -> std::size_t {
+    return read_(buffer, size);
+  }
+
+  /*! \brief The character separating arguments in the data. */
+  [[nodiscard]] auto Delimiter() const -> ArgumentDelimiter {
+    return delimiter_;
+  }
+
+private:
+  ArgumentSource(ReadFunction read, ArgumentDelimiter delimiter)
+      : read_{std::move(read)}, delimiter_{delimiter} {
+  }
+
+  ReadFunction read_;
+  ArgumentDelimiter delimiter_;
+};
+
+} // namespace asap::clap
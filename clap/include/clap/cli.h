@@ -17,18 +17,28 @@
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
+#include "clap/argument_source.h"
 #include "clap/asap_clap_export.h"
 #include "clap/command.h"
-#include "clap/option_values_map.h"
+#include "clap/parse_result.h"
+#include "clap/response_files.h"
 
 /// Namespace for command line parsing related APIs.
 namespace asap::clap {
 
 struct CommandLineContext;
 
+namespace parser {
+class CommandTrie;
+class NotificationWorkers;
+class Tokenizer;
+} // namespace parser
+
 /*!
  * \brief An exception thrown when a command line arguments parsing error
  * occurs.
@@ -49,6 +59,7 @@ public:
 };
 
 class CliBuilder;
+class ParseSession;
 
 /*!
  * \brief The main entry point of the command line arguments parsing API.
@@ -56,6 +67,11 @@ class CliBuilder;
  * To parse command line arguments, use a CliBuilder to create a `Cli`,
  * configure its different options and add commands to it. Once built, you can
  * call `Parse()` with the program command line arguments.
+ *
+ * A built `Cli` is immutable. Each call to `Parse()` returns a `ParseResult`
+ * owning its own data, and several threads can parse concurrently with the
+ * same `Cli`, unless some of its options store their values with
+ * `StoreTo()`, into locations shared by all the parses.
  */
 class Cli {
 public:
@@ -70,12 +86,12 @@ public:
   }
 
   /*!
-   * \brief The program name.
+   * \brief The program name, if it was set explicitly using the builder's
+   * `CLiBuilder::ProgramName()` method, or an empty string otherwise.
    *
-   * This is either set explicitly using the builder's
-   * `CLiBuilder::ProgramName()` method or deduced from the command line
-   * arguments array. In the latter case, the value is only available after a
-   * call to `Parse()`.
+   * When the program name is not set explicitly, each parse deduces it from
+   * the command line arguments array, and `ParseResult::program_name` holds
+   * the name that was used.
    */
   [[nodiscard]] auto ProgramName() const -> std::string {
     return program_name_.value_or("");
@@ -89,7 +105,86 @@ public:
     return has_help_command_;
   }
 
-  ASAP_CLAP_API auto Parse(int argc, const char **argv) -> CommandLineContext;
+  /*!
+   * \brief Whether long options can be abbreviated to any unambiguous prefix
+   * of their name, as enabled with `CliBuilder::WithAbbreviatedLongOptions()`.
+   */
+  [[nodiscard]] auto AbbreviatedLongOptions() const -> bool {
+    return abbreviated_long_options_;
+  }
+
+  /*!
+   * \brief Whether the arguments are classified in bulk before being
+   * tokenized, as enabled with `CliBuilder::WithBulkArgumentClassification()`.
+   */
+  [[nodiscard]] auto BulkArgumentClassification() const -> bool {
+    return bulk_argument_classification_;
+  }
+
+  /*!
+   * \brief Whether option value callbacks run on a worker thread, as enabled
+   * with `CliBuilder::WithNotificationsOnWorkerThread()`.
+   */
+  [[nodiscard]] auto NotificationsOnWorkerThread() const -> bool {
+    return notification_workers_ != nullptr;
+  }
+
+  /*!
+   * \brief The settings for the expansion of response files (`@file`) on the
+   * command line, if it was enabled with `CliBuilder::WithResponseFiles()`.
+   */
+  [[nodiscard]] auto ResponseFiles() const
+      -> const std::optional<ResponseFileOptions> & {
+    return response_files_;
+  }
+
+  /*!
+   * \brief Parse the program command line arguments.
+   *
+   * \throw CmdLineArgumentsError if the arguments are not valid.
+   */
+  ASAP_CLAP_API auto Parse(int argc, const char **argv) const -> ParseResult;
+
+  /*!
+   * \brief Parse the program command line arguments, followed by the arguments
+   * streamed from `source`.
+   *
+   * Arguments are read from the source as the parsing progresses, which
+   * allows a very large number of arguments (e.g. the output of
+   * `find ... -print0`) to be processed by a single invocation of the program.
+   */
+  ASAP_CLAP_API auto Parse(int argc, const char **argv,
+      ArgumentSource source) const -> ParseResult;
+
+  /*!
+   * \brief Parse the program command line arguments, storing the values of
+   * the options bound with `CommandBuilder::BindTo<Config>()` directly into
+   * `config`.
+   *
+   * Values are converted from their tokens into the members of `config` as
+   * soon as they are accepted by the parser, followed by the default values
+   * of the bound options that are not on the command line. Options which are
+   * not bound, including those of commands bound to another type, are still
+   * available in the option values map of the result.
+   *
+   * \throw CmdLineArgumentsError if the arguments are not valid.
+   */
+  template <typename Config>
+  auto ParseInto(Config &config, int argc, const char **argv) const
+      -> ParseResult {
+    return ParseBound({&typeid(Config), &config}, argc, argv);
+  }
+
+  /*!
+   * \brief Parse a single command line string, such as
+   * `cache evict --region "eu west" -n 5`, split into arguments using POSIX
+   * shell quoting rules.
+   *
+   * The string does not start with the program name. It is split lazily as
+   * parsing progresses, without building an intermediate list of arguments,
+   * and arguments that do not need unescaping are not copied.
+   */
+  ASAP_CLAP_API auto ParseLine(std::string_view line) const -> ParseResult;
 
   /** Produces a human readable output of 'desc', listing options,
       their descriptions and allowed parameters. Other options_description
@@ -105,9 +200,19 @@ public:
   // Cli instances are created and configured only via the associated
   // CliBuilder.
   friend class CliBuilder;
+  // Parse sessions reuse the commands and the parsing settings of the Cli.
+  friend class ParseSession;
+
+  // The trie of commands refers to the list of commands owned by the Cli.
+  Cli(const Cli &) = delete;
+  Cli(Cli &&) = delete;
+  auto operator=(const Cli &) -> Cli & = delete;
+  auto operator=(Cli &&) -> Cli & = delete;
+
+  ~Cli() = default;
 
 private:
-  Cli() = default;
+  Cli();
 
   void Version(std::string version) {
     version_ = std::move(version);
@@ -121,6 +226,32 @@ private:
     program_name_ = std::move(name);
   }
 
+  void ResponseFiles(ResponseFileOptions options) {
+    response_files_ = options;
+  }
+
+  void AbbreviatedLongOptions(bool enable) {
+    abbreviated_long_options_ = enable;
+  }
+
+  void BulkArgumentClassification(bool enable) {
+    bulk_argument_classification_ = enable;
+  }
+
+  void NotificationsOnWorkerThread(bool enable);
+
+  auto PrepareArguments(int argc, const char **argv,
+      std::string &program_name) const -> std::vector<std::string_view>;
+  [[nodiscard]] auto UnifiedCommandName(std::string_view arg) const
+      -> std::string_view;
+  ASAP_CLAP_API auto ParseBound(detail::BoundTarget target, int argc,
+      const char **argv) const -> ParseResult;
+  auto ParseTokens(parser::Tokenizer &tokenizer, std::string program_name,
+      detail::BoundTarget target = {}) const -> ParseResult;
+  void CompleteParse(bool parsed, const CommandLineContext &context) const;
+  void BuildCommandTrie();
+  void AssignOptionIds();
+
   void WithCommand(std::shared_ptr<Command> command) {
     if (command->IsDefault()) {
       commands_.insert(commands_.begin(), std::move(command));
@@ -151,17 +282,33 @@ private:
 
   ASAP_CLAP_API void PrintDefaultCommand(
       std::ostream &out, unsigned int width) const;
+  ASAP_CLAP_API void PrintDefaultCommand(std::ostream &out,
+      const std::string &program_name, unsigned int width) const;
   ASAP_CLAP_API void PrintCommands(std::ostream &out, unsigned int width) const;
 
   std::string version_;
   std::string about_;
   std::optional<std::string> program_name_{};
   std::vector<std::shared_ptr<Command>> commands_;
-  Command::Ptr active_command_;
-  OptionValuesMap ovm_;
+  // Built from `commands_` once all commands have been added to the Cli.
+  std::unique_ptr<parser::CommandTrie, void (*)(const parser::CommandTrie *)>
+      command_trie_;
+  // Built by `AssignOptionIds()`, and shared with the values map of each parse
+  // to find the values of the options by address or by key.
+  std::shared_ptr<const OptionIds> option_ids_;
+  // The worker threads on which the parses run the option value callbacks,
+  // started as needed and reused by the next parses; none unless enabled with
+  // `CliBuilder::WithNotificationsOnWorkerThread()`.
+  std::unique_ptr<parser::NotificationWorkers,
+      void (*)(const parser::NotificationWorkers *)>
+      notification_workers_;
+
+  std::optional<ResponseFileOptions> response_files_{};
 
   bool has_version_command_ = false;
   bool has_help_command_ = false;
+  bool abbreviated_long_options_ = false;
+  bool bulk_argument_classification_ = false;
 };
 
 } // namespace asap::clap
@@ -16,11 +16,17 @@
 #include <algorithm>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "clap/asap_clap_export.h"
+#include "clap/detail/option_index.h"
+#include "clap/detail/value_binding.h"
 #include "clap/option.h"
 
 /// Namespace for command line parsing related APIs.
@@ -29,6 +35,8 @@ namespace asap::clap {
 // Forward reference used to declare the weak pointer to the parent CLI.
 class Cli;
 
+template <typename Config> class CommandBindingBuilder;
+
 /*!
  * \brief A command.
  */
@@ -93,24 +101,50 @@ public:
     return about_;
   }
 
-  [[nodiscard]] auto FindShortOption(const std::string &name) const
-      -> std::optional<std::shared_ptr<Option>> {
-    const auto result = std::find_if(options_.cbegin(), options_.cend(),
-        [&name](const Option::Ptr &option) { return option->Short() == name; });
-    if (result == options_.cend()) {
-      return {};
-    }
-    return std::make_optional(*result);
+  /*!
+   * \brief Find the option of this command with the given short name.
+   *
+   * Options are indexed when they are added to the command, and the lookup
+   * takes constant time whatever the number of options. When several options
+   * have the same name, the first one in `CommandOptions()` is found.
+   *
+   * \return the option, owned by this command, or `nullptr` if the command does
+   * not have an option with that name.
+   */
+  [[nodiscard]] auto FindShortOption(std::string_view name) const
+      -> const Option * {
+    return option_index_.FindShort(name);
   }
 
-  [[nodiscard]] auto FindLongOption(const std::string &name) const
-      -> std::optional<std::shared_ptr<Option>> {
-    const auto result = std::find_if(options_.cbegin(), options_.cend(),
-        [&name](const Option::Ptr &option) { return option->Long() == name; });
-    if (result == options_.cend()) {
-      return {};
-    }
-    return std::make_optional(*result);
+  /*!
+   * \brief Find the option of this command with the given long name.
+   *
+   * \return the option, owned by this command, or `nullptr` if the command does
+   * not have an option with that name.
+   *
+   * \see FindShortOption
+   */
+  [[nodiscard]] auto FindLongOption(std::string_view name) const
+      -> const Option * {
+    return option_index_.FindLong(name);
+  }
+
+  /*!
+   * \brief Find the options of this command which long names start with
+   * `prefix`, to resolve abbreviated long options.
+   *
+   * The lookup is a binary search in the long names of the options, which are
+   * kept sorted as options are added to the command.
+   *
+   * \return the range of matching options, sorted by long name, and only one
+   * option for each long name. The range is empty if `prefix` is empty.
+   *
+   * \see FindLongOption
+   */
+  [[nodiscard]] auto FindLongOptionsByPrefix(std::string_view prefix) const
+      -> std::pair<detail::OptionIndex::ConstIterator,
+          detail::OptionIndex::ConstIterator> {
+    return option_index_.FindLongPrefix(prefix);
   }
 
   /** Produces a human readable output of 'desc', listing options,
@@ -123,8 +157,19 @@ public:
       option_description element. */
   ASAP_CLAP_API void Print(std::ostream &out, unsigned width = 80) const;
 
+  /*!
+   * \brief Print the help of the command, with `program_name` in its
+   * synopsis, as deduced by a parse when the `Cli` does not have an explicit
+   * program name.
+   */
+  ASAP_CLAP_API void Print(std::ostream &out, const std::string &program_name,
+      unsigned width = 80) const;
+
   ASAP_CLAP_API void PrintSynopsis(std::ostream &out) const;
 
+  ASAP_CLAP_API void PrintSynopsis(
+      std::ostream &out, const std::string &program_name) const;
+
   ASAP_CLAP_API void PrintOptions(std::ostream &out, unsigned width) const;
 
   [[nodiscard]] auto CommandOptions() const
@@ -137,8 +182,28 @@ public:
     return positional_args_;
   }
 
+  /*!
+   * \brief Get the binding of `option` to a member of the object in `target`,
+   * if this command was bound to the type of that object.
+   *
+   * \return the binding, owned by this command, or `nullptr` if the values of
+   * the option are not stored directly into `target`.
+   *
+   * \see CommandBuilder::BindTo
+   */
+  [[nodiscard]] auto BindingOf(const Option *option,
+      const detail::BoundTarget &target) const -> const detail::ValueBinding * {
+    if (bindings_.empty() || target.type == nullptr ||
+        *target.type != *bound_type_) {
+      return nullptr;
+    }
+    const auto binding = bindings_.find(option);
+    return binding == bindings_.end() ? nullptr : binding->second.get();
+  }
+
   friend class CommandBuilder;
   friend class CliBuilder; // to upgrade default command with help and version
+  template <typename Config> friend class CommandBindingBuilder;
 
 private:
   /*!
@@ -196,15 +261,19 @@ private:
     for (const auto &option : *options) {
       options_.push_back(option);
       options_in_groups_.push_back(true);
+      option_index_.Add(option.get(), false);
     }
     groups_.emplace_back(std::move(options), hidden);
   }
 
   void WithOption(std::shared_ptr<Option> &&option) {
     if (option->Key() == Command::HELP || option->Key() == Command::VERSION) {
+      // Options at the front take precedence over options with the same name.
+      option_index_.Add(option.get(), true);
       options_.emplace(options_.begin(), option);
       options_in_groups_.insert(options_in_groups_.begin(), false);
     } else {
+      option_index_.Add(option.get(), false);
       options_.emplace_back(option);
       options_in_groups_.push_back(false);
     }
@@ -215,12 +284,39 @@ private:
         positional_args_.end(), {std::forward<Args>(options)...});
   }
 
+  [[nodiscard]] auto FindOptionByKey(std::string_view key) const
+      -> const Option * {
+    for (const auto *options : {&options_, &positional_args_}) {
+      const auto found = std::find_if(options->begin(), options->end(),
+          [key](const Option::Ptr &option) { return option->Key() == key; });
+      if (found != options->end()) {
+        return found->get();
+      }
+    }
+    return nullptr;
+  }
+
+  void Bind(const std::type_info &type, const Option *option,
+      std::unique_ptr<const detail::ValueBinding> binding) {
+    if (bound_type_ != nullptr && *bound_type_ != type) {
+      throw std::domain_error(
+          "a command can only be bound to members of one type");
+    }
+    bound_type_ = &type;
+    bindings_[option] = std::move(binding);
+  }
+
   std::string about_;
   std::vector<std::string> path_;
   std::vector<Option::Ptr> options_;
   std::vector<bool> options_in_groups_;
+  detail::OptionIndex option_index_;
   std::vector<std::pair<Options::Ptr, bool>> groups_;
   std::vector<Option::Ptr> positional_args_;
+  const std::type_info *bound_type_{nullptr};
+  std::unordered_map<const Option *,
+      std::unique_ptr<const detail::ValueBinding>>
+      bindings_;
 
   // Only updated by the CliBuilder, and only used to refer back to the parent
   // CLI to get information for better help display. Use the helper methods
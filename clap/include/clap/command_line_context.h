@@ -15,10 +15,15 @@
 #include <iostream>
 
 #include "clap/command.h"
+#include "clap/detail/value_binding.h"
 #include "clap/option_values_map.h"
 
 namespace asap::clap {
 
+namespace parser {
+class NotificationWorkers;
+} // namespace parser
+
 struct CommandLineContext {
   explicit CommandLineContext(std::string program_name,
       Command::Ptr &active_command_ref, OptionValuesMap &ovm_ref)
@@ -28,6 +33,30 @@ struct CommandLineContext {
 
   bool allow_long_option_value_with_no_equal{true};
 
+  /*!
+   * \brief Accept any unambiguous prefix of a long option name in place of the
+   * full name, as `getopt_long()` does.
+   *
+   * \see CliBuilder::WithAbbreviatedLongOptions()
+   */
+  bool allow_abbreviated_long_options{false};
+
+  /*!
+   * \brief The pool of worker threads of the CLI on which to run the option
+   * value callbacks, while the parser goes on with the command line; none to
+   * run them on the parser's thread.
+   *
+   * \see CliBuilder::WithNotificationsOnWorkerThread()
+   */
+  parser::NotificationWorkers *notification_workers{nullptr};
+
+  /*!
+   * \brief The object into which the values of the options bound with
+   * `CommandBuilder::BindTo()` are stored; none unless the parse was started
+   * with `Cli::ParseInto()`.
+   */
+  detail::BoundTarget bound_target{};
+
   std::istream &in_{std::cin};
   std::ostream &out_{std::cout};
   std::ostream &err_{std::cerr};
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Debug API to count the memory allocations made by each phase of
+ * command line parsing.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap::debug {
+
+/*!
+ * \brief The phases of command line parsing to which allocations are
+ * attributed.
+ *
+ * Phases nest: an allocation is attributed to the innermost phase active on
+ * the calling thread when it happens. For example, values stored in the
+ * `OptionValuesMap` while parsing count towards `ValueStorage` and not towards
+ * `Parsing`.
+ */
+enum class ParsePhase : std::uint8_t {
+  /*! Outside of any parsing phase. */
+  None,
+  /*! Construction of the `Arguments` from `argc` and `argv`. */
+  Arguments,
+  /*! Classification and tokenization of the arguments. */
+  Tokenization,
+  /*! The parser state machine, in `CmdLineParser::Parse`. */
+  Parsing,
+  /*! Binding of the buffered positional arguments, in `FinalState`. */
+  PositionalBinding,
+  /*! Storage of option values in the `OptionValuesMap`. */
+  ValueStorage,
+};
+
+/*! \brief The number of values in the `ParsePhase` enum. */
+constexpr std::size_t PARSE_PHASES_COUNT = 6;
+
+/*!
+ * \brief The number of allocations, and their total size in bytes.
+ */
+struct AllocationCounters {
+  std::size_t allocations{0};
+  std::size_t bytes{0};
+};
+
+/*!
+ * \brief Make `phase` the current phase of the calling thread, and return the
+ * phase that was current before.
+ */
+ASAP_CLAP_API auto EnterPhase(ParsePhase phase) noexcept -> ParsePhase;
+
+/*! \brief The current phase of the calling thread. */
+ASAP_CLAP_API auto CurrentPhase() noexcept -> ParsePhase;
+
+/*!
+ * \brief Attribute an allocation of `bytes` to the current phase of the
+ * calling thread.
+ *
+ * The library marks the phases, but does not intercept allocations by itself.
+ * This is meant to be called from a replacement of the global `operator new`,
+ * such as the one used by the tests and the benchmarks of the library.
+ */
+ASAP_CLAP_API void RecordAllocation(std::size_t bytes) noexcept;
+
+/*!
+ * \brief A snapshot of the allocation counters of each parsing phase.
+ */
+class AllocationStats {
+public:
+  /*! \brief The counters for the given phase. */
+  [[nodiscard]] auto Of(ParsePhase phase) const -> const AllocationCounters & {
+    return counters_[static_cast<std::size_t>(phase)];
+  }
+
+  /*! \brief The sum of the counters of all phases, except `None`. */
+  [[nodiscard]] auto Total() const -> AllocationCounters {
+    AllocationCounters total;
+    for (std::size_t phase = 1; phase < PARSE_PHASES_COUNT; ++phase) {
+      total.allocations += counters_[phase].allocations;
+      total.bytes += counters_[phase].bytes;
+    }
+    return total;
+  }
+
+private:
+  friend void RecordAllocation(std::size_t bytes) noexcept;
+
+  std::array<AllocationCounters, PARSE_PHASES_COUNT> counters_{};
+};
+
+/*! \brief The allocation counters of the calling thread. */
+ASAP_CLAP_API auto GetAllocationStats() noexcept -> AllocationStats;
+
+/*! \brief Reset the allocation counters of the calling thread to zero. */
+ASAP_CLAP_API void ResetAllocationStats() noexcept;
+
+/*!
+ * \brief Make a phase current for the lifetime of this object, then restore
+ * the previous one.
+ */
+class PhaseScope {
+public:
+  explicit PhaseScope(ParsePhase phase) noexcept
+      : previous_{EnterPhase(phase)} {
+  }
+
+  PhaseScope(const PhaseScope &) = delete;
+  PhaseScope(PhaseScope &&) = delete;
+  auto operator=(const PhaseScope &) -> PhaseScope & = delete;
+  auto operator=(PhaseScope &&) -> PhaseScope & = delete;
+
+  ~PhaseScope() {
+    EnterPhase(previous_);
+  }
+
+private:
+  ParsePhase previous_;
+};
+
+} // namespace asap::clap::debug
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "clap/asap_clap_export.h"
@@ -44,6 +45,10 @@ public:
    * passed to the program from the execution environment. If `argv[0]` is not a
    * null pointer (or, equivalently, if `argc > 0`), it points to a string that
    * represents the name used to invoke the program, or to an empty string.
+   *
+   * \note The arguments (excluding the program name) are not copied; they are
+   * kept as views into the strings pointed to by `argv`, which must therefore
+   * outlive this object.
    */
   ASAP_CLAP_API Arguments(int argc, const char **argv);
 
@@ -54,11 +59,13 @@ public:
   [[nodiscard]] ASAP_CLAP_API auto ProgramName() const -> const std::string &;
 
   /*!
-   * \brief The program command line arguments, excluding the program name.
+   * \brief The program command line arguments, excluding the program name, as
+   * views into the original `argv` strings.
    *
    * \see ProgramName
    */
-  [[nodiscard]] ASAP_CLAP_API auto Args() const -> std::vector<std::string> &;
+  [[nodiscard]] ASAP_CLAP_API auto Args() const
+      -> std::vector<std::string_view> &;
 
 private:
   class ArgumentsImpl;
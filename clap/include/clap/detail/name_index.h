@@ -0,0 +1,301 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Perfect hash tables, built at compile time, to find a word in a fixed
+ * set of names, ignoring the case of ASCII letters.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include <magic_enum.hpp>
+
+#include "string_utils.h"
+
+namespace asap::clap::detail {
+
+/*!
+ * \brief Hash of `word` with its ASCII letters in lower case.
+ */
+constexpr auto CaseFoldedHash(std::string_view word) noexcept -> std::uint64_t {
+  // FNV-1a...
+  constexpr std::uint64_t fnv_basis = 14695981039346656037ULL;
+  constexpr std::uint64_t fnv_prime = 1099511628211ULL;
+  std::uint64_t hash = fnv_basis;
+  for (const char character : word) {
+    hash ^= static_cast<std::uint8_t>(FoldCase(character));
+    hash *= fnv_prime;
+  }
+  // ... mixed with the finalizer of MurmurHash3, so that all the bits of the
+  // hash depend on all the characters.
+  constexpr std::uint64_t mix_1 = 0xff51afd7ed558ccdULL;
+  constexpr std::uint64_t mix_2 = 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33U;
+  hash *= mix_1;
+  hash ^= hash >> 33U;
+  hash *= mix_2;
+  hash ^= hash >> 33U;
+  return hash;
+}
+
+/*!
+ * \brief Derive from the high half of `hash` a different, independent, hash
+ * for each value of `seed`.
+ */
+constexpr auto SeededHash(std::uint64_t hash, std::uint32_t seed) noexcept
+    -> std::uint32_t {
+  constexpr std::uint32_t golden_ratio = 0x9e3779b9U;
+  constexpr std::uint32_t mix_1 = 0x85ebca6bU;
+  constexpr std::uint32_t mix_2 = 0xc2b2ae35U;
+  auto seeded =
+      static_cast<std::uint32_t>(hash >> 32U) ^ (seed * golden_ratio);
+  seeded ^= seeded >> 16U;
+  seeded *= mix_1;
+  seeded ^= seeded >> 13U;
+  seeded *= mix_2;
+  seeded ^= seeded >> 16U;
+  return seeded;
+}
+
+/*!
+ * \brief Finds a word in a fixed set of `N` names, ignoring the case of ASCII
+ * letters, without allocating and with a single comparison.
+ *
+ * The table is a perfect hash ("hash and displace"): the names are spread in
+ * buckets by the low bits of their hash, and each bucket is given a seed
+ * which sends the names of the bucket to free slots of the table, through the
+ * seeded hash of the high bits. Looking up a word takes one pass over its
+ * characters and one comparison with the only name it can be.
+ *
+ * The table is meant to be built at compile time, in a `constexpr` variable.
+ * Names that are the same when ignoring case make the build fail.
+ */
+template <std::size_t N> class NameIndex {
+  static_assert(N < std::numeric_limits<std::uint16_t>::max(),
+      "too many names for a name index");
+
+  static constexpr auto PowerOfTwoAtLeast(std::size_t value) -> std::size_t {
+    std::size_t power = 1;
+    while (power < value) {
+      power *= 2;
+    }
+    return power;
+  }
+
+  // The table is at most half full, and buckets have two names on average,
+  // which makes it quick to find a seed for each bucket.
+  static constexpr std::size_t SLOTS = PowerOfTwoAtLeast(2 * N);
+  static constexpr std::size_t BUCKETS = PowerOfTwoAtLeast(N / 2);
+  static constexpr std::uint32_t MAX_SEED = 1U << 16U;
+
+  // The indexes of the names, grouped by bucket.
+  struct Buckets {
+    std::array<std::size_t, N> names{};
+    std::array<std::size_t, BUCKETS + 1> start{};
+  };
+
+public:
+  constexpr explicit NameIndex(const std::array<std::string_view, N> &names)
+      : names_{names} {
+    const auto buckets = SpreadInBuckets();
+    std::size_t largest = 0;
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+      const auto size = buckets.start[bucket + 1] - buckets.start[bucket];
+      largest = size > largest ? size : largest;
+    }
+    // The largest buckets are the hardest to place, and go first.
+    for (auto size = largest; size > 0; --size) {
+      for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        if (buckets.start[bucket + 1] - buckets.start[bucket] == size) {
+          PlaceBucket(bucket, buckets);
+        }
+      }
+    }
+  }
+
+  /*!
+   * \brief The index of the name equal to `word`, ignoring case, if any.
+   */
+  [[nodiscard]] constexpr auto Find(std::string_view word) const noexcept
+      -> std::optional<std::size_t> {
+    const auto hash = CaseFoldedHash(word);
+    const auto bucket = hash & (BUCKETS - 1);
+    const auto slot = SeededHash(hash, seeds_[bucket]) & (SLOTS - 1);
+    const auto entry = slots_[slot];
+    if (entry != 0 && EqualsIgnoringCase(names_[entry - 1U], word)) {
+      return entry - 1U;
+    }
+    return std::nullopt;
+  }
+
+private:
+  [[nodiscard]] constexpr auto SpreadInBuckets() const -> Buckets {
+    std::array<std::size_t, N> bucket_of{};
+    Buckets buckets{};
+    for (std::size_t index = 0; index < N; ++index) {
+      bucket_of[index] = CaseFoldedHash(names_[index]) & (BUCKETS - 1);
+      ++buckets.start[bucket_of[index] + 1];
+    }
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+      buckets.start[bucket + 1] += buckets.start[bucket];
+    }
+    std::array<std::size_t, BUCKETS> filled{};
+    for (std::size_t index = 0; index < N; ++index) {
+      const auto bucket = bucket_of[index];
+      const auto first = buckets.start[bucket];
+      // Equal names end up in the same slot, whatever the seed.
+      for (auto other = first; other < first + filled[bucket]; ++other) {
+        if (EqualsIgnoringCase(names_[buckets.names[other]], names_[index])) {
+          throw std::logic_error("names are not unique when ignoring case");
+        }
+      }
+      buckets.names[first + filled[bucket]++] = index;
+    }
+    return buckets;
+  }
+
+  constexpr void PlaceBucket(std::size_t bucket, const Buckets &buckets) {
+    const auto first = buckets.start[bucket];
+    const auto last = buckets.start[bucket + 1];
+    for (std::uint32_t seed = 1; seed < MAX_SEED; ++seed) {
+      if (Fits(buckets, first, last, seed)) {
+        seeds_[bucket] = seed;
+        for (auto member = first; member < last; ++member) {
+          const auto index = buckets.names[member];
+          slots_[SlotOf(names_[index], seed)] =
+              static_cast<std::uint16_t>(index + 1);
+        }
+        return;
+      }
+    }
+    throw std::logic_error("no perfect hash found for the names");
+  }
+
+  static constexpr auto SlotOf(std::string_view name, std::uint32_t seed)
+      -> std::size_t {
+    return SeededHash(CaseFoldedHash(name), seed) & (SLOTS - 1);
+  }
+
+  // Whether `seed` sends the names from `first` to `last` in `buckets` to
+  // different free slots.
+  [[nodiscard]] constexpr auto Fits(const Buckets &buckets, std::size_t first,
+      std::size_t last, std::uint32_t seed) const -> bool {
+    std::array<std::size_t, N> taken{};
+    for (auto member = first; member < last; ++member) {
+      const auto slot = SlotOf(names_[buckets.names[member]], seed);
+      if (slots_[slot] != 0) {
+        return false;
+      }
+      for (std::size_t other = 0; other < member - first; ++other) {
+        if (taken[other] == slot) {
+          return false;
+        }
+      }
+      taken[member - first] = slot;
+    }
+    return true;
+  }
+
+  std::array<std::string_view, N> names_;
+  std::array<std::uint32_t, BUCKETS> seeds_{};
+  // The index of the name in each slot, plus one, or 0 for a free slot.
+  std::array<std::uint16_t, SLOTS> slots_{};
+};
+
+/*!
+ * \brief Whether the `names` are all different when ignoring case.
+ */
+template <std::size_t N>
+constexpr auto AreUniqueIgnoringCase(
+    const std::array<std::string_view, N> &names) noexcept -> bool {
+  for (std::size_t index = 0; index < N; ++index) {
+    for (std::size_t other = index + 1; other < N; ++other) {
+      if (EqualsIgnoringCase(names[index], names[other])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief `names`, if `CHOOSE_NAMES`, or else `otherwise`.
+ */
+template <bool CHOOSE_NAMES, typename Names, typename Otherwise>
+constexpr auto SelectNames(const Names &names, const Otherwise &otherwise) {
+  if constexpr (CHOOSE_NAMES) {
+    return names;
+  } else {
+    return otherwise;
+  }
+}
+
+/*!
+ * \brief The names of the values of the enum `E`, as given by magic_enum, in
+ * a `NameIndex` built at compile time.
+ *
+ * Names are matched in any case, unless some of them differ only by their
+ * case (e.g. `Red` and `RED`): the names of such an enum must be given
+ * exactly, and are looked up by magic_enum.
+ */
+template <typename E> class EnumNames {
+  static_assert(std::is_enum_v<E>);
+
+public:
+  /*!
+   * \brief The value of `E` named `name`, ignoring case if the names of `E`
+   * allow it, if any.
+   */
+  [[nodiscard]] static constexpr auto Find(std::string_view name) noexcept
+      -> std::optional<E> {
+    if constexpr (IGNORE_CASE) {
+      if (const auto index = index_.Find(name)) {
+        return magic_enum::enum_values<E>()[*index];
+      }
+      return std::nullopt;
+    } else {
+      return magic_enum::enum_cast<E>(name);
+    }
+  }
+
+  /*!
+   * \brief The index, in the values of `E`, of the value named `name`,
+   * ignoring case if the names of `E` allow it, if any.
+   */
+  [[nodiscard]] static constexpr auto IndexOf(std::string_view name) noexcept
+      -> std::optional<std::size_t> {
+    if constexpr (IGNORE_CASE) {
+      return index_.Find(name);
+    } else {
+      if (const auto value = magic_enum::enum_cast<E>(name)) {
+        return magic_enum::enum_index(*value);
+      }
+      return std::nullopt;
+    }
+  }
+
+private:
+  static constexpr auto names_ = magic_enum::enum_names<E>();
+  static constexpr bool IGNORE_CASE = AreUniqueIgnoringCase(names_);
+  // The table cannot be built for names that are equal when ignoring case,
+  // and is left empty when they are matched exactly.
+  static constexpr auto indexed_names_ =
+      SelectNames<IGNORE_CASE>(names_, std::array<std::string_view, 0>{});
+  static constexpr NameIndex<indexed_names_.size()> index_{indexed_names_};
+};
+
+} // namespace asap::clap::detail
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Lookup index of the options of a command by short and long name.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap {
+class Option;
+} // namespace asap::clap
+
+namespace asap::clap::detail {
+
+/*!
+ * \brief Finds the options of a command by their short or long name, in
+ * constant time whatever the number of options.
+ *
+ * Single character short names, which are by far the most common, are looked
+ * up with a direct table indexed by the character. Long names are looked up in
+ * an open addressing hash table, with linear probing, which is kept at most
+ * half full. Long names are also kept sorted, to find all the options which
+ * long names start with a given prefix with a binary search.
+ *
+ * The index stores borrowed pointers to the options, which are owned by the
+ * command, and relies on the names of an option not changing after it has been
+ * added to the index.
+ */
+class OptionIndex {
+public:
+  /*!
+   * \brief Add an option to the index.
+   *
+   * \param option the option to add; it must outlive the index.
+   * \param replace if `true`, the option replaces any option previously added
+   * with the same name; otherwise, the option previously added is kept.
+   */
+  ASAP_CLAP_API void Add(const Option *option, bool replace);
+
+  /*!
+   * \brief The option with the given short name, or `nullptr` if there is
+   * none.
+   */
+  [[nodiscard]] ASAP_CLAP_API auto FindShort(std::string_view name) const
+      -> const Option *;
+
+  /*!
+   * \brief The option with the given long name, or `nullptr` if there is
+   * none.
+   */
+  [[nodiscard]] ASAP_CLAP_API auto FindLong(std::string_view name) const
+      -> const Option *;
+
+  using ConstIterator = std::vector<const Option *>::const_iterator;
+
+  /*!
+   * \brief The options which long names start with `prefix`, sorted by long
+   * name.
+   *
+   * Options with the same long name are only present once, as the option that
+   * `FindLong()` would find.
+   *
+   * \return the range `[first, last)` of the matching options, which is empty
+   * if there is none or if `prefix` is empty.
+   */
+  [[nodiscard]] ASAP_CLAP_API auto FindLongPrefix(std::string_view prefix) const
+      -> std::pair<ConstIterator, ConstIterator>;
+
+private:
+  struct Slot {
+    std::size_t hash;
+    const Option *option;
+  };
+
+  void InsertLong(std::size_t hash, const Option *option, bool replace);
+  void GrowLongNames();
+  void InsertSortedLong(const Option *option, bool replace);
+
+  std::array<const Option *, 256> short_names_{};
+  // Short names which are not exactly one character long; they are not expected
+  // in practice and are simply scanned.
+  std::vector<const Option *> other_short_names_;
+  // The number of slots is always zero or a power of two.
+  std::vector<Slot> long_names_;
+  std::size_t long_names_count_{0};
+  std::vector<const Option *> sorted_long_names_;
+};
+
+} // namespace asap::clap::detail
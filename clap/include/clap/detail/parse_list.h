@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Parser for option values which are lists of values, separated by a
+ * delimiter, in a single token.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "clap/asap_clap_export.h"
+#include "parse_value.h"
+
+namespace asap::clap::detail {
+
+template <typename> struct IsList : std::false_type {};
+template <typename T, typename Allocator>
+struct IsList<std::vector<T, Allocator>> : std::true_type {};
+
+/*!
+ * \brief Lists at least twice this long, in bytes, are converted in parallel,
+ * in chunks of at least this size.
+ */
+constexpr std::size_t PARALLEL_LIST_CHUNK = std::size_t{256} * 1024;
+
+/*!
+ * \brief The number of elements in the list `input`, which is the number of
+ * delimiters plus one.
+ */
+ASAP_CLAP_API auto CountListElements(std::string_view input, char delimiter)
+    -> std::size_t;
+
+/*!
+ * \brief Split the list `input` in at most `max_chunks` lists of about the
+ * same size, cutting it at delimiters.
+ *
+ * The delimiters at which the list is cut are not part of any chunk, and
+ * converting each chunk in turn gives the same elements as converting the
+ * whole list.
+ */
+ASAP_CLAP_API auto SplitList(std::string_view input, char delimiter,
+    std::size_t max_chunks) -> std::vector<std::string_view>;
+
+/*!
+ * \brief The number of chunks in which to split a list of `size` bytes to
+ * convert it in parallel, given the hardware concurrency.
+ */
+ASAP_CLAP_API auto ListChunksFor(std::size_t size) -> std::size_t;
+
+/*!
+ * \brief Call `work` with each index below `count`, from as many threads.
+ *
+ * If the system cannot start that many threads, the calling thread makes the
+ * calls for which no thread was started.
+ *
+ * The first exception thrown by `work`, if any, is rethrown once all the calls
+ * are complete.
+ */
+ASAP_CLAP_API void RunInParallel(
+    std::size_t count, const std::function<void(std::size_t)> &work);
+
+/*!
+ * \brief Convert each element of the list `input` with `ParseValue` and append
+ * it to `output`, stopping at the first element which is not a value.
+ *
+ * `input` has at least one element, which is empty if `input` is.
+ */
+template <typename T>
+auto ParseListElements(std::string_view input, char delimiter,
+    std::vector<T> &output) -> bool {
+  output.reserve(output.size() + CountListElements(input, delimiter));
+  const char *position = input.data();
+  const char *const end = input.data() + input.size();
+  while (true) {
+    // `memchr` is the fastest way to scan for a character, as the standard
+    // libraries implement it with vector instructions.
+    const auto *delimiter_position = static_cast<const char *>(std::memchr(
+        position, delimiter, static_cast<std::size_t>(end - position)));
+    const auto *const element_end =
+        delimiter_position == nullptr ? end : delimiter_position;
+    T value{};
+    if (!ParseValue(std::string_view{position,
+                        static_cast<std::size_t>(element_end - position)},
+            value)) {
+      return false;
+    }
+    output.push_back(std::move(value));
+    if (delimiter_position == nullptr) {
+      return true;
+    }
+    position = delimiter_position + 1;
+  }
+}
+
+/*!
+ * \brief Convert the list `input`, with elements separated by `delimiter`, to
+ * a vector of values.
+ *
+ * An empty `input` is an empty list. Otherwise, each element is converted with
+ * `ParseValue`, and the list is only valid if all of them are; an empty
+ * element is given to `ParseValue` as an empty token.
+ *
+ * The elements are counted first, with a fast scan for the delimiter, so that
+ * the values are converted straight into their final storage. Lists longer
+ * than `PARALLEL_LIST_CHUNK` are split in chunks, which are converted in
+ * parallel, each into its own vector, and then moved into the result.
+ *
+ * \return *true* if all the elements were converted, in which case `output`
+ * holds the values; otherwise *false*, and `output` is not modified.
+ */
+template <typename T>
+auto ParseList(std::string_view input, char delimiter, std::vector<T> &output)
+    -> bool {
+  std::vector<T> values;
+  if (input.empty()) {
+    output = std::move(values);
+    return true;
+  }
+  const auto max_chunks = ListChunksFor(input.size());
+  if (max_chunks == 1) {
+    if (!ParseListElements(input, delimiter, values)) {
+      return false;
+    }
+    output = std::move(values);
+    return true;
+  }
+
+  const auto chunks = SplitList(input, delimiter, max_chunks);
+  std::vector<std::vector<T>> parts(chunks.size());
+  // Not a `std::vector<bool>`, which elements cannot be written concurrently.
+  std::vector<char> converted(chunks.size(), 0);
+  RunInParallel(chunks.size(), [&](std::size_t chunk) {
+    converted[chunk] = static_cast<char>(
+        ParseListElements(chunks[chunk], delimiter, parts[chunk]));
+  });
+  std::size_t count = 0;
+  for (std::size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+    if (converted[chunk] == 0) {
+      return false;
+    }
+    count += parts[chunk].size();
+  }
+  values.reserve(count);
+  for (auto &part : parts) {
+    values.insert(values.end(), std::make_move_iterator(part.begin()),
+        std::make_move_iterator(part.end()));
+  }
+  output = std::move(values);
+  return true;
+}
+
+/*!
+ * \brief Convert the value of an option which value type is a `std::vector`.
+ *
+ * If the option has a `delimiter`, `input` is a list converted with
+ * `ParseList()`. Otherwise, `input` is a single element, and gives a list of
+ * one value.
+ *
+ * \return *true* if `input` was converted, in which case `output` holds the
+ * values; otherwise *false*, and `output` is not modified.
+ */
+template <typename T>
+auto ParseListValue(std::string_view input, std::optional<char> delimiter,
+    std::vector<T> &output) -> bool {
+  if (delimiter) {
+    return ParseList(input, *delimiter, output);
+  }
+  T value{};
+  if (!ParseValue(input, value)) {
+    return false;
+  }
+  output.assign(1, std::move(value));
+  return true;
+}
+
+} // namespace asap::clap::detail
@@ -13,143 +13,383 @@
 
 #pragma once
 
-#include <stdexcept>
+#include <array>
+#include <bitset>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
 
 #include <magic_enum.hpp>
 
-#include "string_utils.h"
+#include "clap/asap_clap_export.h"
+#include "clap/flag_set.h"
+#include "name_index.h"
 
 namespace asap::clap::detail {
 
-template <typename AssignTo,
-    std::enable_if_t<std::is_integral_v<AssignTo> && std::is_signed_v<AssignTo>,
-        std::nullptr_t> = nullptr>
-auto NumberConversion(const std::string &input, AssignTo &output) -> bool {
-  std::size_t consumed{};
-  try {
-    const auto output_ll{std::stoll(input, &consumed)};
-    output = static_cast<AssignTo>(output_ll);
-    return (consumed == input.size() &&
-            static_cast<std::int64_t>(output) == output_ll);
-  } catch (const std::exception &) {
-    return false;
+/*!
+ * \brief Why a token could not be converted to a number.
+ *
+ * The command line parser routinely tries tokens that are not values (e.g. a
+ * positional argument following an option with an implicit value), so a
+ * failed conversion is an expected outcome and is reported with one of these
+ * codes rather than with an exception.
+ */
+enum class NumberParseError {
+  /// The conversion succeeded.
+  None,
+  /// The token is empty.
+  Empty,
+  /// There is no digit after the sign or the base prefix.
+  MissingDigits,
+  /// A character is not a digit in the base of the number.
+  InvalidDigit,
+  /// A `_` separator is not between two digits.
+  MisplacedSeparator,
+  /// The token is a negative number, and the type is unsigned.
+  NegativeUnsigned,
+  /// The number does not fit in the type.
+  OutOfRange,
+};
+
+namespace number {
+
+// The value of characters that are not a digit in any base up to 36.
+constexpr unsigned NOT_A_DIGIT = 36;
+
+// The value of the digit `digit` in bases up to 36, or NOT_A_DIGIT.
+constexpr auto DigitValue(char digit) noexcept -> unsigned {
+  if (digit >= '0' && digit <= '9') {
+    return static_cast<unsigned>(digit - '0');
+  }
+  // Letters only differ from their upper case form by this bit in ASCII.
+  constexpr auto lower_case_bit = 0x20;
+  const auto lower = static_cast<char>(digit | lower_case_bit);
+  if (lower >= 'a' && lower <= 'z') {
+    return static_cast<unsigned>(lower - 'a' + 10);
   }
+  return NOT_A_DIGIT;
 }
 
-template <typename AssignTo, std::enable_if_t<std::is_integral_v<AssignTo> &&
-                                                  std::is_unsigned_v<AssignTo>,
-                                 std::nullptr_t> = nullptr>
-auto UnsignedNumberConversion(const std::string &input, AssignTo &output)
-    -> bool {
-  // Contrarily to the behavior od std::stoull, we do not accept a '-' sign
-  // in the input
-  if (input[0] == '-') {
-    return false;
-  }
-  std::size_t consumed{};
-  try {
-    const auto output_ull{std::stoull(input, &consumed)};
-    output = static_cast<AssignTo>(output_ull);
-    return (consumed == input.size() &&
-            static_cast<std::uint64_t>(output) == output_ull);
-  } catch (const std::exception &) {
-    return false;
+// Remove the sign at the front of `input`, if any, and return true if it is a
+// minus sign.
+constexpr auto TakeSign(std::string_view &input) noexcept -> bool {
+  if (!input.empty() && (input.front() == '-' || input.front() == '+')) {
+    const bool negative = input.front() == '-';
+    input.remove_prefix(1);
+    return negative;
   }
+  return false;
 }
 
-template <typename AssignTo,
-    std::enable_if_t<
-        std::is_integral_v<AssignTo> && std::is_signed_v<AssignTo> &&
-            !std::is_same_v<AssignTo, char> &&
-            !std::is_same_v<AssignTo, bool> && !std::is_enum_v<AssignTo>,
-        std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
-  return NumberConversion(input, output);
+// Remove the base prefix at the front of `input`, if any, and return the base
+// of the number.
+constexpr auto TakeBase(std::string_view &input) noexcept -> unsigned {
+  constexpr unsigned binary = 2;
+  constexpr unsigned octal = 8;
+  constexpr unsigned decimal = 10;
+  constexpr unsigned hexadecimal = 16;
+  if (input.size() < 2 || input[0] != '0') {
+    return decimal;
+  }
+  unsigned base = decimal;
+  switch (input[1]) {
+  case 'x':
+  case 'X':
+    base = hexadecimal;
+    break;
+  case 'o':
+  case 'O':
+    base = octal;
+    break;
+  case 'b':
+  case 'B':
+    base = binary;
+    break;
+  default:
+    return decimal;
+  }
+  input.remove_prefix(2);
+  return base;
 }
 
-template <typename AssignTo,
-    std::enable_if_t<
-        std::is_integral_v<AssignTo> && std::is_unsigned_v<AssignTo> &&
-            !std::is_same_v<AssignTo, char> &&
-            !std::is_same_v<AssignTo, bool> && !std::is_enum_v<AssignTo>,
-        std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
-  return UnsignedNumberConversion(input, output);
+/*!
+ * \brief `std::strtold()` in the "C" locale, whatever the current locale is,
+ * used to convert floating point numbers with standard libraries which do not
+ * have `std::from_chars()` for them.
+ */
+ASAP_CLAP_API auto StringToLongDouble(const char *text, char **end) noexcept
+    -> long double;
+
+/*
+ * Convert the digits in `input`, in base `Base`, to their absolute value,
+ * which does not fit in 64 bits if `overflow` is set.
+ *
+ * Digits can be grouped with `_`, which is only accepted between two digits.
+ * The whole token is always checked, so that a token which is not a number is
+ * reported as such even when its first digits are already too many.
+ */
+template <unsigned Base>
+auto ParseDigits(std::string_view input, std::uint64_t &magnitude,
+    bool &overflow) noexcept -> NumberParseError {
+  if (input.empty()) {
+    return NumberParseError::MissingDigits;
+  }
+  // The largest value that can take one more digit, and the largest digit it
+  // can take then. With the base known at compile time, no division is left in
+  // the loop.
+  constexpr auto max = std::numeric_limits<std::uint64_t>::max();
+  constexpr auto cutoff = max / Base;
+  constexpr auto last_digit_limit = max % Base;
+  std::uint64_t value = 0;
+  bool after_digit = false;
+  overflow = false;
+  for (std::size_t index = 0; index < input.size(); ++index) {
+    const char character = input[index];
+    if (character == '_') {
+      if (!after_digit || index + 1 == input.size()) {
+        return NumberParseError::MisplacedSeparator;
+      }
+      after_digit = false;
+      continue;
+    }
+    const auto digit = DigitValue(character);
+    if (digit >= Base) {
+      return NumberParseError::InvalidDigit;
+    }
+    if (value > cutoff || (value == cutoff && digit > last_digit_limit)) {
+      overflow = true;
+    } else {
+      value = value * Base + digit;
+    }
+    after_digit = true;
+  }
+  magnitude = value;
+  return NumberParseError::None;
+}
+
+inline auto ParseMagnitude(std::string_view input, unsigned base,
+    std::uint64_t &magnitude, bool &overflow) noexcept -> NumberParseError {
+  switch (base) {
+  case 2:
+    return ParseDigits<2>(input, magnitude, overflow);
+  case 8:
+    return ParseDigits<8>(input, magnitude, overflow);
+  case 16:
+    return ParseDigits<16>(input, magnitude, overflow);
+  default:
+    return ParseDigits<10>(input, magnitude, overflow);
+  }
 }
 
-/// Convert a flag into an integer value typically binary flags
-inline auto StringToFlagValue(std::string val) -> std::int64_t {
-  val = ToLower(val);
-  if (val.size() == 1) {
-    if (val[0] >= '1' && val[0] <= '9') {
-      return (static_cast<std::int64_t>(val[0]) - '0');
+} // namespace number
+
+/*!
+ * \brief Convert `input` to an integer of type `AssignTo`, without throwing
+ * and independently of the current locale.
+ *
+ * The number is an optional sign (`+` or `-`), followed by an optional base
+ * prefix, `0x` for hexadecimal, `0o` for octal or `0b` for binary, and by the
+ * digits, which can be grouped with `_` (e.g. `1_000_000` or `0xdead_beef`).
+ * A leading `0` is not an octal prefix, and `010` is ten.
+ *
+ * The sign applies to the value of the digits, whatever the base, so
+ * `0xffff` is out of range for a `std::int16_t`.
+ *
+ * \return NumberParseError::None if the conversion succeeded, in which case
+ * the value is in `output`; otherwise the reason of the failure, and `output`
+ * is not modified.
+ */
+template <typename AssignTo,
+    std::enable_if_t<std::is_integral_v<AssignTo> &&
+                         !std::is_same_v<AssignTo, bool>,
+        std::nullptr_t> = nullptr>
+auto ParseInteger(std::string_view input, AssignTo &output) noexcept
+    -> NumberParseError {
+  if (input.empty()) {
+    return NumberParseError::Empty;
+  }
+  const bool negative = number::TakeSign(input);
+  const auto base = number::TakeBase(input);
+  std::uint64_t magnitude = 0;
+  bool overflow = false;
+  if (const auto error =
+          number::ParseMagnitude(input, base, magnitude, overflow);
+      error != NumberParseError::None) {
+    return error;
+  }
+  if constexpr (std::is_unsigned_v<AssignTo>) {
+    if (negative) {
+      return NumberParseError::NegativeUnsigned;
+    }
+    if (overflow || magnitude > std::numeric_limits<AssignTo>::max()) {
+      return NumberParseError::OutOfRange;
     }
-    switch (val[0]) {
-    case '0':
-    case 'f':
-    case 'n':
-    case '-':
-      return -1;
-    case 't':
-    case 'y':
-    case '+':
-      return 1;
-    default:
-      throw std::invalid_argument("unrecognized character");
+    output = static_cast<AssignTo>(magnitude);
+  } else {
+    // The magnitude of the smallest value is one more than the largest one.
+    const auto max =
+        static_cast<std::uint64_t>(std::numeric_limits<AssignTo>::max());
+    if (overflow || magnitude > max + (negative ? 1 : 0)) {
+      return NumberParseError::OutOfRange;
     }
+    if (negative && magnitude != 0) {
+      output = static_cast<AssignTo>(
+          -static_cast<AssignTo>(magnitude - 1) - AssignTo{1});
+    } else {
+      output = static_cast<AssignTo>(magnitude);
+    }
+  }
+  return NumberParseError::None;
+}
+
+/*!
+ * \brief Convert `input` to a floating point number of type `AssignTo`,
+ * without throwing and independently of the current locale.
+ *
+ * The number is an optional sign (`+` or `-`), followed by a decimal number
+ * with an optional exponent (e.g. `6.02e23`), a hexadecimal number with the
+ * `0x` prefix and an optional binary exponent (e.g. `0x1.8p1`), `inf`,
+ * `infinity` or `nan`.
+ *
+ * The conversion uses `std::from_chars()` when the standard library has it for
+ * floating point numbers, and `StringToLongDouble()` otherwise, which copies
+ * the token to a null terminated string.
+ *
+ * \return NumberParseError::None if the conversion succeeded, in which case
+ * the value is in `output`; otherwise the reason of the failure, and `output`
+ * is not modified.
+ */
+template <typename AssignTo,
+    std::enable_if_t<std::is_floating_point_v<AssignTo>, std::nullptr_t> =
+        nullptr>
+auto ParseFloatingPoint(std::string_view input, AssignTo &output) noexcept
+    -> NumberParseError {
+  if (input.empty()) {
+    return NumberParseError::Empty;
+  }
+  const bool negative = number::TakeSign(input);
+  [[maybe_unused]] const auto digits = input;
+  const bool hexadecimal = input.size() >= 2 && input[0] == '0' &&
+                           (input[1] == 'x' || input[1] == 'X');
+  if (hexadecimal) {
+    input.remove_prefix(2);
+  }
+  if (input.empty()) {
+    return NumberParseError::MissingDigits;
+  }
+  // Only one sign is accepted, and no white space before the number. After
+  // the `0x` prefix, only hexadecimal digits are accepted, and not `inf` or
+  // `nan`.
+  constexpr unsigned hexadecimal_base = 16;
+  const auto first_digit = number::DigitValue(input.front());
+  if (input.front() != '.' &&
+      first_digit >= (hexadecimal ? hexadecimal_base : number::NOT_A_DIGIT)) {
+    return NumberParseError::InvalidDigit;
+  }
+  AssignTo value{};
+#if defined(__cpp_lib_to_chars)
+  const auto *const last = input.data() + input.size();
+  const auto [end, error] = std::from_chars(input.data(), last, value,
+      hexadecimal ? std::chars_format::hex : std::chars_format::general);
+  if (error == std::errc::invalid_argument || end != last) {
+    return NumberParseError::InvalidDigit;
+  }
+  if (error == std::errc::result_out_of_range) {
+    return NumberParseError::OutOfRange;
   }
-  if (val == "true" || val == "on" || val == "yes" || val == "enable") {
-    return 1;
+#else
+  // Without `std::from_chars` for floating point numbers in the standard
+  // library, fall back to `strtold` in the "C" locale, which needs a null
+  // terminated string and understands the `0x` prefix itself.
+  const std::string text{digits};
+  char *end = nullptr;
+  errno = 0;
+  const auto converted = number::StringToLongDouble(text.c_str(), &end);
+  if (end != text.c_str() + text.size()) {
+    return NumberParseError::InvalidDigit;
   }
-  if (val == "false" || val == "off" || val == "no" || val == "disable") {
-    return -1;
+  if (errno == ERANGE ||
+      converted > std::numeric_limits<AssignTo>::max() ||
+      converted < std::numeric_limits<AssignTo>::lowest()) {
+    return NumberParseError::OutOfRange;
   }
-  return std::stoll(val);
+  value = static_cast<AssignTo>(converted);
+#endif
+  output = negative ? -value : value;
+  return NumberParseError::None;
+}
+
+template <typename AssignTo,
+    std::enable_if_t<
+        std::is_integral_v<AssignTo> && !std::is_same_v<AssignTo, char> &&
+            !std::is_same_v<AssignTo, bool> && !std::is_enum_v<AssignTo>,
+        std::nullptr_t> = nullptr>
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
+  return ParseInteger(input, output) == NumberParseError::None;
 }
 
+namespace flag {
+
+// The words accepted as a flag value, the first ones for `true`.
+constexpr std::array<std::string_view, 14> WORDS{"true", "on", "yes",
+    "enable", "t", "y", "+", "false", "off", "no", "disable", "f", "n", "-"};
+constexpr std::size_t TRUE_WORDS = 7;
+
+constexpr NameIndex<WORDS.size()> INDEX{WORDS};
+
+} // namespace flag
+
+/*!
+ * \brief Flags accept a number, which sign gives their value, a single
+ * character (`t`, `y`, `+` or `f`, `n`, `-`) or a word (`true`, `on`, `yes`,
+ * `enable` or `false`, `off`, `no`, `disable`), in any case.
+ */
 template <typename AssignTo,
     std::enable_if_t<std::is_same_v<AssignTo, bool>, std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
-  try {
-    const auto flag_value = StringToFlagValue(input);
-    output = (flag_value > 0);
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
+  std::int64_t number{0};
+  const auto error = ParseInteger(input, number);
+  if (error == NumberParseError::None) {
+    output = (number > 0);
     return true;
-  } catch (const std::invalid_argument &) {
-    return false;
-  } catch (const std::out_of_range &) {
+  }
+  if (error == NumberParseError::OutOfRange) {
     // if the number is out of the range of a 64 bit value then it is still a
     // number, and all we care about is the sign
-    output = (input[0] != '-');
+    output = (input.front() != '-');
     return true;
   }
+  if (const auto word = flag::INDEX.Find(input)) {
+    output = (*word < flag::TRUE_WORDS);
+    return true;
+  }
+  return false;
 }
 
 template <typename AssignTo, std::enable_if_t<std::is_same_v<AssignTo, char> &&
                                                   !std::is_enum_v<AssignTo>,
                                  std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
   if (input.size() == 1) {
-    output = static_cast<AssignTo>(input[0]);
+    output = static_cast<AssignTo>(input.front());
     return true;
   }
-  return NumberConversion(input, output);
+  return ParseInteger(input, output) == NumberParseError::None;
 }
 
-/// Floats (TODO: TEST)
+/// Floats
 template <typename AssignTo,
     std::enable_if_t<std::is_floating_point_v<AssignTo>, std::nullptr_t> =
         nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
-  std::size_t consumed{};
-  try {
-    const auto output_ld{std::stold(input, &consumed)};
-    output = static_cast<AssignTo>(output_ld);
-    return (consumed == input.size());
-  } catch (const std::exception &) {
-    return false;
-  }
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
+  return ParseFloatingPoint(input, output) == NumberParseError::None;
 }
 
 /// String and similar direct assignment
@@ -158,8 +398,8 @@ template <typename AssignTo,
                          !std::is_integral_v<AssignTo> &&
                          std::is_assignable_v<AssignTo &, std::string>,
         std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
-  output = input;
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
+  output = std::string{input};
   return true;
 }
 
@@ -170,21 +410,21 @@ template <typename AssignTo,
                          !std::is_assignable_v<AssignTo &, std::string> &&
                          std::is_constructible_v<AssignTo, std::string>,
         std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
-  output = AssignTo(input);
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
+  output = AssignTo(std::string{input});
   return true;
 }
 
-/// Enumerations
+/// Enumerations, by the name of their values in any case, or by value
 template <typename AssignTo,
     std::enable_if_t<std::is_enum_v<AssignTo>, std::nullptr_t> = nullptr>
-auto ParseValue(const std::string &input, AssignTo &output) -> bool {
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
   // first try to parse for an enum name
-  auto enum_val = magic_enum::enum_cast<AssignTo>(ToLower(input));
+  auto enum_val = EnumNames<AssignTo>::Find(input);
   if (!enum_val.has_value()) {
     // maybe it's an integer value then
     std::underlying_type_t<AssignTo> val;
-    if (!NumberConversion(input, val)) {
+    if (ParseInteger(input, val) != NumberParseError::None) {
       return false;
     }
     enum_val = magic_enum::enum_cast<AssignTo>(val);
@@ -196,4 +436,33 @@ auto ParseValue(const std::string &input, AssignTo &output) -> bool {
   return true;
 }
 
+template <typename> struct IsFlagSet : std::false_type {};
+template <typename E> struct IsFlagSet<FlagSet<E>> : std::true_type {};
+
+/// Sets of enum values, as a comma separated list of value names in any case
+template <typename AssignTo,
+    std::enable_if_t<IsFlagSet<AssignTo>::value, std::nullptr_t> = nullptr>
+auto ParseValue(std::string_view input, AssignTo &output) -> bool {
+  std::bitset<AssignTo::SIZE> flags;
+  while (!input.empty()) {
+    const auto end = input.find(',');
+    const auto name = input.substr(0, end);
+    const auto index = EnumNames<typename AssignTo::EnumType>::IndexOf(name);
+    if (!index.has_value()) {
+      return false;
+    }
+    flags.set(*index);
+    if (end == std::string_view::npos) {
+      break;
+    }
+    input.remove_prefix(end + 1);
+    if (input.empty()) {
+      // a trailing comma
+      return false;
+    }
+  }
+  output = AssignTo{flags};
+  return true;
+}
+
 } // namespace asap::clap::detail
@@ -14,17 +14,39 @@
 #pragma once
 
 #include <algorithm>
-#include <locale>
 #include <string>
+#include <string_view>
 
 namespace asap::clap::detail {
 
-/// Return a lower case version of a string
+/// Return the lower case form of an ASCII letter, and any other character as
+/// it is, independently of the current locale.
+constexpr auto FoldCase(char character) noexcept -> char {
+  // Letters only differ from their upper case form by this bit in ASCII.
+  constexpr auto lower_case_bit = 0x20;
+  return (character >= 'A' && character <= 'Z')
+             ? static_cast<char>(character | lower_case_bit)
+             : character;
+}
+
+/// Compare two strings, ignoring the case of ASCII letters.
+constexpr auto EqualsIgnoringCase(std::string_view lhs,
+    std::string_view rhs) noexcept -> bool {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (std::size_t index = 0; index < lhs.size(); ++index) {
+    if (FoldCase(lhs[index]) != FoldCase(rhs[index])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Return a lower case version of a string, where only ASCII letters are
+/// changed.
 inline auto ToLower(std::string str) -> std::string {
-  std::transform(std::begin(str), std::end(str), std::begin(str),
-      [](const std::string::value_type &element) {
-        return std::tolower(element, std::locale());
-      });
+  std::transform(std::begin(str), std::end(str), std::begin(str), FoldCase);
   return str;
 }
 
@@ -0,0 +1,273 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Bindings of option values to the members of a user provided struct,
+ * used by the parser to store values without going through the option values
+ * map.
+ */
+
+#pragma once
+
+#include <any>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "clap/detail/value_descriptor.h"
+#include "parse_list.h"
+#include "parse_value.h"
+
+namespace asap::clap::detail {
+
+/*!
+ * \brief The object into which a parse stores the values of bound options,
+ * with its type so that it is only used with the bindings made for that type.
+ */
+struct BoundTarget {
+  const std::type_info *type{nullptr};
+  void *object{nullptr};
+};
+
+/*!
+ * \brief Describes how a member of type `Member` receives values of type
+ * `ValueType`.
+ *
+ * A plain member is assigned the value. A `std::optional<T>` member is
+ * assigned the value as well, which lets the program tell apart options that
+ * were not given. A `std::vector<T>` member gets one more element for each
+ * value, which is what repeatable options need.
+ */
+template <typename Member> struct BoundMember {
+  using ValueType = Member;
+  static void Store(Member &member, ValueType &&value) {
+    member = std::move(value);
+  }
+  static auto Values(const Member &member) -> std::vector<std::any> {
+    return {std::any{member}};
+  }
+  static auto Last(const Member &member) -> const ValueType & {
+    return member;
+  }
+};
+
+template <typename T> struct BoundMember<std::optional<T>> {
+  using ValueType = T;
+  static void Store(std::optional<T> &member, ValueType &&value) {
+    member.emplace(std::move(value));
+  }
+  static auto Values(const std::optional<T> &member) -> std::vector<std::any> {
+    if (!member) {
+      return {};
+    }
+    return {std::any{*member}};
+  }
+  static auto Last(const std::optional<T> &member) -> const ValueType & {
+    return *member;
+  }
+};
+
+template <typename T> struct BoundMember<std::vector<T>> {
+  using ValueType = T;
+  static void Store(std::vector<T> &member, ValueType &&value) {
+    member.push_back(std::move(value));
+  }
+  static auto Values(const std::vector<T> &member) -> std::vector<std::any> {
+    return std::vector<std::any>(member.begin(), member.end());
+  }
+  // Returns a copy, as the elements of `std::vector<bool>` are not addressable.
+  static auto Last(const std::vector<T> &member) -> ValueType {
+    return member.back();
+  }
+};
+
+/*!
+ * \brief Describes how a `std::vector<T>` member receives the values of a list
+ * option, which are themselves lists of type `std::vector<T>`.
+ *
+ * The elements of each list are appended to the member. The option's
+ * callbacks are given the member as a whole, with the elements of all the
+ * lists it received so far.
+ */
+template <typename List> struct BoundList {
+  using ValueType = List;
+  static void Store(List &member, ValueType &&value) {
+    if (member.empty()) {
+      member = std::move(value);
+    } else {
+      member.insert(member.end(), std::make_move_iterator(value.begin()),
+          std::make_move_iterator(value.end()));
+    }
+  }
+  static auto Values(const List &member) -> std::vector<std::any> {
+    return {std::any{member}};
+  }
+  static auto Last(const List &member) -> const ValueType & {
+    return member;
+  }
+};
+
+/*!
+ * \brief Stores the values of an option directly into a member of an object,
+ * which type is only known by the code that made the binding.
+ *
+ * The parser calls the binding as soon as it accepts a value for the option.
+ * The value is converted from the token straight into its type, and is never
+ * wrapped into a `std::any` or an `OptionValue`.
+ */
+class ValueBinding {
+public:
+  ValueBinding() = default;
+
+  ValueBinding(const ValueBinding &) = delete;
+  auto operator=(const ValueBinding &) -> ValueBinding & = delete;
+  ValueBinding(ValueBinding &&) = delete;
+  auto operator=(ValueBinding &&) -> ValueBinding & = delete;
+
+  virtual ~ValueBinding() = default;
+
+  /*!
+   * \brief Convert `token` and store the value into the bound member of
+   * `object`.
+   *
+   * \return *false*, leaving the member unchanged, if the token is not a valid
+   * value for the option.
+   */
+  virtual auto Parse(void *object, std::string_view token) const -> bool = 0;
+
+  /*!
+   * \brief Store the option's implicit value into the bound member of `object`.
+   *
+   * \return *false* if the option does not have an implicit value.
+   */
+  virtual auto ApplyImplicit(void *object) const -> bool = 0;
+
+  /*!
+   * \brief Store the option's default value into the bound member of `object`.
+   *
+   * \return *false* if the option does not have a default value.
+   */
+  virtual auto ApplyDefault(void *object) const -> bool = 0;
+
+  /*!
+   * \brief Get a copy of the value last stored into the bound member of
+   * `object`, to notify the option's callbacks about it.
+   */
+  [[nodiscard]] virtual auto LastValue(const void *object) const
+      -> std::any = 0;
+
+  /*!
+   * \brief Get copies of all the values held by the bound member of `object`,
+   * to notify the option's callbacks about them.
+   */
+  [[nodiscard]] virtual auto Values(const void *object) const
+      -> std::vector<std::any> = 0;
+
+  /// The textual form of the implicit value, used for diagnostics.
+  [[nodiscard]] virtual auto ImplicitValueAsText() const
+      -> const std::string & = 0;
+};
+
+/*!
+ * \brief Binding of an option with values of type `Bound::ValueType` to the
+ * member `Member Config::*`, which receives them as described by `Bound`.
+ *
+ * The implicit and default values of the option, and the delimiter of a list
+ * option, are copied from its value descriptor when the binding is made, so
+ * that applying them does not go through `std::any` either.
+ */
+template <typename Config, typename Member,
+    typename Bound = BoundMember<Member>>
+class MemberBinding final : public ValueBinding {
+public:
+  using ValueType = typename Bound::ValueType;
+
+  MemberBinding(
+      Member Config::*member, const ValueDescriptor<ValueType> &descriptor)
+      : member_{member} {
+    if constexpr (IsList<ValueType>::value) {
+      delimiter_ = descriptor.Delimiter();
+    }
+    std::any value;
+    if (descriptor.ApplyImplicit(value, implicit_value_as_text_)) {
+      implicit_value_ = std::any_cast<ValueType>(std::move(value));
+    }
+    std::string value_as_text;
+    if (descriptor.ApplyDefault(value, value_as_text)) {
+      default_value_ = std::any_cast<ValueType>(std::move(value));
+    }
+  }
+
+  auto Parse(void *object, std::string_view token) const -> bool override {
+    ValueType value{};
+    bool converted = false;
+    if constexpr (IsList<ValueType>::value) {
+      converted = ParseListValue(token, delimiter_, value);
+    } else {
+      converted = ParseValue(token, value);
+    }
+    if (!converted) {
+      return false;
+    }
+    Bound::Store(MemberOf(object), std::move(value));
+    return true;
+  }
+
+  auto ApplyImplicit(void *object) const -> bool override {
+    return Apply(implicit_value_, object);
+  }
+
+  auto ApplyDefault(void *object) const -> bool override {
+    return Apply(default_value_, object);
+  }
+
+  [[nodiscard]] auto LastValue(const void *object) const -> std::any override {
+    return Bound::Last(MemberOf(object));
+  }
+
+  [[nodiscard]] auto Values(const void *object) const
+      -> std::vector<std::any> override {
+    return Bound::Values(MemberOf(object));
+  }
+
+  [[nodiscard]] auto ImplicitValueAsText() const
+      -> const std::string & override {
+    return implicit_value_as_text_;
+  }
+
+private:
+  auto MemberOf(void *object) const -> Member & {
+    return static_cast<Config *>(object)->*member_;
+  }
+
+  auto MemberOf(const void *object) const -> const Member & {
+    return static_cast<const Config *>(object)->*member_;
+  }
+
+  auto Apply(const std::optional<ValueType> &value, void *object) const
+      -> bool {
+    if (!value) {
+      return false;
+    }
+    Bound::Store(MemberOf(object), ValueType{*value});
+    return true;
+  }
+
+  Member Config::*member_;
+  std::optional<char> delimiter_;
+  std::optional<ValueType> implicit_value_;
+  std::string implicit_value_as_text_;
+  std::optional<ValueType> default_value_;
+};
+
+} // namespace asap::clap::detail
@@ -17,10 +17,16 @@
 
 #include <any>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 
+#include "parse_list.h"
 #include "parse_value.h"
+#include "value_store.h"
 
 namespace asap::clap {
 
@@ -43,6 +49,10 @@ namespace asap::clap {
  * - via the notifier callback passed to Notifier(). If provided, this callback
  *   function will be called a value for the option is determined.
  *
+ * Both happen once parsing is complete and default values have been applied.
+ * To process values while the command line is still being parsed, use
+ * NotifyOnEachValue() instead.
+ *
  * \note the notifier callback may be called multiple times for the same option
  * if that option is repeatable.
  *
@@ -76,12 +86,17 @@ public:
    *
    * This is one of the multiple ways to collect parsed values.
    *
+   * The value is written by every parse of the `Cli`, on the notifications
+   * worker thread if it has one, and before the parse returns. The same
+   * location is shared by all the parses: a `Cli` with options that store
+   * their values this way must not be used by concurrent parses. Use
+   * `Cli::ParseInto()` with bound members, or the `ParseResult`, instead.
+   *
    * \see Notifier
    */
   void StoreTo(T *store_to) {
     store_to_ = store_to;
   }
-  // TODO(Abdessattar) test case for ValueDescriptor with value_store
 
   /**
    * \copydoc DefaultValue(const T &, const std::string &)
@@ -93,7 +108,7 @@ public:
    * \see ImplicitValue
    */
   void DefaultValue(const T &value) {
-    default_value_ = std::any{value};
+    default_value_ = value;
     std::ostringstream string_converter;
     string_converter << value;
     default_value_as_text_ = string_converter.str();
@@ -112,7 +127,7 @@ public:
    * \see ImplicitValue
    */
   void DefaultValue(const T &value, const std::string &textual) {
-    default_value_ = std::any{value};
+    default_value_ = value;
     default_value_as_text_ = textual;
   }
 
@@ -126,7 +141,7 @@ public:
    * \see Required
    */
   void ImplicitValue(const T &value) {
-    implicit_value_ = std::any(value);
+    implicit_value_ = value;
     std::ostringstream string_converter;
     string_converter << value;
     implicit_value_as_text_ = string_converter.str();
@@ -145,7 +160,7 @@ public:
    * \see Required
    */
   void ImplicitValue(const T &value, const std::string &textual) {
-    implicit_value_ = std::any(value);
+    implicit_value_ = value;
     implicit_value_as_text_ = textual;
   }
 
@@ -161,10 +176,53 @@ public:
    * \brief Specifies a function to be called when the final value
    * is determined.
    *
+   * The callback is called by every parse of the `Cli`, and by concurrent
+   * parses at the same time: it must synchronize its access to any state it
+   * shares with them.
+   *
    * \see Notify
    */
   void Notifier(std::function<void(const T &)> callback) {
-    notifier_ = callback;
+    notifier_ = std::move(callback);
+  }
+
+  /**
+   * \brief Specifies a function to be called with each value of the option,
+   * as soon as it is accepted by the parser.
+   *
+   * Contrarily to the notifier, this function is called while the rest of the
+   * command line is still being parsed, which allows a program to start
+   * working on the first values of a long command line early. Default values
+   * are not passed to it.
+   *
+   * Values of positional arguments are the exception: a positional token may
+   * still turn out to be a command path segment or an option value until all
+   * the options are parsed, so positional arguments only receive their values,
+   * and are notified of them, at the end of the parse, just before the
+   * notifiers.
+   *
+   * \see Notifier
+   */
+  void NotifyOnEachValue(std::function<void(const T &)> callback) {
+    each_value_notifier_ = std::move(callback);
+  }
+
+  /**
+   * \brief Specifies the character separating the values of a list, when `T`
+   * is a `std::vector`.
+   *
+   * \see OptionValueBuilder::Delimiter()
+   */
+  void Delimiter(char delimiter) {
+    delimiter_ = delimiter;
+  }
+
+  /**
+   * \brief The character separating the values of a list, if the value is
+   * split at all.
+   */
+  [[nodiscard]] auto Delimiter() const -> std::optional<char> {
+    return delimiter_;
   }
 
   [[nodiscard]] auto IsRepeatable() const -> bool override {
@@ -188,16 +246,26 @@ public:
     return default_value_.has_value();
   }
 
+  [[nodiscard]] auto MakeValueStore() const
+      -> std::unique_ptr<detail::ValueStore> override {
+    return std::make_unique<detail::TypedValueStore<T>>();
+  }
+
   // TODO(Abdessattar) document currently available value type parsers
-  auto Parse(std::any &value_store, const std::string &token) const
+  auto Parse(detail::ValueStore &store, std::string_view token) const
       -> bool override {
     // TODO(Abdessattar) implement additional value type parsers
     T parsed;
-    if (detail::ParseValue(token, parsed)) {
-      value_store = parsed;
-      return true;
+    bool converted = false;
+    if constexpr (detail::IsList<T>::value) {
+      converted = detail::ParseListValue(token, delimiter_, parsed);
+    } else {
+      converted = detail::ParseValue(token, parsed);
+    }
+    if (converted) {
+      StoreOf(store).Append(std::move(parsed), token, false);
     }
-    return false;
+    return converted;
   }
 
   /**
@@ -212,11 +280,25 @@ public:
     if (!default_value_.has_value()) {
       return false;
     }
-    value_store = default_value_;
+    value_store = *default_value_;
     value_as_text = default_value_as_text_;
     return true;
   }
 
+  /**
+   * \brief If a default value was specified via a previous call to
+   * DefaultValue(), appends that value to `store`, marked as defaulted.
+   *
+   * \return *true* if a default value was applied.
+   */
+  auto ApplyDefault(detail::ValueStore &store) const -> bool override {
+    if (!default_value_.has_value()) {
+      return false;
+    }
+    StoreOf(store).Append(*default_value_, default_value_as_text_, true);
+    return true;
+  }
+
   /**
    * \brief If an implicit value was specified via a previous call to
    * ImplicitValue(), applies that value to the `value_store` and
@@ -229,11 +311,25 @@ public:
     if (!implicit_value_.has_value()) {
       return false;
     }
-    value_store = implicit_value_;
+    value_store = *implicit_value_;
     value_as_text = implicit_value_as_text_;
     return true;
   }
 
+  /**
+   * \brief If an implicit value was specified via a previous call to
+   * ImplicitValue(), appends that value to `store`.
+   *
+   * \return *true* if an implicit value was applied.
+   */
+  auto ApplyImplicit(detail::ValueStore &store) const -> bool override {
+    if (!implicit_value_.has_value()) {
+      return false;
+    }
+    StoreOf(store).Append(*implicit_value_, implicit_value_as_text_, false);
+    return true;
+  }
+
   /**
    * \copybrief ValueSemantics::Notify
    *
@@ -256,21 +352,43 @@ public:
     }
   }
 
+  [[nodiscard]] auto NotifiesFinalValue() const -> bool override {
+    return store_to_ != nullptr || notifier_;
+  }
+
+  [[nodiscard]] auto NotifiesEachValue() const -> bool override {
+    return static_cast<bool>(each_value_notifier_);
+  }
+
+  void NotifyEachValue(const std::any &value_store) const override {
+    if (each_value_notifier_) {
+      each_value_notifier_(*std::any_cast<T>(&value_store));
+    }
+  }
+
   template <typename> friend class OptionValueBuilder;
 
 private:
   explicit ValueDescriptor() = default;
 
+  // Stores given to this descriptor are made by `MakeValueStore()`.
+  static auto StoreOf(detail::ValueStore &store)
+      -> detail::TypedValueStore<T> & {
+    return static_cast<detail::TypedValueStore<T> &>(store);
+  }
+
   std::string user_friendly_name_{"value"};
 
   T *store_to_ = nullptr;
 
-  std::any default_value_;
+  std::optional<T> default_value_;
   std::string default_value_as_text_;
-  std::any implicit_value_;
+  std::optional<T> implicit_value_;
   std::string implicit_value_as_text_;
   bool repeatable_{false};
+  std::optional<char> delimiter_;
   std::function<void(const T &)> notifier_;
+  std::function<void(const T &)> each_value_notifier_;
 };
 
 } // namespace asap::clap
@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Typed storage for the values of one option, used by the option values
+ * map.
+ */
+
+#pragma once
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <contract/contract.h>
+
+#include "clap/debug/allocation_stats.h"
+
+namespace asap::clap::detail {
+
+/*!
+ * \brief Where the original token of a value is kept in the text buffer of its
+ * store.
+ */
+struct TokenSpan {
+  std::uint32_t offset{0};
+  std::uint32_t length{0};
+};
+
+/*!
+ * \brief The values of one option, whatever their type.
+ *
+ * Values are appended, in the order in which they are found, by the typed
+ * store made by the option's value semantics. The original tokens of all the
+ * values are kept one after the other in a single text buffer owned by the
+ * store, and each value only records where its token is in that buffer.
+ *
+ * Clearing a store keeps its memory, so that storing as many values again does
+ * not allocate.
+ */
+class ValueStore {
+public:
+  ValueStore() = default;
+
+  ValueStore(const ValueStore &) = delete;
+  ValueStore(ValueStore &&) = delete;
+  auto operator=(const ValueStore &) -> ValueStore & = delete;
+  auto operator=(ValueStore &&) -> ValueStore & = delete;
+
+  virtual ~ValueStore() = default;
+
+  /// The number of values in the store.
+  [[nodiscard]] virtual auto Size() const -> std::size_t = 0;
+
+  [[nodiscard]] auto Empty() const -> bool {
+    return Size() == 0;
+  }
+
+  /// Remove all the values, keeping the memory used for them.
+  virtual void Clear() = 0;
+
+  /// The type of the values in the store.
+  [[nodiscard]] virtual auto ValueType() const -> const std::type_info & = 0;
+
+  [[nodiscard]] virtual auto IsDefaulted(std::size_t index) const -> bool = 0;
+
+  [[nodiscard]] virtual auto OriginalToken(std::size_t index) const
+      -> std::string_view = 0;
+
+  /// A copy of the value at `index`, for the APIs that work with `std::any`.
+  [[nodiscard]] virtual auto ValueAsAny(std::size_t index) const
+      -> std::any = 0;
+
+  /*!
+   * \brief The value at `index` if the store holds values of any type, as
+   * `std::any`, or `nullptr` if the values have the type of the store.
+   */
+  [[nodiscard]] virtual auto StoredAny(std::size_t /*index*/) const
+      -> const std::any * {
+    return nullptr;
+  }
+
+  /*!
+   * \brief Append a value given as `std::any`.
+   *
+   * \throws std::bad_any_cast if the value does not have the type of the
+   * values in the store.
+   */
+  virtual void AppendAny(
+      const std::any &value, std::string_view token, bool defaulted) = 0;
+
+protected:
+  auto KeepToken(std::string_view token) -> TokenSpan {
+    ASAP_EXPECT(text_.size() + token.size() <=
+                std::numeric_limits<std::uint32_t>::max());
+    const TokenSpan span{static_cast<std::uint32_t>(text_.size()),
+        static_cast<std::uint32_t>(token.size())};
+    text_.append(token);
+    return span;
+  }
+
+  [[nodiscard]] auto TokenAt(TokenSpan span) const -> std::string_view {
+    return std::string_view{text_}.substr(span.offset, span.length);
+  }
+
+  void ClearTokens() {
+    text_.clear();
+  }
+
+private:
+  std::string text_;
+};
+
+/*!
+ * \brief The values of an option of type `T`, stored contiguously.
+ *
+ * Each value is stored inline, next to the span of its original token and the
+ * flag telling if it is a default value, so that a repeatable option with many
+ * values only takes a few bytes more per value than a `std::vector<T>`.
+ *
+ * A `TypedValueStore<std::any>` holds values of any type; it is used for
+ * values that are stored without their option, by key.
+ */
+template <typename T> class TypedValueStore final : public ValueStore {
+public:
+  struct Entry {
+    T value;
+    TokenSpan token;
+    bool defaulted;
+  };
+
+  void Append(T value, std::string_view token, bool defaulted) {
+    const debug::PhaseScope phase{debug::ParsePhase::ValueStorage};
+    entries_.push_back(Entry{std::move(value), KeepToken(token), defaulted});
+  }
+
+  [[nodiscard]] auto Entries() const -> const std::vector<Entry> & {
+    return entries_;
+  }
+
+  [[nodiscard]] auto ValueAt(std::size_t index) const -> const T & {
+    return entries_[index].value;
+  }
+
+  [[nodiscard]] auto Size() const -> std::size_t override {
+    return entries_.size();
+  }
+
+  void Clear() override {
+    entries_.clear();
+    ClearTokens();
+  }
+
+  [[nodiscard]] auto ValueType() const -> const std::type_info & override {
+    return typeid(T);
+  }
+
+  [[nodiscard]] auto IsDefaulted(std::size_t index) const -> bool override {
+    return entries_[index].defaulted;
+  }
+
+  [[nodiscard]] auto OriginalToken(std::size_t index) const
+      -> std::string_view override {
+    return TokenAt(entries_[index].token);
+  }
+
+  [[nodiscard]] auto ValueAsAny(std::size_t index) const -> std::any override {
+    return std::any{entries_[index].value};
+  }
+
+  [[nodiscard]] auto StoredAny(std::size_t index) const
+      -> const std::any * override {
+    if constexpr (std::is_same_v<T, std::any>) {
+      return &entries_[index].value;
+    } else {
+      return nullptr;
+    }
+  }
+
+  void AppendAny(const std::any &value, std::string_view token,
+      bool defaulted) override {
+    if constexpr (std::is_same_v<T, std::any>) {
+      Append(value, token, defaulted);
+    } else {
+      Append(std::any_cast<const T &>(value), token, defaulted);
+    }
+  }
+
+private:
+  std::vector<Entry> entries_;
+};
+
+} // namespace asap::clap::detail
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief FlagSet class, a set of values of an enum, given on the command line
+ * as a comma separated list of names.
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <type_traits>
+
+#include <magic_enum.hpp>
+
+namespace asap::clap {
+
+/*!
+ * \brief A set of values of the enum `E`, stored as a `std::bitset` with one
+ * bit per value.
+ *
+ * Used as the value type of an option, it accepts a comma separated list of
+ * value names, in any case, for example `--features=color,Unicode,wrap`. An
+ * empty value gives an empty set.
+ *
+ * \code
+ * enum class Feature { color, unicode, wrap };
+ *
+ * Option::WithKey("features")
+ *     .Long("features")
+ *     .WithValue<FlagSet<Feature>>()
+ *     .DefaultValue(FlagSet<Feature>{Feature::color})
+ *     .Build();
+ * \endcode
+ */
+template <typename E> class FlagSet {
+  static_assert(std::is_enum_v<E>, "the values of a FlagSet are enum values");
+
+public:
+  using EnumType = E;
+
+  /// The number of values in `E`.
+  static constexpr std::size_t SIZE = magic_enum::enum_count<E>();
+
+  FlagSet() = default;
+
+  /// A set with the values which bits are set in `bits`.
+  explicit FlagSet(const std::bitset<SIZE> &bits) : bits_{bits} {
+  }
+
+  FlagSet(std::initializer_list<E> flags) {
+    for (const auto flag : flags) {
+      Set(flag);
+    }
+  }
+
+  auto Set(E flag, bool value = true) -> FlagSet & {
+    bits_.set(IndexOf(flag), value);
+    return *this;
+  }
+
+  auto Reset(E flag) -> FlagSet & {
+    bits_.reset(IndexOf(flag));
+    return *this;
+  }
+
+  [[nodiscard]] auto Test(E flag) const -> bool {
+    return bits_.test(IndexOf(flag));
+  }
+
+  /// The number of values in the set.
+  [[nodiscard]] auto Count() const -> std::size_t {
+    return bits_.count();
+  }
+
+  [[nodiscard]] auto Any() const -> bool {
+    return bits_.any();
+  }
+
+  [[nodiscard]] auto None() const -> bool {
+    return bits_.none();
+  }
+
+  /// The bits of the set, where bit `i` is the `i`-th value of `E`.
+  [[nodiscard]] auto Bits() const -> const std::bitset<SIZE> & {
+    return bits_;
+  }
+
+  friend auto operator==(const FlagSet &lhs, const FlagSet &rhs) -> bool {
+    return lhs.bits_ == rhs.bits_;
+  }
+
+  friend auto operator!=(const FlagSet &lhs, const FlagSet &rhs) -> bool {
+    return !(lhs == rhs);
+  }
+
+  /// Print the names of the values in the set, separated by commas.
+  friend auto operator<<(std::ostream &out, const FlagSet &flags)
+      -> std::ostream & {
+    const char *separator = "";
+    for (std::size_t index = 0; index < SIZE; ++index) {
+      if (flags.bits_.test(index)) {
+        out << separator << magic_enum::enum_names<E>()[index];
+        separator = ",";
+      }
+    }
+    return out;
+  }
+
+private:
+  static auto IndexOf(E flag) -> std::size_t {
+    // Throws std::bad_optional_access if `flag` is not one of the named
+    // values of `E`.
+    return magic_enum::enum_index(flag).value();
+  }
+
+  std::bitset<SIZE> bits_;
+};
+
+} // namespace asap::clap
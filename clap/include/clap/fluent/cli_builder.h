@@ -82,6 +82,58 @@ public:
    */
   ASAP_CLAP_API auto WithHelpCommand() -> Self &;
 
+  /**
+   * \brief Enable the expansion of response files on the command line.
+   *
+   * With this, any command line argument of the form `@path` naming a readable
+   * file is replaced with the arguments read from that file, split according
+   * to the quoting rules in `options`. Response files can include other
+   * response files, up to the nesting depth limit in `options`.
+   */
+  ASAP_CLAP_API auto WithResponseFiles(ResponseFileOptions options = {})
+      -> Self &;
+
+  /**
+   * \brief Accept abbreviated long options on the command line.
+   *
+   * With this, and as with `getopt_long()`, a long option can be abbreviated
+   * to any prefix of its name which is not the prefix of the name of another
+   * option of the same command, e.g. `--verb` for `--verbose`. A prefix
+   * matching several options is reported as an error listing the candidates.
+   * An exact option name is always preferred to an abbreviation.
+   */
+  ASAP_CLAP_API auto WithAbbreviatedLongOptions() -> Self &;
+
+  /**
+   * \brief Classify the command line arguments in bulk, before tokenizing
+   * them.
+   *
+   * By default, each argument is classified (option, value...) as it is
+   * tokenized. With this, all the arguments are classified in a first pass,
+   * which checks them by batches and skips batches made only of plain values.
+   * This is faster for programs that take very long argument lists, such as
+   * thousands of file paths, but also looks at the arguments that a parse
+   * stopping early would not have needed.
+   */
+  ASAP_CLAP_API auto WithBulkArgumentClassification() -> Self &;
+
+  /**
+   * \brief Run the option value callbacks on a worker thread.
+   *
+   * Callbacks registered with `NotifyOnEachValue()` are then handed over to a
+   * worker thread as values are accepted, and the parser goes on with the rest
+   * of the command line while they run, e.g. to start opening input files
+   * while a very long list of arguments is still being parsed. Callbacks still
+   * run one at a time, in the order of the values on the command line,
+   * followed by the final value notifications. The parse only returns once
+   * they have all run, and rethrows the first exception thrown by one of them.
+   *
+   * The worker threads are owned by the `Cli`: a parse reuses an idle one,
+   * and only starts a new one when the others are busy with concurrent
+   * parses.
+   */
+  ASAP_CLAP_API auto WithNotificationsOnWorkerThread() -> Self &;
+
   /// Explicitly get the encapsulated `Cli` instance.
   ASAP_CLAP_API auto Build() -> std::unique_ptr<Cli>;
 
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Command builder facet to bind option values to struct members.
+ */
+
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+
+#include <contract/contract.h>
+
+#include "clap/detail/value_binding.h"
+#include "clap/fluent/command_builder.h"
+
+namespace asap::clap {
+
+/*!
+ * \brief Builder facet, obtained with `CommandBuilder::BindTo<Config>()`,
+ * which maps the options of the command to the members of `Config`.
+ *
+ * When the command line is parsed with `Cli::ParseInto()` and an object of
+ * type `Config`, the values of the bound options are converted from their
+ * tokens and stored straight into the members of that object, as soon as the
+ * parser accepts them. They do not appear in the option values map of the
+ * parse result, which still holds the values of the options that are not
+ * bound.
+ *
+ * Default and implicit values are stored into the members the same way.
+ * Members of type `std::optional<T>` are only assigned when the option has a
+ * value, and members of type `std::vector<T>` get one element for each value
+ * of a repeatable option, or all the elements of each list of a list option.
+ *
+ * **Example**
+ * \snippet bind_test.cpp Bind options to struct members
+ */
+template <typename Config>
+class CommandBindingBuilder : public CommandBuilder {
+  using Self = CommandBindingBuilder;
+
+public:
+  explicit CommandBindingBuilder(std::unique_ptr<Command> command)
+      : CommandBuilder(std::move(command)) {
+  }
+
+  /*!
+   * \brief Store the values of the option with the given key, which must
+   * already be in the command, into `member`.
+   *
+   * A `std::vector<T>` member can be bound to a repeatable option with values
+   * of type `T`, or to a list option with values of type `std::vector<T>`.
+   *
+   * \throws std::domain_error if the command does not have an option with
+   * that key, or if the option's values are not of the member's type (or of
+   * the element type of a `std::optional` or `std::vector` member).
+   */
+  template <typename Member>
+  auto Bind(std::string_view key, Member Config::*member) -> Self & {
+    ASAP_ASSERT(command_ && "builder used after Build() was called");
+
+    const auto *option = command_->FindOptionByKey(key);
+    if (option == nullptr) {
+      throw std::domain_error(
+          std::string("cannot bind unknown option '").append(key) + "'");
+    }
+    if constexpr (detail::IsList<Member>::value) {
+      // A list option gets whole lists, of the same type as the member.
+      if (const auto *list = DescriptorOf<Member>(*option)) {
+        using Binding =
+            detail::MemberBinding<Config, Member, detail::BoundList<Member>>;
+        command_->Bind(typeid(Config), option,
+            std::make_unique<const Binding>(member, *list));
+        return *this;
+      }
+    }
+    using Binding = detail::MemberBinding<Config, Member>;
+    const auto *descriptor =
+        DescriptorOf<typename Binding::ValueType>(*option);
+    if (descriptor == nullptr) {
+      throw std::domain_error(std::string("cannot bind option '")
+                                  .append(key)
+                                  .append("' to a member of another type"));
+    }
+    command_->Bind(typeid(Config), option,
+        std::make_unique<const Binding>(member, *descriptor));
+    return *this;
+  }
+
+private:
+  template <typename ValueType>
+  static auto DescriptorOf(const Option &option)
+      -> const ValueDescriptor<ValueType> * {
+    return dynamic_cast<const ValueDescriptor<ValueType> *>(
+        option.value_semantic().get());
+  }
+};
+
+template <typename Config>
+auto CommandBuilder::BindTo() -> CommandBindingBuilder<Config> {
+  return CommandBindingBuilder<Config>(std::move(command_));
+}
+
+} // namespace asap::clap
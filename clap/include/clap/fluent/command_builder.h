@@ -21,6 +21,8 @@
 
 namespace asap::clap {
 
+template <typename Config> class CommandBindingBuilder;
+
 /*!
  * \brief Fluent builder to properly create and configure a `Command`.
  *
@@ -58,6 +60,16 @@ public:
     return *this;
   }
 
+  // Builder facets
+
+  /*!
+   * \brief Continue with a builder that can bind the options already added to
+   * this command to the members of a `Config` struct.
+   *
+   * \see CommandBindingBuilder
+   */
+  template <typename Config> auto BindTo() -> CommandBindingBuilder<Config>;
+
   /// Explicitly get the encapsulated `Command` instance.
   auto Build() -> std::unique_ptr<Command> {
     return std::move(command_);
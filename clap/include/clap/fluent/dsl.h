@@ -13,6 +13,7 @@
 #pragma once
 
 #include "cli_builder.h"
+#include "command_binding_builder.h"
 #include "command_builder.h"
 #include "option_builder.h"
 #include "option_value_builder.h"
@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <utility>
 
 #include <contract/contract.h>
 
 #include "clap/detail/value_descriptor.h"
 #include "clap/fluent/option_builder.h"
+#include "clap/option_handle.h"
 
 namespace asap::clap {
 
@@ -75,6 +78,67 @@ public:
     return *this;
   }
 
+  /*!
+   * \brief Split the value of this option, which type is a `std::vector`, at
+   * each `delimiter`.
+   *
+   * An option with a `std::vector<U>` value gets a whole list for each of its
+   * occurrences on the command line, and each list is one value in the option
+   * values map. Without a delimiter, the value is not split, and each
+   * occurrence gives a list of one element, so that values containing commas,
+   * such as file names, are never split by surprise. With a delimiter, the
+   * value is split and its elements are converted in a single pass:
+   *
+   * \code
+   * // --ids=3,1,4 gives the list {3, 1, 4}
+   * Option::WithKey("ids")
+   *     .Long("ids")
+   *     .WithValue<std::vector<std::uint32_t>>()
+   *     .Delimiter(',')
+   *     .Build();
+   * \endcode
+   *
+   * This is not the same as a repeatable option with `U` values, which gets
+   * one value for each occurrence (e.g. `--id=3 --id=1 --id=4`). The
+   * compile-time schema of `schema.h` uses `std::vector<U>` for such
+   * repeatable options, and so does binding to a `std::vector<U>` member when
+   * the option's values are of type `U`. A list option bound to a
+   * `std::vector<U>` member appends the elements of each of its lists to it.
+   */
+  auto Delimiter(char delimiter) -> OptionValueBuilder & {
+    static_assert(detail::IsList<T>::value,
+        "only options with a std::vector value have a delimiter");
+    ASAP_ASSERT(value_descriptor_ && "builder used after Build() was called");
+    value_descriptor_->Delimiter(delimiter);
+    return *this;
+  }
+
+  auto Notifier(std::function<void(const T &)> callback)
+      -> OptionValueBuilder & {
+    ASAP_ASSERT(value_descriptor_ && "builder used after Build() was called");
+    value_descriptor_->Notifier(std::move(callback));
+    return *this;
+  }
+
+  auto NotifyOnEachValue(std::function<void(const T &)> callback)
+      -> OptionValueBuilder & {
+    ASAP_ASSERT(value_descriptor_ && "builder used after Build() was called");
+    value_descriptor_->NotifyOnEachValue(std::move(callback));
+    return *this;
+  }
+
+  /*!
+   * \brief A handle to get the values of this option from an
+   * `OptionValuesMap` without looking it up by its key.
+   *
+   * The handle remains valid after `Build()` has been called, as long as the
+   * option it refers to exists.
+   */
+  [[nodiscard]] auto Handle() const -> OptionHandle<T> {
+    ASAP_ASSERT(option_ && "builder used after Build() was called");
+    return OptionHandle<T>{option_.get()};
+  }
+
 private:
   std::shared_ptr<ValueDescriptor<T>> value_descriptor_;
 };
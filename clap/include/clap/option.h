@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -120,6 +121,17 @@ public:
     return key_;
   }
 
+  /*!
+   * \brief A number unique to this option object in the process.
+   *
+   * Options are numbered in the order they are created, and a copy of an
+   * option gets its own number. This lets the `OptionIds` table of a `Cli`
+   * find the id of an option by indexing, rather than by hashing its address.
+   */
+  [[nodiscard]] auto Serial() const -> std::uint32_t {
+    return serial_.value;
+  }
+
   auto Required() -> void {
     required_ = true;
   }
@@ -155,7 +167,7 @@ public:
 
   /// Semantic of option's value
   [[nodiscard]] auto value_semantic() const
-      -> std::shared_ptr<const ValueSemantics> {
+      -> const std::shared_ptr<const ValueSemantics> & {
     return value_semantic_;
   }
 
@@ -175,6 +187,29 @@ private:
   // copy ctor and destructor.
   std::shared_ptr<const ValueSemantics> value_semantic_;
 
+  // Takes the next number when constructed, including by copy, and keeps its
+  // own number when assigned.
+  struct SerialNumber {
+    SerialNumber() : value{Next()} {
+    }
+    SerialNumber(const SerialNumber & /*other*/) : SerialNumber() {
+    }
+    SerialNumber(SerialNumber && /*other*/) noexcept : SerialNumber() {
+    }
+    auto operator=(const SerialNumber & /*other*/) -> SerialNumber & {
+      return *this;
+    }
+    auto operator=(SerialNumber && /*other*/) noexcept -> SerialNumber & {
+      return *this;
+    }
+    ~SerialNumber() = default;
+
+    static ASAP_CLAP_API auto Next() noexcept -> std::uint32_t;
+
+    std::uint32_t value;
+  };
+  SerialNumber serial_;
+
   explicit Option(std::string key) : key_(std::move(key)) {
   }
 
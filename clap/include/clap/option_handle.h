@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Typed handles to access the values of an option without looking it
+ * up by its key.
+ */
+
+#pragma once
+
+#include <contract/contract.h>
+
+#include "clap/option.h"
+
+namespace asap::clap {
+
+/*!
+ * \brief A handle to an option which values are of type `T`, to get them from
+ * an `OptionValuesMap` without looking up the option by its key and without
+ * checking the type of the values.
+ *
+ * Handles are obtained from the option's builder with
+ * `OptionValueBuilder<T>::Handle()`, which guarantees that the values of the
+ * option are of type `T`. A handle refers to the option, which is owned by the
+ * command it is added to, and must not be used after the `Cli` is destroyed.
+ *
+ * **Example**
+ * \snippet option_values_map_test.cpp Option handle
+ */
+template <typename T> class OptionHandle {
+public:
+  using ValueType = T;
+
+  /// Create a handle that does not refer to any option.
+  OptionHandle() = default;
+
+  /// The option this handle refers to.
+  [[nodiscard]] auto Target() const -> const Option & {
+    ASAP_EXPECT(option_ != nullptr);
+    return *option_;
+  }
+
+  template <typename> friend class OptionValueBuilder;
+
+private:
+  explicit OptionHandle(const Option *option) : option_{option} {
+  }
+
+  const Option *option_{nullptr};
+};
+
+} // namespace asap::clap
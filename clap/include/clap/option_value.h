@@ -13,7 +13,17 @@
 #pragma once
 
 #include <any>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "clap/detail/value_store.h"
 
 /// Namespace for command line parsing related APIs.
 namespace asap::clap {
@@ -23,20 +33,34 @@ namespace asap::clap {
  *
  * This class encapsulates a command line option value of any type, information
  * about its origin and allows type-safe access to it.
+ *
+ * Values found on the command line are stored by the option values map, with
+ * the type of their option, and an `OptionValue` obtained from the map only
+ * refers to one of them. It is cheap to copy, and it and its copies are valid
+ * as long as the map is: they must not outlive the `ParseResult`, or the next
+ * parse of the `ParseSession`, that gave them. To keep a value longer, make an
+ * owning `OptionValue` from `Value()`, `OriginalToken()` and `IsDefaulted()`.
  */
 class OptionValue {
 public:
   /*!
-   * \brief Creates a new OptionValue.
+   * \brief Creates a new OptionValue, which holds its own copy of the value.
    *
    * \param value the value that will be stored.
    * \param original_token the token from which this option value was parsed.
    * \param defaulted when \b true, indicates that the stored value comes from a
    * default value rather than from an explicit value on the command line.
    */
-  OptionValue(std::any value, std::string original_token, bool defaulted)
-      : value_{std::move(value)},
-        original_token_(std::move(original_token)), defaulted_{defaulted} {
+  OptionValue(std::any value, std::string_view original_token, bool defaulted)
+      : owned_{MakeStore(std::move(value), original_token, defaulted)},
+        store_{owned_.get()} {
+  }
+
+  /*!
+   * \brief Refers to the value at `index` in `store`.
+   */
+  OptionValue(const detail::ValueStore &store, std::size_t index)
+      : store_{&store}, index_{index} {
   }
 
   OptionValue(const OptionValue &) = default;
@@ -47,19 +71,19 @@ public:
 
   ~OptionValue() = default;
 
-  /*!
-   * \copydoc GetAs() -> T &
-   */
-  template <typename T> [[nodiscard]] auto GetAs() const -> const T & {
-    return std::any_cast<const T &>(value_);
-  }
-
   /*!
    * \brief If the stored value has type T, returns that value; otherwise throws
    * std::bad_any_cast.
    */
-  template <typename T> [[nodiscard]] auto GetAs() -> T & {
-    return std::any_cast<T &>(value_);
+  template <typename T> [[nodiscard]] auto GetAs() const -> const T & {
+    if (const auto *value = store_->StoredAny(index_)) {
+      return std::any_cast<const T &>(*value);
+    }
+    if (store_->ValueType() != typeid(T)) {
+      throw std::bad_any_cast();
+    }
+    return static_cast<const detail::TypedValueStore<T> &>(*store_).ValueAt(
+        index_);
   }
 
   /*!
@@ -67,34 +91,210 @@ public:
    * explicitly specified on the command line.
    */
   [[nodiscard]] auto IsDefaulted() const -> bool {
-    return defaulted_;
+    return store_->IsDefaulted(index_);
   }
 
   /*!
    * \brief Returns the original token from which this option value was parsed.
    */
-  [[nodiscard]] auto OriginalToken() const -> const std::string & {
-    return original_token_;
+  [[nodiscard]] auto OriginalToken() const -> std::string_view {
+    return store_->OriginalToken(index_);
   }
 
   /*!
-   * \copydoc Value() -> std::any &
+   * \brief Returns a copy of the stored value.
+   *
+   * \see GetAs() to access the value without copying it.
    */
-  [[nodiscard]] auto Value() const -> const std::any & {
-    return value_;
+  [[nodiscard]] auto Value() const -> std::any {
+    return store_->ValueAsAny(index_);
+  }
+
+private:
+  static auto MakeStore(std::any value, std::string_view original_token,
+      bool defaulted) -> std::shared_ptr<const detail::ValueStore> {
+    auto store = std::make_shared<detail::TypedValueStore<std::any>>();
+    store->Append(std::move(value), original_token, defaulted);
+    return store;
+  }
+
+  std::shared_ptr<const detail::ValueStore> owned_;
+  const detail::ValueStore *store_;
+  std::size_t index_{0};
+};
+
+/*!
+ * \brief The values of an option, as stored in the option values map.
+ *
+ * This is a lightweight view on the values, valid as long as the map is, and
+ * which gives each of them as an `OptionValue`.
+ */
+class OptionValues {
+public:
+  class Iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = OptionValue;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = OptionValue;
+
+    Iterator(const detail::ValueStore &store, std::size_t index)
+        : store_{&store}, index_{index} {
+    }
+
+    auto operator*() const -> OptionValue {
+      return OptionValue{*store_, index_};
+    }
+
+    auto operator++() -> Iterator & {
+      ++index_;
+      return *this;
+    }
+
+    auto operator==(const Iterator &other) const -> bool {
+      return store_ == other.store_ && index_ == other.index_;
+    }
+
+    auto operator!=(const Iterator &other) const -> bool {
+      return !(*this == other);
+    }
+
+  private:
+    const detail::ValueStore *store_;
+    std::size_t index_;
+  };
+
+  explicit OptionValues(const detail::ValueStore &store) : store_{&store} {
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return store_->Size();
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    return store_->Empty();
+  }
+
+  [[nodiscard]] auto operator[](std::size_t index) const -> OptionValue {
+    return OptionValue{*store_, index};
   }
 
   /*!
-   * \brief Returns the stored value.
+   * \brief The value at `index`.
+   *
+   * \throws std::out_of_range if there is no value at `index`.
    */
-  [[nodiscard]] auto Value() -> std::any & {
-    return value_;
+  [[nodiscard]] auto at(std::size_t index) const -> OptionValue {
+    if (index >= size()) {
+      throw std::out_of_range("no option value at index " +
+                              std::to_string(index));
+    }
+    return (*this)[index];
+  }
+
+  [[nodiscard]] auto front() const -> OptionValue {
+    return (*this)[0];
+  }
+
+  [[nodiscard]] auto back() const -> OptionValue {
+    return (*this)[size() - 1];
+  }
+
+  [[nodiscard]] auto begin() const -> Iterator {
+    return Iterator{*store_, 0};
+  }
+
+  [[nodiscard]] auto end() const -> Iterator {
+    return Iterator{*store_, size()};
+  }
+
+private:
+  const detail::ValueStore *store_;
+};
+
+/*!
+ * \brief The values of an option which values are of type `T`, accessed
+ * without going through `OptionValue`.
+ *
+ * The values are stored contiguously, and iterating over them gives
+ * references to the values themselves. Like `OptionValues`, this is a view
+ * valid as long as the option values map is.
+ */
+template <typename T> class TypedOptionValues {
+  using Entries = std::vector<typename detail::TypedValueStore<T>::Entry>;
+
+public:
+  class Iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    explicit Iterator(typename Entries::const_iterator entry) : entry_{entry} {
+    }
+
+    auto operator*() const -> const T & {
+      return entry_->value;
+    }
+
+    auto operator->() const -> const T * {
+      return &entry_->value;
+    }
+
+    auto operator++() -> Iterator & {
+      ++entry_;
+      return *this;
+    }
+
+    auto operator==(const Iterator &other) const -> bool {
+      return entry_ == other.entry_;
+    }
+
+    auto operator!=(const Iterator &other) const -> bool {
+      return entry_ != other.entry_;
+    }
+
+  private:
+    typename Entries::const_iterator entry_;
+  };
+
+  explicit TypedOptionValues(const detail::TypedValueStore<T> &store)
+      : entries_{&store.Entries()} {
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    return entries_->size();
+  }
+
+  [[nodiscard]] auto empty() const -> bool {
+    return entries_->empty();
+  }
+
+  [[nodiscard]] auto operator[](std::size_t index) const -> const T & {
+    return (*entries_)[index].value;
+  }
+
+  [[nodiscard]] auto front() const -> const T & {
+    return entries_->front().value;
+  }
+
+  [[nodiscard]] auto back() const -> const T & {
+    return entries_->back().value;
+  }
+
+  [[nodiscard]] auto begin() const -> Iterator {
+    return Iterator{entries_->cbegin()};
+  }
+
+  [[nodiscard]] auto end() const -> Iterator {
+    return Iterator{entries_->cend()};
   }
 
 private:
-  std::any value_;
-  std::string original_token_;
-  bool defaulted_{false};
+  const Entries *entries_;
 };
 
 } // namespace asap::clap
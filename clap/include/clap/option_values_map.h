@@ -13,18 +13,125 @@
 
 #pragma once
 
+#include <algorithm>
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <typeinfo>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "clap/debug/allocation_stats.h"
+#include "clap/detail/value_store.h"
+#include "clap/option.h"
+#include "clap/option_handle.h"
 #include "clap/option_value.h"
 
 namespace asap::clap {
 
+/*!
+ * \brief The dense ids of the options of a command line interface, which
+ * address their values in an `OptionValuesMap`.
+ *
+ * The ids are given by the `Cli` when it is built, and are kept in this table
+ * rather than in the options, so that the same option can be part of several
+ * `Cli`s, each one with its own ids. Options in different commands can have
+ * the same key (e.g. `help`), and each one has its own id.
+ *
+ * The table is indexed by the serial numbers of the options, which are close
+ * to each other when the options of a `Cli` are built together, so that the
+ * id of an option is found with an array access on the parsing path.
+ */
+class OptionIds {
+public:
+  /// The id of an option which is not in the table.
+  static constexpr std::size_t NO_ID = static_cast<std::size_t>(-1);
+
+  /*!
+   * \brief Give the next id to `option`, unless it already has one.
+   *
+   * \return the id of `option`.
+   */
+  auto Add(const Option &option) -> std::size_t {
+    const auto serial = option.Serial();
+    if (count_ == 0) {
+      first_serial_ = serial;
+    } else if (serial < first_serial_) {
+      ids_.insert(ids_.begin(), first_serial_ - serial, NO_ID);
+      first_serial_ = serial;
+    }
+    const std::size_t index = serial - first_serial_;
+    if (index >= ids_.size()) {
+      ids_.resize(index + 1, NO_ID);
+    }
+    auto &id = ids_[index];
+    if (id == NO_ID) {
+      id = count_++;
+      by_key_[option.Key()].push_back(id);
+    }
+    return id;
+  }
+
+  /// The id of `option`, or `NO_ID` if it is not in the table.
+  [[nodiscard]] auto IdOf(const Option &option) const -> std::size_t {
+    // Serials before the first one wrap around, past the end of the table.
+    const std::size_t index = option.Serial() - first_serial_;
+    return index < ids_.size() ? ids_[index] : NO_ID;
+  }
+
+  /// The ids of the options with the key `key`, or `nullptr` if there is none.
+  [[nodiscard]] auto IdsOf(const std::string &key) const
+      -> const std::vector<std::size_t> * {
+    const auto found = by_key_.find(key);
+    return found == by_key_.cend() ? nullptr : &found->second;
+  }
+
+  /// The number of options in the table, which is also the next id.
+  [[nodiscard]] auto Count() const -> std::size_t {
+    return count_;
+  }
+
+private:
+  // The id of each option, or `NO_ID`, by serial number from `first_serial_`.
+  std::vector<std::size_t> ids_;
+  std::uint32_t first_serial_{0};
+  std::size_t count_{0};
+  std::unordered_map<std::string, std::vector<std::size_t>> by_key_;
+};
+
+/*!
+ * \brief The values of the options found on the command line.
+ *
+ * The options of a `Cli` are given dense ids when it is built, and their
+ * values are stored in flat slots indexed by these ids. The parser, and the
+ * program through an `OptionHandle`, find the slot of an option through the
+ * `OptionIds` table of the `Cli`, by serial number, without hashing.
+ * Looking up values by option key is still supported, through the same
+ * table.
+ *
+ * Each slot is a store made by the option's value semantics, which keeps the
+ * values with their type, contiguously, and their original tokens in a single
+ * text buffer. Values of options that do not have an id (because they are not
+ * part of the `Cli` this map was made for) or that are stored by key are kept
+ * in stores by option key.
+ */
 class OptionValuesMap {
 public:
   OptionValuesMap() = default;
 
+  /*!
+   * \brief Create an empty values map for the options which ids are in
+   * `option_ids`.
+   */
+  explicit OptionValuesMap(std::shared_ptr<const OptionIds> option_ids)
+      : option_ids_{std::move(option_ids)} {
+  }
+
   OptionValuesMap(const OptionValuesMap &) = delete;
   OptionValuesMap(OptionValuesMap &&) = default;
 
@@ -33,35 +140,223 @@ public:
 
   ~OptionValuesMap() = default;
 
-  void StoreValue(const std::string &option_name, OptionValue new_value) {
-    const auto in_ovm = ovm_.find(option_name);
-    if (in_ovm != ovm_.end()) {
-      auto &option_values = in_ovm->second;
-      option_values.emplace_back(std::move(new_value));
-      return;
+  /*!
+   * \brief Parse `token` as a value of `option` and store it.
+   *
+   * \return *true* if the value was stored, and *false* if `token` is not a
+   * value for `option`.
+   */
+  auto StoreValue(const Option &option, std::string_view token) -> bool {
+    return option.value_semantic()->Parse(StoreOf(option), token);
+  }
+
+  /*!
+   * \brief Store the implicit value of `option`, if it has one.
+   *
+   * \return *true* if the value was stored.
+   */
+  auto StoreImplicitValue(const Option &option) -> bool {
+    return option.value_semantic()->ApplyImplicit(StoreOf(option));
+  }
+
+  /*!
+   * \brief Store the default value of `option`, if it has one.
+   *
+   * \return *true* if the value was stored.
+   */
+  auto StoreDefaultValue(const Option &option) -> bool {
+    return option.value_semantic()->ApplyDefault(StoreOf(option));
+  }
+
+  /*!
+   * \brief Store a value given with its original token, for the option with
+   * the key `option_name`.
+   *
+   * \throws std::bad_any_cast if values of another type were already stored
+   * for the option.
+   */
+  void StoreValue(const std::string &option_name, const OptionValue &value) {
+    auto &store = by_key_[option_name];
+    if (!store) {
+      const debug::PhaseScope phase{debug::ParsePhase::ValueStorage};
+      store = std::make_unique<detail::TypedValueStore<std::any>>();
     }
-    ovm_.emplace(option_name, std::vector<OptionValue>{std::move(new_value)});
+    store->AppendAny(value.Value(), value.OriginalToken(), value.IsDefaulted());
   }
 
+  /*!
+   * \brief The table of the ids of the options, or `nullptr` if this map was
+   * not made for the options of a `Cli`.
+   */
+  [[nodiscard]] auto Ids() const -> const OptionIds * {
+    return option_ids_.get();
+  }
+
+  /*!
+   * \brief Remove all the stored values.
+   *
+   * The stores of the options seen so far, and the memory of their values,
+   * are kept so that storing values for the same options again, as happens
+   * when the same command line interface parses many command lines, does not
+   * allocate.
+   */
+  void Clear() {
+    for (auto &store : slots_) {
+      if (store) {
+        store->Clear();
+      }
+    }
+    for (auto &entry : by_key_) {
+      entry.second->Clear();
+    }
+  }
+
+  /*!
+   * \brief The values of `option`.
+   *
+   * \throws std::out_of_range if the option does not have a value.
+   */
+  [[nodiscard]] auto ValuesOf(const Option &option) const -> OptionValues {
+    const auto *store = FindStore(option);
+    if (store == nullptr || store->Empty()) {
+      throw std::out_of_range("no value for option '" + option.Key() + "'");
+    }
+    return OptionValues{*store};
+  }
+
+  [[nodiscard]] auto HasOption(const Option &option) const -> bool {
+    return OccurrencesOf(option) != 0;
+  }
+
+  [[nodiscard]] auto OccurrencesOf(const Option &option) const -> size_t {
+    const auto *store = FindStore(option);
+    return store == nullptr ? 0 : store->Size();
+  }
+
+  /*!
+   * \brief Get the first value of the option referred to by `handle`.
+   *
+   * \throws std::out_of_range if the option does not have a value.
+   */
+  template <typename T>
+  [[nodiscard]] auto ValueOf(const OptionHandle<T> &handle) const -> const T & {
+    return ValuesOf(handle.Target()).front().template GetAs<T>();
+  }
+
+  /*!
+   * \brief Get the values of the option referred to by `handle`, stored
+   * contiguously with their type.
+   *
+   * \throws std::out_of_range if the option does not have a value.
+   */
+  template <typename T>
+  [[nodiscard]] auto ValuesOf(const OptionHandle<T> &handle) const
+      -> TypedOptionValues<T> {
+    const auto *store = FindStore(handle.Target());
+    if (store == nullptr || store->Empty()) {
+      throw std::out_of_range(
+          "no value for option '" + handle.Target().Key() + "'");
+    }
+    if (store->ValueType() != typeid(T)) {
+      throw std::bad_any_cast();
+    }
+    return TypedOptionValues<T>{
+        static_cast<const detail::TypedValueStore<T> &>(*store)};
+  }
+
+  template <typename T>
+  [[nodiscard]] auto HasOption(const OptionHandle<T> &handle) const -> bool {
+    return HasOption(handle.Target());
+  }
+
+  /*!
+   * \brief The values of the option with the key `option_name`.
+   *
+   * \throws std::out_of_range if the option does not have a value.
+   */
   [[nodiscard]] auto ValuesOf(const std::string &option_name) const
-      -> const std::vector<OptionValue> & {
-    return ovm_.at(option_name);
+      -> OptionValues {
+    const auto *store = FindStore(option_name);
+    if (store == nullptr || store->Empty()) {
+      throw std::out_of_range("no value for option '" + option_name + "'");
+    }
+    return OptionValues{*store};
   }
 
   [[nodiscard]] auto HasOption(const std::string &option_name) const -> bool {
-    return ovm_.find(option_name) != ovm_.cend();
+    return OccurrencesOf(option_name) != 0;
   }
 
   [[nodiscard]] auto OccurrencesOf(const std::string &option_name) const
       -> size_t {
-    if (const auto option = ovm_.find(option_name); option != ovm_.cend()) {
-      return option->second.size();
-    }
-    return 0;
+    const auto *store = FindStore(option_name);
+    return store == nullptr ? 0 : store->Size();
   }
 
 private:
-  std::unordered_map<std::string, std::vector<OptionValue>> ovm_;
+  // The store for the values of `option`, made the first time the option
+  // gets a value.
+  auto StoreOf(const Option &option) -> detail::ValueStore & {
+    const debug::PhaseScope phase{debug::ParsePhase::ValueStorage};
+    std::unique_ptr<detail::ValueStore> *store = nullptr;
+    const auto id = IdOf(option);
+    if (id == OptionIds::NO_ID) {
+      store = &by_key_[option.Key()];
+    } else {
+      if (id >= slots_.size()) {
+        slots_.resize(option_ids_->Count());
+      }
+      store = &slots_[id];
+    }
+    if (!*store) {
+      *store = option.value_semantic()->MakeValueStore();
+    }
+    return **store;
+  }
+
+  [[nodiscard]] auto FindStore(const Option &option) const
+      -> const detail::ValueStore * {
+    const auto id = IdOf(option);
+    if (id == OptionIds::NO_ID) {
+      return FindStoreByKey(option.Key());
+    }
+    return FindStore(id);
+  }
+
+  [[nodiscard]] auto IdOf(const Option &option) const -> std::size_t {
+    return option_ids_ ? option_ids_->IdOf(option) : OptionIds::NO_ID;
+  }
+
+  [[nodiscard]] auto FindStore(std::size_t id) const
+      -> const detail::ValueStore * {
+    return id < slots_.size() ? slots_[id].get() : nullptr;
+  }
+
+  // The store with values of the options with the given key. Only one of the
+  // options with the same key, all in different commands, has values.
+  [[nodiscard]] auto FindStore(const std::string &option_name) const
+      -> const detail::ValueStore * {
+    const auto *ids = option_ids_ ? option_ids_->IdsOf(option_name) : nullptr;
+    if (ids != nullptr) {
+      for (const auto id : *ids) {
+        const auto *store = FindStore(id);
+        if (store != nullptr && !store->Empty()) {
+          return store;
+        }
+      }
+    }
+    return FindStoreByKey(option_name);
+  }
+
+  [[nodiscard]] auto FindStoreByKey(const std::string &option_name) const
+      -> const detail::ValueStore * {
+    const auto store = by_key_.find(option_name);
+    return store == by_key_.cend() ? nullptr : store->second.get();
+  }
+
+  std::shared_ptr<const OptionIds> option_ids_;
+  std::vector<std::unique_ptr<detail::ValueStore>> slots_;
+  std::unordered_map<std::string, std::unique_ptr<detail::ValueStore>> by_key_;
 };
 
 } // namespace asap::clap
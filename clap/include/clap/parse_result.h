@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief The result of parsing a command line with a `Cli`.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "clap/command.h"
+#include "clap/option_values_map.h"
+
+namespace asap::clap {
+
+/*!
+ * \brief The outcome of a successful parse of a command line: the command
+ * that was identified and the values of its options.
+ *
+ * A result owns all its data. It does not refer to the `Cli` that produced it
+ * (other than through the shared `active_command`, which is never modified),
+ * nor to the command line arguments, and is not affected by later parses.
+ */
+struct ParseResult {
+  /*!
+   * \brief The program name, as set on the `Cli` or, if it does not have one,
+   * as provided in the first element of `argv`.
+   */
+  std::string program_name;
+
+  /*! \brief The command identified on the command line. */
+  Command::Ptr active_command;
+
+  /*! \brief The values of the options, by option id or by option key. */
+  OptionValuesMap ovm;
+};
+
+/*!
+ * \brief The outcome of a successful parse by a `ParseSession`, with the same
+ * members as a `ParseResult`, but referring to data owned by the session.
+ *
+ * A view is only valid until the next parse of the session that produced it,
+ * or the destruction of the session.
+ */
+struct ParseResultView {
+  /*! \brief The program name, as in `ParseResult::program_name`. */
+  const std::string &program_name;
+
+  /*! \brief The command identified on the command line. */
+  const Command::Ptr &active_command;
+
+  /*! \brief The values of the options, by option id or by option key. */
+  const OptionValuesMap &ovm;
+};
+
+} // namespace asap::clap
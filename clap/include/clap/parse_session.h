@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief A reusable session for parsing many command lines with the same
+ * `Cli`.
+ */
+
+#pragma once
+
+#include <memory>
+#include <typeinfo>
+
+#include "clap/asap_clap_export.h"
+#include "clap/cli.h"
+#include "clap/detail/value_binding.h"
+#include "clap/parse_result.h"
+
+namespace asap::clap {
+
+/*!
+ * \brief Parses command lines with a `Cli`, reusing the same parsing machinery
+ * for all of them.
+ *
+ * `Cli::Parse()` creates the arguments list, the tokenizer, the parser and its
+ * state machine for each command line, and throws them away at the end. A
+ * `ParseSession` creates them once and only resets them between two parses,
+ * keeping the memory of their buffers, of the positional arguments list and of
+ * the option values map. This makes it suitable for long lived processes that
+ * parse a high number of command lines, such as a server receiving commands.
+ *
+ * A session is not thread safe: use one session per thread. The `Cli` is only
+ * used to look at its commands and settings, and must outlive the session.
+ *
+ * **Example**
+ *
+ * ```cpp
+ * ParseSession session(*cli);
+ * for (const auto &request : requests) {
+ *   const auto result = session.Parse(request.argc, request.argv);
+ *   Dispatch(*result.active_command, result.ovm);
+ * }
+ * ```
+ */
+class ParseSession {
+public:
+  /*!
+   * \brief Create a parse session for the given `Cli`.
+   *
+   * If the `Cli` does not have an explicit program name, it is taken from the
+   * first arguments array parsed by the session.
+   */
+  ASAP_CLAP_API explicit ParseSession(const Cli &cli);
+
+  /*!
+   * \brief Parse the given command line arguments, in the same way as
+   * `Cli::Parse()`.
+   *
+   * \return a view of the program name, the active command and the option
+   * values, which remains valid until the next parse or the destruction of
+   * the session. The arguments are not copied, and must remain valid as long
+   * as the result is used.
+   *
+   * \throw CmdLineArgumentsError if the arguments are not valid.
+   */
+  ASAP_CLAP_API auto Parse(int argc, const char **argv) -> ParseResultView;
+
+  /*!
+   * \brief Parse the given command line arguments, in the same way as
+   * `Cli::ParseInto()`, storing the values of the options bound with
+   * `CommandBuilder::BindTo<Config>()` into `config`.
+   *
+   * \return a view of the parse result, as for `Parse()`.
+   *
+   * \throw CmdLineArgumentsError if the arguments are not valid.
+   */
+  template <typename Config>
+  auto ParseInto(Config &config, int argc, const char **argv)
+      -> ParseResultView {
+    return ParseBound({&typeid(Config), &config}, argc, argv);
+  }
+
+private:
+  ASAP_CLAP_API auto ParseBound(
+      detail::BoundTarget target, int argc, const char **argv)
+      -> ParseResultView;
+
+  class ParseSessionImpl;
+
+  const Cli &cli_;
+
+  // Stores the implementation and the implementation's deleter as well to work
+  // around the fact that the implementation class is an incomplete type so far.
+  // https://oliora.github.io/2015/12/29/pimpl-and-rule-of-zero.html
+  std::unique_ptr<ParseSessionImpl, void (*)(const ParseSessionImpl *)> impl_;
+};
+
+} // namespace asap::clap
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Settings for the expansion of response files (`@file`) on the
+ * command line.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace asap::clap {
+
+/*!
+ * \brief The quoting rules used to split the contents of a response file into
+ * command line arguments.
+ */
+enum class ResponseFileSyntax : std::uint8_t {
+  /*!
+   * GCC rules: arguments are separated by white space, which can be made part
+   * of an argument by enclosing it in single or double quotes. A backslash
+   * escapes any character, inside or outside quotes.
+   */
+  Gnu,
+  /*!
+   * MSVC rules: arguments are separated by white space, which can be made part
+   * of an argument by enclosing it in double quotes. Backslashes are literal,
+   * unless they precede a double quote: `2n` backslashes followed by a quote
+   * produce `n` backslashes and toggle the quoted mode, `2n + 1` backslashes
+   * followed by a quote produce `n` backslashes and a literal quote. Inside a
+   * quoted argument, two consecutive double quotes produce a literal quote.
+   */
+  Windows,
+};
+
+/*!
+ * \brief Settings for the expansion of response files.
+ *
+ * When response files are enabled, any command line argument of the form
+ * `@path` is replaced with the arguments read from the file at `path`. The
+ * contents of a response file can themselves contain `@path` arguments, which
+ * are expanded recursively up to `max_depth` levels of nesting.
+ *
+ * As with GCC, if the file cannot be opened, the argument is used literally.
+ */
+struct ResponseFileOptions {
+  /*! \brief The quoting rules used to split the file contents. */
+#if defined(_WIN32)
+  ResponseFileSyntax syntax{ResponseFileSyntax::Windows};
+#else
+  ResponseFileSyntax syntax{ResponseFileSyntax::Gnu};
+#endif
+  /*! \brief The maximum nesting level of response files. */
+  std::size_t max_depth{10};
+};
+
+} // namespace asap::clap
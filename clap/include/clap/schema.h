@@ -0,0 +1,536 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief A command line schema described at compile time, for which a
+ * specialized and statically typed parser is generated.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "clap/asap_clap_export.h"
+#include "clap/detail/parse_value.h"
+
+namespace asap::clap::schema {
+
+/*!
+ * \brief The description of a program, as shown by its help and version
+ * information.
+ *
+ * If `name` is empty, the program name is taken from `argv[0]`.
+ */
+struct ProgramInfo {
+  std::string_view name;
+  std::string_view version;
+  std::string_view about;
+};
+
+namespace detail {
+
+template <typename T> struct IsVector : std::false_type {};
+template <typename T, typename Allocator>
+struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+/*! \brief The index of an option in a schema, or `NO_OPTION`. */
+using OptionId = std::uint16_t;
+constexpr OptionId NO_OPTION = 0xffff;
+
+/*! \brief What the generic parsing loop needs to know about an option. */
+struct OptionEntry {
+  std::string_view key;
+  std::string_view short_name;
+  std::string_view long_name;
+  std::string_view about;
+  std::string_view user_friendly_name;
+  bool is_flag;
+  bool repeatable;
+  bool positional;
+};
+
+/*!
+ * \brief A view over the lookup tables of a schema, which are all computed at
+ * compile time.
+ */
+struct CommandTable {
+  const OptionEntry *entries;
+  std::size_t size;
+  // 256 entries, indexed by the single character short name.
+  const OptionId *short_names;
+  // The ids of the options with a long name, sorted by long name.
+  const OptionId *sorted_long_names;
+  std::size_t long_names_count;
+  OptionId positional;
+};
+
+/*!
+ * \brief Parse the token of option `id` and store its value in `values`.
+ *
+ * \return `false` if the token could not be parsed to the option's type.
+ */
+using StoreValueFn = auto (*)(void *values, std::size_t id,
+    std::string_view token) -> bool;
+
+/*!
+ * \brief The parsing loop shared by all schemas, driven by their tables.
+ *
+ * Tokens are produced by the same tokenizer as for a dynamic `Cli`, and errors
+ * are reported with the same diagnostics.
+ *
+ * \param program the description of the program, if any, which provides its
+ * name and indicates that a `--help` option is available.
+ * \param seen_tokens scratch space for `table.size` tokens, used to remember
+ * the first value of each option.
+ *
+ * \throw CmdLineArgumentsError if the arguments are not valid.
+ */
+ASAP_CLAP_API void ParseCommandLine(const CommandTable &table,
+    const ProgramInfo *program, int argc, const char **argv, void *values,
+    StoreValueFn store, std::string_view *seen_tokens);
+
+template <typename T>
+auto StoreValue(std::optional<T> &slot, std::string_view token) -> bool {
+  T value{};
+  if (!clap::detail::ParseValue(token, value)) {
+    return false;
+  }
+  slot = std::move(value);
+  return true;
+}
+
+template <typename T>
+auto StoreValue(std::vector<T> &slot, std::string_view token) -> bool {
+  T value{};
+  if (!clap::detail::ParseValue(token, value)) {
+    return false;
+  }
+  slot.push_back(std::move(value));
+  return true;
+}
+
+} // namespace detail
+
+/*!
+ * \brief The compile time description of an option which value has type `T`.
+ *
+ * An option with type `std::vector<U>` is repeatable and collects all its
+ * values; any other option keeps the single value it got on the command line,
+ * if any. Options of type `bool` are flags, which are `true` when they appear
+ * without a value.
+ *
+ * \see OptionValueBuilder::Delimiter() for how this differs from options with
+ * `std::vector<U>` values in the runtime API.
+ */
+template <typename T> struct OptionSpec {
+  using SlotType =
+      std::conditional_t<detail::IsVector<T>::value, T, std::optional<T>>;
+
+  std::string_view key;
+  std::string_view short_name{};
+  std::string_view long_name{};
+  bool positional{false};
+  std::string_view about{};
+  std::string_view user_friendly_name{};
+
+  /*! \brief This option with the given single character short name. */
+  [[nodiscard]] constexpr auto Short(std::string_view name) const
+      -> OptionSpec {
+    if (name.size() != 1) {
+      throw std::invalid_argument("short names must be one character long");
+    }
+    auto spec = *this;
+    spec.short_name = name;
+    return spec;
+  }
+
+  /*! \brief This option with the given long name. */
+  [[nodiscard]] constexpr auto Long(std::string_view name) const
+      -> OptionSpec {
+    if (name.empty()) {
+      throw std::invalid_argument("long names cannot be empty");
+    }
+    auto spec = *this;
+    spec.long_name = name;
+    return spec;
+  }
+
+  /*! \brief This option with the given description for the help. */
+  [[nodiscard]] constexpr auto About(std::string_view about_text) const
+      -> OptionSpec {
+    auto spec = *this;
+    spec.about = about_text;
+    return spec;
+  }
+
+  /*! \brief This option with the given name for its value in the help. */
+  [[nodiscard]] constexpr auto UserFriendlyName(std::string_view name) const
+      -> OptionSpec {
+    auto spec = *this;
+    spec.user_friendly_name = name;
+    return spec;
+  }
+};
+
+/*! \brief Start the description of an option with the given key. */
+template <typename T>
+constexpr auto Option(std::string_view key) -> OptionSpec<T> {
+  return OptionSpec<T>{key};
+}
+
+/*!
+ * \brief Describe the positional arguments, which are all collected in the
+ * same `std::vector`.
+ */
+template <typename T>
+constexpr auto Rest(std::string_view key) -> OptionSpec<T> {
+  static_assert(detail::IsVector<T>::value,
+      "positional arguments are collected in a std::vector");
+  return OptionSpec<T>{key, {}, {}, true};
+}
+
+/*!
+ * \brief The values parsed with a schema, with one slot per option, in the
+ * same order as the options in the schema.
+ */
+template <typename... Specs> class Values {
+public:
+  /*!
+   * \brief The slot of the option at `index` in the schema: a `std::optional`
+   * or, for repeatable options, a `std::vector`.
+   */
+  template <std::size_t index>
+  [[nodiscard]] auto Get() const -> const auto & {
+    return std::get<index>(slots_);
+  }
+
+  /*! \copydoc detail::StoreValueFn */
+  static auto Store(void *values, std::size_t id, std::string_view token)
+      -> bool {
+    return static_cast<Values *>(values)->StoreAt(
+        id, token, std::index_sequence_for<Specs...>{});
+  }
+
+private:
+  template <std::size_t... index>
+  auto StoreAt(std::size_t id, std::string_view token,
+      std::index_sequence<index...> /*indices*/) -> bool {
+    // Expands to a chain of comparisons with constants, which the compiler
+    // turns into a jump table with each conversion inlined.
+    bool stored{false};
+    static_cast<void>(
+        ((id == index &&
+             (stored = detail::StoreValue(std::get<index>(slots_), token),
+                 true)) ||
+            ...));
+    return stored;
+  }
+
+  std::tuple<typename Specs::SlotType...> slots_;
+};
+
+/*!
+ * \brief A default command described at compile time.
+ *
+ * All the lookup tables used by the parser (options by short name, sorted long
+ * names, etc.) are computed when the schema is constructed, which is at
+ * compile time for a `constexpr` schema, and the parser generated for it
+ * stores values directly in their statically typed slots, without virtual
+ * calls nor `std::any`.
+ *
+ * \code
+ * static constexpr auto cli = schema::Command(
+ *     schema::Option<bool>("verbose").Short("v").Long("verbose"),
+ *     schema::Option<int>("level").Long("level"),
+ *     schema::Rest<std::vector<std::string>>("files"));
+ *
+ * const auto values = cli.Parse(argc, argv);
+ * const bool verbose = values.Get<cli.IndexOf("verbose")>().value_or(false);
+ * \endcode
+ */
+template <typename... Specs> class CommandSchema {
+public:
+  using ValuesType = Values<Specs...>;
+  static constexpr std::size_t SIZE = sizeof...(Specs);
+  static_assert(SIZE < detail::NO_OPTION, "too many options");
+
+  constexpr explicit CommandSchema(const Specs &...specs)
+      : entries_{detail::OptionEntry{specs.key, specs.short_name,
+            specs.long_name, specs.about,
+            DefaultUserFriendlyName(specs),
+            std::is_same_v<typename Specs::SlotType, std::optional<bool>>,
+            detail::IsVector<typename Specs::SlotType>::value,
+            specs.positional}...} {
+    BuildTables();
+  }
+
+  /*! \brief A view over the lookup tables of this schema. */
+  [[nodiscard]] constexpr auto Table() const -> detail::CommandTable {
+    return detail::CommandTable{entries_.data(), SIZE, short_names_.data(),
+        sorted_long_names_.data(), long_names_count_, positional_};
+  }
+
+  /*! \brief The index of the option with the given key. */
+  [[nodiscard]] constexpr auto IndexOf(std::string_view key) const
+      -> std::size_t {
+    for (std::size_t id = 0; id < SIZE; ++id) {
+      if (entries_[id].key == key) {
+        return id;
+      }
+    }
+    throw std::invalid_argument("no option with this key in the schema");
+  }
+
+  /*!
+   * \brief Parse the given program arguments.
+   *
+   * \throw CmdLineArgumentsError if the arguments are not valid.
+   */
+  [[nodiscard]] auto Parse(int argc, const char **argv) const -> ValuesType {
+    return Parse(nullptr, argc, argv);
+  }
+
+private:
+  template <typename... OtherSpecs> friend class ProgramSchema;
+
+  template <typename Spec>
+  static constexpr auto DefaultUserFriendlyName(const Spec &spec)
+      -> std::string_view {
+    if (!spec.user_friendly_name.empty()) {
+      return spec.user_friendly_name;
+    }
+    return spec.positional ? spec.key : std::string_view{"value"};
+  }
+
+  [[nodiscard]] auto Parse(const ProgramInfo *program, int argc,
+      const char **argv) const -> ValuesType {
+    ValuesType values;
+    std::array<std::string_view, SIZE> seen_tokens{};
+    detail::ParseCommandLine(Table(), program, argc, argv, &values,
+        &ValuesType::Store, seen_tokens.data());
+    return values;
+  }
+
+  constexpr void BuildTables() {
+    for (auto &id : short_names_) {
+      id = detail::NO_OPTION;
+    }
+    for (std::size_t id = 0; id < SIZE; ++id) {
+      const auto &entry = entries_[id];
+      for (std::size_t other = 0; other < id; ++other) {
+        if (entries_[other].key == entry.key) {
+          throw std::invalid_argument("duplicate option key");
+        }
+      }
+      if (entry.positional) {
+        if (positional_ != detail::NO_OPTION) {
+          throw std::invalid_argument("only one Rest() is allowed");
+        }
+        positional_ = static_cast<detail::OptionId>(id);
+        continue;
+      }
+      if (!entry.short_name.empty()) {
+        auto &slot =
+            short_names_[static_cast<unsigned char>(entry.short_name[0])];
+        if (slot != detail::NO_OPTION) {
+          throw std::invalid_argument("duplicate short name");
+        }
+        slot = static_cast<detail::OptionId>(id);
+      }
+      if (!entry.long_name.empty()) {
+        InsertSortedLongName(static_cast<detail::OptionId>(id));
+      }
+    }
+  }
+
+  constexpr void InsertSortedLongName(detail::OptionId id) {
+    const auto name = entries_[id].long_name;
+    auto position = long_names_count_;
+    while (position > 0 &&
+           name < entries_[sorted_long_names_[position - 1]].long_name) {
+      sorted_long_names_[position] = sorted_long_names_[position - 1];
+      --position;
+    }
+    if (position > 0 &&
+        name == entries_[sorted_long_names_[position - 1]].long_name) {
+      throw std::invalid_argument("duplicate long name");
+    }
+    sorted_long_names_[position] = id;
+    ++long_names_count_;
+  }
+
+  std::array<detail::OptionEntry, SIZE> entries_;
+  std::array<detail::OptionId, 256> short_names_{};
+  std::array<detail::OptionId, SIZE> sorted_long_names_{};
+  std::size_t long_names_count_{0};
+  detail::OptionId positional_{detail::NO_OPTION};
+};
+
+/*! \brief Describe the default command of a program with the given options. */
+template <typename... Specs>
+constexpr auto Command(const Specs &...specs) -> CommandSchema<Specs...> {
+  return CommandSchema<Specs...>(specs...);
+}
+
+/*!
+ * \brief A read-only view over the static tables describing a program, which
+ * provides what a `Cli` provides for a program built at runtime: its name,
+ * version and description, and the help and version information.
+ *
+ * The view only refers to tables with static storage duration, and can be
+ * copied freely; creating it never allocates.
+ */
+class CliView {
+public:
+  constexpr CliView(
+      const ProgramInfo &program, const detail::CommandTable &table)
+      : program_{program}, table_{table} {
+  }
+
+  /*!
+   * \brief The program name as given in the program info, which may be empty.
+   */
+  [[nodiscard]] constexpr auto ProgramName() const -> std::string_view {
+    return program_.name;
+  }
+
+  [[nodiscard]] constexpr auto Version() const -> std::string_view {
+    return program_.version;
+  }
+
+  [[nodiscard]] constexpr auto About() const -> std::string_view {
+    return program_.about;
+  }
+
+  /*!
+   * \brief The number of options and positional arguments of the default
+   * command.
+   */
+  [[nodiscard]] constexpr auto OptionsCount() const -> std::size_t {
+    return table_.size;
+  }
+
+  /*!
+   * \brief Print the help of the program, in the same format as the help of a
+   * `Cli` built at runtime.
+   *
+   * \param program_name the name to use for the program if the program info
+   * does not have one.
+   */
+  ASAP_CLAP_API void PrintHelp(std::ostream &out,
+      std::string_view program_name = {}, unsigned int width = 80) const;
+
+  /*! \brief Print the version information of the program. */
+  ASAP_CLAP_API void PrintVersion(
+      std::ostream &out, std::string_view program_name = {}) const;
+
+private:
+  ProgramInfo program_;
+  detail::CommandTable table_;
+};
+
+namespace detail {
+
+/*!
+ * \brief What the command line asks for, as far as the program itself is
+ * concerned.
+ */
+enum class ProgramRequest : std::uint8_t { Parse, Help, Version };
+
+/*!
+ * \brief Handle the `help` and `version` requests on the command line, in the
+ * same way as a `Cli` with the help and version commands enabled.
+ *
+ * Short forms (`-h` and `-v`) are only recognized if the command does not
+ * use these short names for its own options.
+ */
+ASAP_CLAP_API auto HandleProgramRequest(const ProgramInfo &program,
+    const CommandTable &table, int argc, const char **argv) -> ProgramRequest;
+
+} // namespace detail
+
+/*!
+ * \brief A program with a default command described at compile time.
+ *
+ * Such a program can be a `constexpr` object, placed in read-only data, and
+ * nothing is allocated until the command line is parsed.
+ *
+ * \code
+ * static constexpr auto program = schema::Program(
+ *     {"tool", "1.0.0", "Does things."},
+ *     schema::Command(schema::Option<bool>("verbose").Long("verbose")));
+ *
+ * int main(int argc, const char **argv) {
+ *   const auto values = program.Parse(argc, argv);
+ *   if (!values) {
+ *     return 0; // help or version was displayed
+ *   }
+ *   ...
+ * }
+ * \endcode
+ */
+template <typename... Specs> class ProgramSchema {
+public:
+  using CommandType = CommandSchema<Specs...>;
+  using ValuesType = typename CommandType::ValuesType;
+
+  constexpr ProgramSchema(
+      const ProgramInfo &program, const CommandType &command)
+      : program_{program}, command_{command} {
+  }
+
+  /*! \brief The default command of the program. */
+  [[nodiscard]] constexpr auto Command() const -> const CommandType & {
+    return command_;
+  }
+
+  /*! \brief A view over the tables of this program. */
+  [[nodiscard]] constexpr auto View() const -> CliView {
+    return CliView{program_, command_.Table()};
+  }
+
+  /*!
+   * \brief Parse the given program arguments.
+   *
+   * \return the parsed values, or nothing if the help or the version of the
+   * program was requested and has been displayed on the standard output.
+   *
+   * \throw CmdLineArgumentsError if the arguments are not valid.
+   */
+  [[nodiscard]] auto Parse(int argc, const char **argv) const
+      -> std::optional<ValuesType> {
+    if (detail::HandleProgramRequest(program_, command_.Table(), argc, argv) !=
+        detail::ProgramRequest::Parse) {
+      return std::nullopt;
+    }
+    return command_.Parse(&program_, argc, argv);
+  }
+
+private:
+  ProgramInfo program_;
+  CommandType command_;
+};
+
+/*! \brief Describe a program with the given information and default command. */
+template <typename... Specs>
+constexpr auto Program(const ProgramInfo &program,
+    const CommandSchema<Specs...> &command) -> ProgramSchema<Specs...> {
+  return ProgramSchema<Specs...>(program, command);
+}
+
+} // namespace asap::clap::schema
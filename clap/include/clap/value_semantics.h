@@ -14,12 +14,18 @@
 #pragma once
 
 #include <any>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "clap/asap_clap_export.h"
 
 namespace asap::clap {
 
+namespace detail {
+class ValueStore;
+} // namespace detail
+
 /*!
  * \brief Describes how a command line option's value is to be parsed and
  * converted into C++ types.
@@ -50,9 +56,11 @@ namespace asap::clap {
  * This is the interface used by the command line parser to interact with
  * options while parsing their values and validating them. The interface is
  * quite generic by design so that the parser does not really care about the
- * specific option value's type. Instead, it only manipulates values of type
- * `std::any`. The concrete implementation of this interface will deal with
- * specific value types.
+ * specific option value's type. Instead, it asks the option for a store for
+ * its values, and then for values to be parsed into that store. The concrete
+ * implementation of this interface deals with specific value types, and
+ * stores values with their type, without going through `std::any`. Values are
+ * still exchanged as `std::any` for notifications.
  */
 class ASAP_CLAP_API ValueSemantics {
 public:
@@ -106,6 +114,14 @@ public:
   virtual auto ApplyDefault(
       std::any &value_store, std::string &value_as_text) const -> bool = 0;
 
+  /**
+   * \brief Append the default value to `store`, marked as defaulted.
+   *
+   * \return *true* if the default value is stored, and *false* if no default
+   * value exists.
+   */
+  virtual auto ApplyDefault(detail::ValueStore &store) const -> bool = 0;
+
   /**
    * \brief Assign the implicit value to 'value_store'.
    *
@@ -120,11 +136,26 @@ public:
   virtual auto ApplyImplicit(
       std::any &value_store, std::string &value_as_text) const -> bool = 0;
 
+  /**
+   * \brief Append the implicit value to `store`.
+   *
+   * \return *true* if the implicit value is stored, and *false* if no
+   * implicit value exists.
+   */
+  virtual auto ApplyImplicit(detail::ValueStore &store) const -> bool = 0;
+
+  /**
+   * \brief Make an empty store for the values of the option, in which the
+   * other methods of this interface can store values.
+   */
+  [[nodiscard]] virtual auto MakeValueStore() const
+      -> std::unique_ptr<detail::ValueStore> = 0;
+
   /**
    * \brief Parse a token to extract from it a value for an option.
    *
-   * Stores the result in 'value_store', using whatever representation is
-   * desired.
+   * Appends the result, with the token, to `store`, which must have been made
+   * by `MakeValueStore()`.
    *
    * \return *true* if the parsing resulted in a suitable value extracted from
    * the token for the option, and *false* if the token could not be interpreted
@@ -135,21 +166,35 @@ public:
    * The parser will continue interpreting that token as something else as
    * specified by the command line (e.g. a positional argument).
    */
-  virtual auto Parse(std::any &value_store, const std::string &token) const
+  virtual auto Parse(detail::ValueStore &store, std::string_view token) const
       -> bool = 0;
 
+  /**
+   * \brief Indicates if the option wants to be notified of its final value,
+   * i.e. if `Notify()` does anything.
+   */
+  [[nodiscard]] virtual auto NotifiesFinalValue() const -> bool = 0;
+
   /**
    * \brief Called when final value of an option is determined.
+   *
+   * The parser calls it once parsing is complete and default values have been
+   * applied, once for each value of the option.
    */
   virtual void Notify(const std::any &value_store) const = 0;
-  // TODO(Abdessattar) refactor callback interface
-  //  - Allow to pass a callback function that gets called by the parser. The
-  //  callback is always invoked (when an option is specified, when an option
-  //  is not specified and when a default value is assigned to the option)
-  //  ==> add Notify(Callback) to ValueDescriptor class
-  //  - Allow for the callback to be setup to be called on every value instead
-  //  of when the final value(s) is(are) determined at the ned of parsing
-  //  ==> add NotifyOnEachValue(Callback) to ValueDescriptor class
+
+  /**
+   * \brief Indicates if the option wants to be notified of each value as soon
+   * as it is accepted, i.e. if `NotifyEachValue()` does anything.
+   */
+  [[nodiscard]] virtual auto NotifiesEachValue() const -> bool = 0;
+
+  /**
+   * \brief Called by the parser as soon as a value from the command line is
+   * accepted for the option, while the rest of the command line is still to
+   * be parsed.
+   */
+  virtual void NotifyEachValue(const std::any &value_store) const = 0;
 };
 
 } // namespace asap::clap
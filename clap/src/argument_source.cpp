@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the streaming argument sources.
+ */
+
+#include "clap/argument_source.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <istream>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace asap::clap {
+
+namespace {
+
+auto ReadFromFileDescriptor(int fd, char *buffer, std::size_t size)
+    -> std::size_t {
+  for (;;) {
+#if defined(_WIN32)
+    constexpr std::size_t max_read = 1U << 30U;
+    const auto count = ::_read(
+        fd, buffer, static_cast<unsigned int>(std::min(size, max_read)));
+#else
+    const auto count = ::read(fd, buffer, size);
+#endif
+    if (count >= 0) {
+      return static_cast<std::size_t>(count);
+    }
+    if (errno != EINTR) {
+      throw std::system_error(
+          errno, std::generic_category(), "failed to read arguments");
+    }
+  }
+}
+
+} // namespace
+
+auto ArgumentSource::FromFileDescriptor(int fd, ArgumentDelimiter delimiter)
+    -> ArgumentSource {
+  return ArgumentSource{
+      [fd](char *buffer, std::size_t size) {
+        return ReadFromFileDescriptor(fd, buffer, size);
+      },
+      delimiter};
+}
+
+auto ArgumentSource::FromStream(std::istream &input,
+    ArgumentDelimiter delimiter) -> ArgumentSource {
+  return ArgumentSource{
+      [&input](char *buffer, std::size_t size) -> std::size_t {
+        if (input.bad()) {
+          throw std::system_error(
+              std::make_error_code(std::io_errc::stream),
+              "failed to read arguments");
+        }
+        // Wait for at least one character, then take whatever else is
+        // already available without blocking.
+        if (!input.get(*buffer)) {
+          return 0;
+        }
+        const auto count = input.readsome(
+            buffer + 1, static_cast<std::streamsize>(size - 1));
+        return static_cast<std::size_t>(count) + 1;
+      },
+      delimiter};
+}
+
+auto ArgumentSource::FromCallback(ReadFunction read,
+    ArgumentDelimiter delimiter) -> ArgumentSource {
+  return ArgumentSource{std::move(read), delimiter};
+}
+
+} // namespace asap::clap
@@ -11,12 +11,17 @@
  */
 
 #include "clap/cli.h"
+#include "clap/debug/allocation_stats.h"
 #include "clap/detail/args.h"
 #include "clap/fluent/command_builder.h"
 #include "clap/fluent/positional_option_builder.h"
+#include "parser/command_trie.h"
+#include "parser/notifications.h"
 #include "parser/parser.h"
 #include "parser/tokenizer.h"
 
+#include <algorithm>
+#include <stdexcept>
 #include <sstream>
 
 #include <common/compilers.h>
@@ -43,32 +48,138 @@ namespace asap::clap {
 
 CmdLineArgumentsError::~CmdLineArgumentsError() = default;
 
-auto Cli::Parse(int argc, const char **argv) -> CommandLineContext {
-  const Arguments cla{argc, argv};
+Cli::Cli()
+    : command_trie_{nullptr,
+          // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+          [](const parser::CommandTrie *trie) { delete trie; }},
+      notification_workers_{nullptr,
+          // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+          [](const parser::NotificationWorkers *workers) { delete workers; }} {
+}
 
-  if (!program_name_) {
-    program_name_ = cla.ProgramName();
+void Cli::NotificationsOnWorkerThread(bool enable) {
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  notification_workers_.reset(
+      enable ? new parser::NotificationWorkers() : nullptr);
+}
+
+void Cli::BuildCommandTrie() {
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  command_trie_.reset(new parser::CommandTrie(commands_));
+}
+
+void Cli::AssignOptionIds() {
+  // The ids are kept in a table of the `Cli`, and not in the options, which
+  // can be shared with other `Cli`s. Options shared by several commands are
+  // seen more than once, and keep the id they were given the first time.
+  auto option_ids = std::make_shared<OptionIds>();
+  for (const auto &command : commands_) {
+    for (const auto &option : command->CommandOptions()) {
+      option_ids->Add(*option);
+    }
+    for (const auto &option : command->PositionalArguments()) {
+      option_ids->Add(*option);
+    }
   }
+  option_ids_ = std::move(option_ids);
+}
+
+auto Cli::Parse(int argc, const char **argv) const -> ParseResult {
+  std::string program_name;
+  // The arguments are views into `argv`; hand them over to the tokenizer
+  // without copying the underlying strings.
+  parser::Tokenizer tokenizer{
+      PrepareArguments(argc, argv, program_name), response_files_};
+  return ParseTokens(tokenizer, std::move(program_name));
+}
+
+auto Cli::Parse(int argc, const char **argv, ArgumentSource source) const
+    -> ParseResult {
+  std::string program_name;
+  parser::Tokenizer tokenizer{PrepareArguments(argc, argv, program_name),
+      std::move(source), response_files_};
+  return ParseTokens(tokenizer, std::move(program_name));
+}
+
+auto Cli::ParseBound(detail::BoundTarget target, int argc,
+    const char **argv) const -> ParseResult {
+  std::string program_name;
+  parser::Tokenizer tokenizer{
+      PrepareArguments(argc, argv, program_name), response_files_};
+  return ParseTokens(tokenizer, std::move(program_name), target);
+}
+
+auto Cli::PrepareArguments(int argc, const char **argv,
+    std::string &program_name) const -> std::vector<std::string_view> {
+  const debug::PhaseScope phase{debug::ParsePhase::Arguments};
+  const Arguments cla{argc, argv};
+
+  program_name = program_name_.value_or(cla.ProgramName());
 
   auto &args = cla.Args();
 
-  // Simplify processing by transforming the shor or long option forms of
-  // `version` and `help` into the corresponding unified command name.
   if (!args.empty()) {
-    std::string &first = args[0];
-    if (has_version_command_ &&
-        (first == Command::VERSION_SHORT || first == Command::VERSION_LONG)) {
-      first.assign(Command::VERSION);
-    } else if (has_help_command_ &&
-               (first == Command::HELP_SHORT || first == Command::HELP_LONG)) {
-      first.assign(Command::HELP);
+    args[0] = UnifiedCommandName(args[0]);
+  }
+
+  return std::move(args);
+}
+
+auto Cli::ParseLine(std::string_view line) const -> ParseResult {
+  // The `version` and `help` forms never need quoting, so the first argument
+  // only needs to be looked at if it is a plain word. In the common case, the
+  // whole line goes to the tokenizer and no argument list is built.
+  std::vector<std::string_view> args;
+  const auto start = line.find_first_not_of(" \t\n");
+  if (start != std::string_view::npos) {
+    const auto end = std::min(line.find_first_of(" \t\n", start), line.size());
+    const auto first = line.substr(start, end - start);
+    const auto unified = UnifiedCommandName(first);
+    if (unified != first) {
+      args.push_back(unified);
+      line.remove_prefix(end);
     }
   }
+  parser::Tokenizer tokenizer{
+      std::move(args), parser::LineSplitter{line}, response_files_};
+  return ParseTokens(tokenizer, ProgramName());
+}
 
-  const parser::Tokenizer tokenizer{cla.Args()};
-  CommandLineContext context(ProgramName(), active_command_, ovm_);
-  parser::CmdLineParser parser(context, tokenizer, commands_);
-  if (parser.Parse()) {
+auto Cli::UnifiedCommandName(std::string_view arg) const -> std::string_view {
+  // Simplify processing by transforming the short or long option forms of
+  // `version` and `help` into the corresponding unified command name.
+  if (has_version_command_ &&
+      (arg == Command::VERSION_SHORT || arg == Command::VERSION_LONG)) {
+    return Command::VERSION;
+  }
+  if (has_help_command_ &&
+      (arg == Command::HELP_SHORT || arg == Command::HELP_LONG)) {
+    return Command::HELP;
+  }
+  return arg;
+}
+
+auto Cli::ParseTokens(parser::Tokenizer &tokenizer,
+    std::string program_name, detail::BoundTarget target) const
+    -> ParseResult {
+  tokenizer.ClassifyUpfront(bulk_argument_classification_);
+  const debug::PhaseScope phase{debug::ParsePhase::Parsing};
+  // Everything produced by the parse goes into the result; the `Cli` itself
+  // is never modified, so that it can be shared by concurrent parses.
+  ParseResult result{std::move(program_name), {},
+      OptionValuesMap{option_ids_}};
+  CommandLineContext context(
+      result.program_name, result.active_command, result.ovm);
+  context.allow_abbreviated_long_options = abbreviated_long_options_;
+  context.notification_workers = notification_workers_.get();
+  context.bound_target = target;
+  parser::CmdLineParser parser(context, tokenizer, *command_trie_);
+  CompleteParse(parser.Parse(), context);
+  return result;
+}
+
+void Cli::CompleteParse(bool parsed, const CommandLineContext &context) const {
+  if (parsed) {
     // Check if we need to handle a `version` or `help` command
     if (context.active_command->PathAsString() == "help" ||
         context.ovm.HasOption("help")) {
@@ -76,18 +187,17 @@ auto Cli::Parse(int argc, const char **argv) -> CommandLineContext {
     } else if (context.active_command->PathAsString() == "version") {
       HandleVersionCommand(context);
     }
-
-    return context;
+    return;
   }
   if (HasHelpCommand()) {
     context.out_ << fmt::format("Try '{} --help' for more information.",
-                        program_name_.value())
+                        context.program_name_)
                  << std::endl;
   }
   throw CmdLineArgumentsError(
       fmt::format("command line arguments parsing failed, try '{} --help' for "
                   "more information.",
-          program_name_.value()));
+          context.program_name_));
 }
 
 auto operator<<(std::ostream &out, const Cli &cli) -> std::ostream & {
@@ -96,10 +206,15 @@ auto operator<<(std::ostream &out, const Cli &cli) -> std::ostream & {
 }
 
 void Cli::PrintDefaultCommand(std::ostream &out, unsigned int width) const {
+  PrintDefaultCommand(out, ProgramName(), width);
+}
+
+void Cli::PrintDefaultCommand(std::ostream &out,
+    const std::string &program_name, unsigned int width) const {
   const auto default_command = std::find_if(commands_.begin(), commands_.end(),
       [](const auto &command) { return command->IsDefault(); });
   if (default_command != commands_.end()) {
-    (*default_command)->Print(out, width);
+    (*default_command)->Print(out, program_name, width);
   }
 }
 
@@ -136,7 +251,7 @@ void Cli::EnableVersionCommand() {
 
 void Cli::HandleVersionCommand(const CommandLineContext &context) const {
   context.out_ << fmt::format(
-                      "{} version {}\n", program_name_.value(), version_)
+                      "{} version {}\n", context.program_name_, version_)
                << std::endl;
 }
 
@@ -162,7 +277,7 @@ void Cli::EnableHelpCommand() {
 }
 void Cli::HandleHelpCommand(const CommandLineContext &context) const {
   if (context.ovm.HasOption("help")) {
-    context.active_command->Print(context.out_, 80);
+    context.active_command->Print(context.out_, context.program_name_, 80);
   } else if (context.active_command->PathAsString() == "help") {
     if (context.ovm.HasOption(Option::key_rest)) {
       const auto &values = context.ovm.ValuesOf(Option::key_rest);
@@ -178,17 +293,17 @@ void Cli::HandleHelpCommand(const CommandLineContext &context) const {
             return command->Path() == command_path;
           });
       if (command != commands_.end()) {
-        (*command)->Print(context.out_, 80);
+        (*command)->Print(context.out_, context.program_name_, 80);
       } else {
         context.err_ << fmt::format(
             "The path `{}` does not correspond to a known command.\n",
             fmt::join(command_path, " "));
         context.out_ << fmt::format("Try '{} --help' for more information.",
-                            program_name_.value())
+                            context.program_name_)
                      << std::endl;
       }
     } else {
-      PrintDefaultCommand(context.out_, 80);
+      PrintDefaultCommand(context.out_, context.program_name_, 80);
       PrintCommands(context.out_, 80);
     }
   }
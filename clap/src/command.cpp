@@ -40,7 +40,12 @@ auto asap::clap::Command::ProgramName() const -> std::string {
 }
 
 void asap::clap::Command::PrintSynopsis(std::ostream &out) const {
-  out << ProgramName() << " " << PathAsString() << " ";
+  PrintSynopsis(out, ProgramName());
+}
+
+void asap::clap::Command::PrintSynopsis(
+    std::ostream &out, const std::string &program_name) const {
+  out << program_name << " " << PathAsString() << " ";
   for (const auto &option : options_) {
     out << (option->value_semantic()->IsRequired() ? "" : "[");
     if (!option->Short().empty()) {
@@ -98,6 +103,11 @@ void asap::clap::Command::PrintOptions(
 }
 
 void asap::clap::Command::Print(std::ostream &out, unsigned int width) const {
+  Print(out, ProgramName(), width);
+}
+
+void asap::clap::Command::Print(std::ostream &out,
+    const std::string &program_name, unsigned int width) const {
   wrap::TextWrapper wrap = wrap::TextWrapper::Create()
                                .Width(width)
                                .CollapseWhiteSpace()
@@ -108,7 +118,7 @@ void asap::clap::Command::Print(std::ostream &out, unsigned int width) const {
   std::ostringstream ostr;
 
   out << "SYNOPSIS\n";
-  PrintSynopsis(ostr);
+  PrintSynopsis(ostr, program_name);
   out << wrap.Fill(ostr.str()).value();
   ostr.str("");
   ostr.clear();
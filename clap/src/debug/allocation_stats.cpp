@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation of the allocation counting debug API.
+ */
+
+#include "clap/debug/allocation_stats.h"
+
+namespace asap::clap::debug {
+
+namespace {
+
+// Both are constant initialized, so that accessing them never allocates, even
+// from within `operator new`.
+thread_local ParsePhase current_phase{ParsePhase::None};
+thread_local AllocationStats stats{};
+
+} // namespace
+
+auto EnterPhase(ParsePhase phase) noexcept -> ParsePhase {
+  const auto previous = current_phase;
+  current_phase = phase;
+  return previous;
+}
+
+auto CurrentPhase() noexcept -> ParsePhase {
+  return current_phase;
+}
+
+void RecordAllocation(std::size_t bytes) noexcept {
+  auto &counters = stats.counters_[static_cast<std::size_t>(current_phase)];
+  ++counters.allocations;
+  counters.bytes += bytes;
+}
+
+auto GetAllocationStats() noexcept -> AllocationStats {
+  return stats;
+}
+
+void ResetAllocationStats() noexcept {
+  stats = AllocationStats{};
+}
+
+} // namespace asap::clap::debug
@@ -34,7 +34,7 @@ public:
   }
 
   std::string program_name;
-  std::vector<std::string> args{};
+  std::vector<std::string_view> args{};
 };
 
 asap::clap::detail::Arguments::Arguments(int argc, const char **argv)
@@ -46,6 +46,7 @@ asap::clap::detail::Arguments::Arguments(int argc, const char **argv)
 auto asap::clap::detail::Arguments::ProgramName() const -> const std::string & {
   return impl_->program_name;
 }
-auto asap::clap::detail::Arguments::Args() const -> std::vector<std::string> & {
+auto asap::clap::detail::Arguments::Args() const
+    -> std::vector<std::string_view> & {
   return impl_->args;
 }
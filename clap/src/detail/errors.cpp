@@ -12,7 +12,10 @@
 
 #include "errors.h"
 
+#include <algorithm>
+#include <iterator>
 #include <numeric>
+#include <vector>
 
 #include <common/compilers.h>
 #include <contract/contract.h>
@@ -32,6 +35,7 @@ ASAP_DIAGNOSTIC_PUSH
 #endif
 #include <fmt/core.h>
 #include <fmt/format.h>
+#include <fmt/ranges.h>
 ASAP_DIAGNOSTIC_POP
 
 namespace {
@@ -43,18 +47,35 @@ void AppendOptionalMessage(std::string &description, const char *message) {
   description.append(" - ").append(message).append(".");
 }
 
+auto CommandDiagnostic(std::string_view command_path) -> std::string {
+  if (command_path.empty()) {
+    return "";
+  }
+  return fmt::format("while parsing command '{}',", command_path);
+}
+
 auto CommandDiagnostic(const asap::clap::parser::detail::CommandPtr &command)
     -> std::string {
   if (!command || command->IsDefault()) {
     return "";
   }
-  return fmt::format("while parsing command '{}',", command->PathAsString());
+  return CommandDiagnostic(command->PathAsString());
+}
+
+// The path of a command as expected by the diagnostics which take a command
+// path, i.e. empty for the default command.
+auto CommandPathOf(const asap::clap::parser::detail::CommandPtr &command)
+    -> std::string {
+  if (!command || command->IsDefault()) {
+    return "";
+  }
+  return command->PathAsString();
 }
 
 } // namespace
 
 auto asap::clap::parser::detail::UnrecognizedCommand(
-    const std::vector<std::string> &path_segments, const char *message)
+    const std::vector<std::string_view> &path_segments, const char *message)
     -> std::string {
   auto description = fmt::format(
       "Unrecognized command with path '{}'", fmt::join(path_segments, " "));
@@ -63,9 +84,9 @@ auto asap::clap::parser::detail::UnrecognizedCommand(
 }
 
 auto asap::clap::parser::detail::MissingCommand(
-    const ParserContextPtr &context, const char *message) -> std::string {
+    const ParserContext &context, const char *message) -> std::string {
   auto supported_commands =
-      std::accumulate(context->commands.cbegin(), context->commands.cend(),
+      std::accumulate(context.commands.cbegin(), context.commands.cend(),
           std::vector<std::string>(), [](auto &dest, const auto &command) {
             dest.push_back("'" + command->PathAsString() + "'");
             return dest;
@@ -79,62 +100,109 @@ auto asap::clap::parser::detail::MissingCommand(
 }
 
 auto asap::clap::parser::detail::UnrecognizedOption(
-    const ParserContextPtr &context, const std::string &token,
+    const ParserContext &context, std::string_view token,
+    const char *message) -> std::string {
+  return UnrecognizedOption(
+      CommandPathOf(context.active_command), token, message);
+}
+
+auto asap::clap::parser::detail::UnrecognizedOption(
+    std::string_view command_path, std::string_view token,
     const char *message) -> std::string {
 
-  auto option_name = (token.length() == 1) ? "-" + token : "--" + token;
-  auto description = fmt::format("{} '{}' is not a recognized option",
-      CommandDiagnostic(context->active_command), option_name);
+  const auto *dashes = (token.length() == 1) ? "-" : "--";
+  auto description = fmt::format("{} '{}{}' is not a recognized option",
+      CommandDiagnostic(command_path), dashes, token);
+  AppendOptionalMessage(description, message);
+  return description;
+}
+auto asap::clap::parser::detail::AmbiguousOption(const ParserContext &context,
+    std::string_view token, clap::detail::OptionIndex::ConstIterator first,
+    clap::detail::OptionIndex::ConstIterator last, const char *message)
+    -> std::string {
+  ASAP_EXPECT(first != last);
+
+  std::vector<std::string> candidates;
+  std::transform(first, last, std::back_inserter(candidates),
+      [](const Option *option) { return "--" + option->Long(); });
+  auto description =
+      fmt::format("{} option '--{}' is ambiguous; possibilities: {}",
+          CommandDiagnostic(context.active_command), token,
+          fmt::join(candidates, " "));
   AppendOptionalMessage(description, message);
   return description;
 }
+
 auto asap::clap::parser::detail::IllegalMultipleOccurrence(
-    const ParserContextPtr &context, const char *message) -> std::string {
-  ASAP_EXPECT(context->active_option);
-  ASAP_EXPECT(context->ovm.OccurrencesOf(context->active_option->Key()) > 0);
+    const ParserContext &context, const char *message) -> std::string {
+  ASAP_EXPECT(context.active_option);
+
+  const auto &option_name = context.active_option->Key();
+  std::string_view previous_value;
+  if (context.active_binding != nullptr) {
+    const auto &occurrence =
+        BoundOccurrenceOf(context, *context.active_option);
+    ASAP_EXPECT(occurrence.count > 0);
+    previous_value = occurrence.first_token;
+  } else {
+    const auto &option = *context.active_option;
+    ASAP_EXPECT(context.ovm.OccurrencesOf(option) > 0);
+    previous_value = context.ovm.ValuesOf(option).front().OriginalToken();
+  }
+  return IllegalMultipleOccurrence(CommandPathOf(context.active_command),
+      option_name, context.active_option_flag, previous_value, message);
+}
 
-  const auto &option_name = context->active_option->Key();
+auto asap::clap::parser::detail::IllegalMultipleOccurrence(
+    std::string_view command_path, std::string_view option_key,
+    std::string_view option_flag, std::string_view previous_value,
+    const char *message) -> std::string {
   auto description =
       fmt::format("{} new occurrence for option '{}' "
                   "as '{}' is illegal; it can only be used one time and it "
                   "appeared before with value '{}'",
-          CommandDiagnostic(context->active_command), option_name,
-          context->active_option_flag,
-          context->ovm.ValuesOf(option_name).front().OriginalToken());
+          CommandDiagnostic(command_path), option_key, option_flag,
+          previous_value);
   AppendOptionalMessage(description, message);
   return description;
 }
 
 auto asap::clap::parser::detail::OptionSyntaxError(
-    const ParserContextPtr &context, const char *message) -> std::string {
+    const ParserContext &context, const char *message) -> std::string {
   auto description = fmt::format("{} option '{}' is using an invalid syntax",
-      CommandDiagnostic(context->active_command),
-      context->active_option->Key());
+      CommandDiagnostic(context.active_command),
+      context.active_option->Key());
   AppendOptionalMessage(description, message);
   return description;
 }
 
 auto asap::clap::parser::detail::MissingValueForOption(
-    const ParserContextPtr &context, const char *message) -> std::string {
+    const ParserContext &context, const char *message) -> std::string {
+  return MissingValueForOption(CommandPathOf(context.active_command),
+      context.active_option->Key(), context.active_option_flag, message);
+}
+
+auto asap::clap::parser::detail::MissingValueForOption(
+    std::string_view command_path, std::string_view option_key,
+    std::string_view option_flag, const char *message) -> std::string {
   auto description =
       fmt::format("{} option '{}' seen as '{}' "
                   "has no value on the command line and no implicit one",
-          CommandDiagnostic(context->active_command),
-          context->active_option->Key(), context->active_option_flag);
+          CommandDiagnostic(command_path), option_key, option_flag);
   AppendOptionalMessage(description, message);
   return description;
 }
 
 auto asap::clap::parser::detail::InvalidValueForOption(
-    const ParserContextPtr &context, const std::string &token,
+    const ParserContext &context, std::string_view token,
     const char *message) -> std::string {
 
   auto description = fmt::format(
       "{} option '{}' seen as '{}',"
       " got value token '{}' which failed to parse to type {},"
       " and the option has no implicit value",
-      CommandDiagnostic(context->active_command), context->active_option->Key(),
-      context->active_option_flag, token, "<TODO: TYPE NAME>");
+      CommandDiagnostic(context.active_command), context.active_option->Key(),
+      context.active_option_flag, token, "<TODO: TYPE NAME>");
   AppendOptionalMessage(description, message);
   return description;
 }
@@ -152,14 +220,48 @@ auto asap::clap::parser::detail::MissingRequiredOption(
   return description;
 }
 
+auto asap::clap::parser::detail::ResponseFileNestingTooDeep(
+    std::string_view path, std::size_t max_depth, const char *message)
+    -> std::string {
+  auto description = fmt::format("response file '{}' is nested too deeply; "
+                                 "response files can be nested at most {} "
+                                 "levels deep",
+      path, max_depth);
+  AppendOptionalMessage(description, message);
+  return description;
+}
+
+auto asap::clap::parser::detail::ArgumentSourceReadFailed(
+    std::string_view reason, const char *message) -> std::string {
+  auto description =
+      fmt::format("could not read more arguments from the input ({})", reason);
+  AppendOptionalMessage(description, message);
+  return description;
+}
+
+auto asap::clap::parser::detail::MalformedCommandLine(std::string_view line,
+    std::string_view reason, const char *message) -> std::string {
+  auto description =
+      fmt::format("malformed command line `{}`: {}", line, reason);
+  AppendOptionalMessage(description, message);
+  return description;
+}
+
+auto asap::clap::parser::detail::UnexpectedPositionalArguments(
+    const ParserContext &context, const char *message) -> std::string {
+  return UnexpectedPositionalArguments(CommandPathOf(context.active_command),
+      context.positional_tokens, message);
+}
+
 auto asap::clap::parser::detail::UnexpectedPositionalArguments(
-    const ParserContextPtr &context, const char *message) -> std::string {
+    std::string_view command_path,
+    const std::vector<std::string_view> &positional_tokens,
+    const char *message) -> std::string {
   auto description = fmt::format("{} argument{} '{}' "
                                  "{} not expected by any option",
-      CommandDiagnostic(context->active_command),
-      context->positional_tokens.size() > 1 ? "s" : "",
-      fmt::join(context->positional_tokens, ", "),
-      context->positional_tokens.size() > 1 ? "are" : "is");
+      CommandDiagnostic(command_path), positional_tokens.size() > 1 ? "s" : "",
+      fmt::join(positional_tokens, ", "),
+      positional_tokens.size() > 1 ? "are" : "is");
   AppendOptionalMessage(description, message);
   return description;
 }
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "../parser/context.h"
 #include <clap/asap_clap_export.h>
@@ -20,32 +21,62 @@
 namespace asap::clap::parser::detail {
 
 ASAP_CLAP_API auto UnrecognizedCommand(
-    const std::vector<std::string> &path_segments,
+    const std::vector<std::string_view> &path_segments,
     const char *message = nullptr) -> std::string;
 
-ASAP_CLAP_API auto MissingCommand(const ParserContextPtr &context,
+ASAP_CLAP_API auto MissingCommand(const ParserContext &context,
     const char *message = nullptr) -> std::string;
 
-ASAP_CLAP_API auto UnrecognizedOption(const ParserContextPtr &context,
-    const std::string &token, const char *message = nullptr) -> std::string;
+ASAP_CLAP_API auto UnrecognizedOption(const ParserContext &context,
+    std::string_view token, const char *message = nullptr) -> std::string;
 
-ASAP_CLAP_API auto MissingValueForOption(const ParserContextPtr &context,
+ASAP_CLAP_API auto UnrecognizedOption(std::string_view command_path,
+    std::string_view token, const char *message = nullptr) -> std::string;
+
+ASAP_CLAP_API auto AmbiguousOption(const ParserContext &context,
+    std::string_view token, clap::detail::OptionIndex::ConstIterator first,
+    clap::detail::OptionIndex::ConstIterator last,
+    const char *message = nullptr) -> std::string;
+
+ASAP_CLAP_API auto MissingValueForOption(const ParserContext &context,
     const char *message = nullptr) -> std::string;
 
-ASAP_CLAP_API auto InvalidValueForOption(const ParserContextPtr &context,
-    const std::string &token, const char *message = nullptr) -> std::string;
+ASAP_CLAP_API auto MissingValueForOption(std::string_view command_path,
+    std::string_view option_key, std::string_view option_flag,
+    const char *message = nullptr) -> std::string;
+
+ASAP_CLAP_API auto InvalidValueForOption(const ParserContext &context,
+    std::string_view token, const char *message = nullptr) -> std::string;
 
-ASAP_CLAP_API auto IllegalMultipleOccurrence(const ParserContextPtr &context,
+ASAP_CLAP_API auto IllegalMultipleOccurrence(const ParserContext &context,
     const char *message = nullptr) -> std::string;
 
-ASAP_CLAP_API auto OptionSyntaxError(const ParserContextPtr &context,
+ASAP_CLAP_API auto IllegalMultipleOccurrence(std::string_view command_path,
+    std::string_view option_key, std::string_view option_flag,
+    std::string_view previous_value, const char *message = nullptr)
+    -> std::string;
+
+ASAP_CLAP_API auto OptionSyntaxError(const ParserContext &context,
     const char *message = nullptr) -> std::string;
 
 ASAP_CLAP_API auto MissingRequiredOption(const CommandPtr &command,
     const OptionPtr &option, const char *message = nullptr) -> std::string;
 
+ASAP_CLAP_API auto ResponseFileNestingTooDeep(std::string_view path,
+    std::size_t max_depth, const char *message = nullptr) -> std::string;
+
+ASAP_CLAP_API auto ArgumentSourceReadFailed(
+    std::string_view reason, const char *message = nullptr) -> std::string;
+
+ASAP_CLAP_API auto MalformedCommandLine(std::string_view line,
+    std::string_view reason, const char *message = nullptr) -> std::string;
+
 ASAP_CLAP_API auto UnexpectedPositionalArguments(
-    const ParserContextPtr &context, const char *message = nullptr)
+    const ParserContext &context, const char *message = nullptr)
     -> std::string;
 
+ASAP_CLAP_API auto UnexpectedPositionalArguments(std::string_view command_path,
+    const std::vector<std::string_view> &positional_tokens,
+    const char *message = nullptr) -> std::string;
+
 } // namespace asap::clap::parser::detail
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the OptionIndex class.
+ */
+
+#include "clap/detail/option_index.h"
+#include "clap/option.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <contract/contract.h>
+
+namespace asap::clap::detail {
+
+namespace {
+
+auto HashOf(std::string_view name) -> std::size_t {
+  return std::hash<std::string_view>{}(name);
+}
+
+auto ShortNameSlot(std::string_view name) -> std::size_t {
+  return static_cast<unsigned char>(name.front());
+}
+
+auto LongNameOf(const Option *option) -> std::string_view {
+  return option->Long();
+}
+
+} // namespace
+
+void OptionIndex::Add(const Option *option, bool replace) {
+  ASAP_EXPECT(option != nullptr);
+
+  const std::string_view short_name = option->Short();
+  if (short_name.size() == 1) {
+    auto &slot = short_names_[ShortNameSlot(short_name)];
+    if (slot == nullptr || replace) {
+      slot = option;
+    }
+  } else if (!short_name.empty()) {
+    const auto found = std::find_if(other_short_names_.begin(),
+        other_short_names_.end(), [short_name](const Option *other) {
+          return other->Short() == short_name;
+        });
+    if (found == other_short_names_.end()) {
+      other_short_names_.push_back(option);
+    } else if (replace) {
+      *found = option;
+    }
+  }
+
+  const std::string_view long_name = option->Long();
+  if (!long_name.empty()) {
+    InsertLong(HashOf(long_name), option, replace);
+    InsertSortedLong(option, replace);
+  }
+}
+
+auto OptionIndex::FindShort(std::string_view name) const -> const Option * {
+  if (name.size() == 1) {
+    return short_names_[ShortNameSlot(name)];
+  }
+  if (name.empty()) {
+    return nullptr;
+  }
+  const auto found = std::find_if(other_short_names_.cbegin(),
+      other_short_names_.cend(),
+      [name](const Option *option) { return option->Short() == name; });
+  return found == other_short_names_.cend() ? nullptr : *found;
+}
+
+auto OptionIndex::FindLong(std::string_view name) const -> const Option * {
+  if (long_names_.empty() || name.empty()) {
+    return nullptr;
+  }
+  const auto hash = HashOf(name);
+  const auto mask = long_names_.size() - 1;
+  // The table is never full, so the probing always ends on an empty slot.
+  for (auto index = hash & mask;; index = (index + 1) & mask) {
+    const auto &slot = long_names_[index];
+    if (slot.option == nullptr) {
+      return nullptr;
+    }
+    if (slot.hash == hash && slot.option->Long() == name) {
+      return slot.option;
+    }
+  }
+}
+
+auto OptionIndex::FindLongPrefix(std::string_view prefix) const
+    -> std::pair<ConstIterator, ConstIterator> {
+  if (prefix.empty()) {
+    return {sorted_long_names_.cend(), sorted_long_names_.cend()};
+  }
+  const auto first = std::lower_bound(sorted_long_names_.cbegin(),
+      sorted_long_names_.cend(), prefix,
+      [](const Option *option, std::string_view name) {
+        return LongNameOf(option) < name;
+      });
+  // All the names starting with the prefix come right after it.
+  const auto last = std::partition_point(
+      first, sorted_long_names_.cend(), [prefix](const Option *option) {
+        return LongNameOf(option).substr(0, prefix.size()) == prefix;
+      });
+  return {first, last};
+}
+
+void OptionIndex::InsertLong(
+    std::size_t hash, const Option *option, bool replace) {
+  if (2 * (long_names_count_ + 1) > long_names_.size()) {
+    GrowLongNames();
+  }
+  const auto mask = long_names_.size() - 1;
+  for (auto index = hash & mask;; index = (index + 1) & mask) {
+    auto &slot = long_names_[index];
+    if (slot.option == nullptr) {
+      slot = {hash, option};
+      ++long_names_count_;
+      return;
+    }
+    if (slot.hash == hash && slot.option->Long() == option->Long()) {
+      if (replace) {
+        slot.option = option;
+      }
+      return;
+    }
+  }
+}
+
+void OptionIndex::InsertSortedLong(const Option *option, bool replace) {
+  const auto long_name = LongNameOf(option);
+  const auto position = std::lower_bound(sorted_long_names_.begin(),
+      sorted_long_names_.end(), long_name,
+      [](const Option *other, std::string_view name) {
+        return LongNameOf(other) < name;
+      });
+  if (position != sorted_long_names_.end() &&
+      LongNameOf(*position) == long_name) {
+    if (replace) {
+      *position = option;
+    }
+    return;
+  }
+  sorted_long_names_.insert(position, option);
+}
+
+void OptionIndex::GrowLongNames() {
+  constexpr std::size_t initial_slots = 16;
+  std::vector<Slot> slots(
+      long_names_.empty() ? initial_slots : 2 * long_names_.size(),
+      Slot{0, nullptr});
+  const auto mask = slots.size() - 1;
+  for (const auto &slot : long_names_) {
+    if (slot.option == nullptr) {
+      continue;
+    }
+    auto index = slot.hash & mask;
+    while (slots[index].option != nullptr) {
+      index = (index + 1) & mask;
+    }
+    slots[index] = slot;
+  }
+  long_names_.swap(slots);
+}
+
+} // namespace asap::clap::detail
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the parsing of lists of values.
+ */
+
+#include "clap/detail/parse_list.h"
+
+#include <algorithm>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+#include <contract/contract.h>
+
+namespace asap::clap::detail {
+
+auto CountListElements(std::string_view input, char delimiter)
+    -> std::size_t {
+  // A simple loop over the characters, which compilers vectorize.
+  std::size_t count = 1;
+  for (const char character : input) {
+    count += static_cast<std::size_t>(character == delimiter);
+  }
+  return count;
+}
+
+auto SplitList(std::string_view input, char delimiter, std::size_t max_chunks)
+    -> std::vector<std::string_view> {
+  ASAP_EXPECT(max_chunks > 0);
+  std::vector<std::string_view> chunks;
+  chunks.reserve(max_chunks);
+  const auto chunk_size = input.size() / max_chunks;
+  std::size_t start = 0;
+  for (std::size_t chunk = 1; chunk < max_chunks; ++chunk) {
+    // Cut at the first delimiter after the ideal end of the chunk.
+    const auto cut = input.find(delimiter, std::max(start, chunk * chunk_size));
+    if (cut == std::string_view::npos) {
+      break;
+    }
+    chunks.push_back(input.substr(start, cut - start));
+    start = cut + 1;
+  }
+  chunks.push_back(input.substr(start));
+  return chunks;
+}
+
+auto ListChunksFor(std::size_t size) -> std::size_t {
+  if (size < 2 * PARALLEL_LIST_CHUNK) {
+    return 1;
+  }
+  // Asking for the hardware concurrency is a system call on some platforms.
+  static const auto threads =
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  return std::clamp<std::size_t>(size / PARALLEL_LIST_CHUNK, 1, threads);
+}
+
+void RunInParallel(
+    std::size_t count, const std::function<void(std::size_t)> &work) {
+  std::vector<std::exception_ptr> errors(count);
+  const auto run = [&work, &errors](std::size_t index) {
+    try {
+      work(index);
+    } catch (...) {
+      errors[index] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  // The calling thread does the first part of the work itself, and the parts
+  // for which no thread could be started. Threads already started must be
+  // joined before leaving, whatever happens.
+  std::size_t started = 1;
+  try {
+    for (; started < count; ++started) {
+      threads.emplace_back(run, started);
+    }
+  } catch (const std::system_error & /*error*/) {
+    // Not enough resources for more threads: carry on without them.
+  }
+  if (count > 0) {
+    run(0);
+  }
+  for (std::size_t index = started; index < count; ++index) {
+    run(index);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // namespace asap::clap::detail
@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the conversion of option values.
+ */
+
+#include "clap/detail/parse_value.h"
+
+#include <clocale>
+#include <cstdlib>
+
+#include <locale.h>
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
+
+auto asap::clap::detail::number::StringToLongDouble(
+    const char *text, char **end) noexcept -> long double {
+#if defined(_WIN32)
+  static const _locale_t c_locale = _create_locale(LC_ALL, "C");
+  return _strtold_l(text, end, c_locale);
+#else
+  // Created once, and never freed, as it is used until the program exits.
+  static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", locale_t{});
+  if (c_locale == locale_t{}) {
+    return std::strtold(text, end);
+  }
+  return strtold_l(text, end, c_locale);
+#endif
+}
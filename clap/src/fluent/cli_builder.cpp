@@ -71,6 +71,31 @@ auto asap::clap::CliBuilder::WithHelpCommand() -> Self & {
   return *this;
 }
 
+auto asap::clap::CliBuilder::WithResponseFiles(ResponseFileOptions options)
+    -> Self & {
+  ASAP_ASSERT(cli_ && "builder used after Build() was called");
+  cli_->ResponseFiles(options);
+  return *this;
+}
+
+auto asap::clap::CliBuilder::WithAbbreviatedLongOptions() -> Self & {
+  ASAP_ASSERT(cli_ && "builder used after Build() was called");
+  cli_->AbbreviatedLongOptions(true);
+  return *this;
+}
+
+auto asap::clap::CliBuilder::WithBulkArgumentClassification() -> Self & {
+  ASAP_ASSERT(cli_ && "builder used after Build() was called");
+  cli_->BulkArgumentClassification(true);
+  return *this;
+}
+
+auto asap::clap::CliBuilder::WithNotificationsOnWorkerThread() -> Self & {
+  ASAP_ASSERT(cli_ && "builder used after Build() was called");
+  cli_->NotificationsOnWorkerThread(true);
+  return *this;
+}
+
 void asap::clap::CliBuilder::AddHelpOptionToCommand(Command &command) {
   command.WithOption(
       Option::WithKey("help")
@@ -122,7 +147,7 @@ auto asap::clap::CliBuilder::Build() -> std::unique_ptr<Cli> {
     // If the CLI if did not have a default command, create one and set it up.
     if (!has_default_command) {
       const std::shared_ptr<Command> command =
-          CommandBuilder(cli_->ProgramName(), Command::DEFAULT);
+          CommandBuilder(Command::DEFAULT);
       if (cli_->HasHelpCommand()) {
         AddHelpOptionToCommand(*command);
       }
@@ -137,6 +162,8 @@ auto asap::clap::CliBuilder::Build() -> std::unique_ptr<Cli> {
   for (auto &command : cli_->commands_) {
     command->parent_cli_ = cli_.get();
   }
+  cli_->AssignOptionIds();
+  cli_->BuildCommandTrie();
 
   return std::move(cli_);
 }
@@ -13,12 +13,18 @@
 #include "clap/option.h"
 #include "clap/fluent/dsl.h"
 
+#include <atomic>
 #include <utility>
 
 #include <textwrap/textwrap.h>
 
 namespace asap::clap {
 
+auto Option::SerialNumber::Next() noexcept -> std::uint32_t {
+  static std::atomic<std::uint32_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
 ValueSemantics::~ValueSemantics() noexcept = default;
 
 auto operator<<(std::ostream &out, const Option &option) -> std::ostream & {
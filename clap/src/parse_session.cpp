@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the ParseSession class.
+ */
+
+#include "clap/parse_session.h"
+#include "clap/debug/allocation_stats.h"
+#include "parser/parser.h"
+#include "parser/tokenizer.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <contract/contract.h>
+
+class asap::clap::ParseSession::ParseSessionImpl {
+public:
+  ParseSessionImpl(std::string program_name,
+      std::optional<ResponseFileOptions> response_files,
+      std::shared_ptr<const OptionIds> option_ids)
+      : ovm{std::move(option_ids)},
+        context{std::move(program_name), active_command, ovm},
+        tokenizer{{}, response_files} {
+  }
+
+  Command::Ptr active_command;
+  OptionValuesMap ovm;
+  CommandLineContext context;
+  std::vector<std::string_view> args;
+  parser::Tokenizer tokenizer;
+  // Created by the first parse, once the program name is known, as the parser
+  // keeps its own copy of the context.
+  std::optional<parser::CmdLineParser> parser;
+};
+
+asap::clap::ParseSession::ParseSession(const Cli &cli)
+    : cli_{cli}, impl_(new ParseSessionImpl(cli.program_name_.value_or(""),
+                           cli.response_files_, cli.option_ids_),
+                     // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+                     [](const ParseSessionImpl *impl) { delete impl; }) {
+  impl_->context.allow_abbreviated_long_options =
+      cli.AbbreviatedLongOptions();
+  impl_->tokenizer.ClassifyUpfront(cli.BulkArgumentClassification());
+  impl_->context.notification_workers = cli.notification_workers_.get();
+}
+
+auto asap::clap::ParseSession::Parse(int argc, const char **argv)
+    -> ParseResultView {
+  return ParseBound({}, argc, argv);
+}
+
+auto asap::clap::ParseSession::ParseBound(detail::BoundTarget target,
+    int argc, const char **argv) -> ParseResultView {
+  ASAP_EXPECT(argc > 0);
+  ASAP_EXPECT(argv != nullptr);
+
+  auto &impl = *impl_;
+  {
+    const debug::PhaseScope phase{debug::ParsePhase::Arguments};
+    // Assigning reuses the memory of the arguments list.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    impl.args.assign(argv + 1, argv + argc);
+    if (!impl.args.empty()) {
+      impl.args[0] = cli_.UnifiedCommandName(impl.args[0]);
+    }
+  }
+  impl.tokenizer.Reset(impl.args);
+
+  const debug::PhaseScope phase{debug::ParsePhase::Parsing};
+  impl.active_command.reset();
+  impl.ovm.Clear();
+  if (!impl.parser) {
+    if (impl.context.program_name_.empty()) {
+      impl.context.program_name_.assign(argv[0]);
+    }
+    impl.parser.emplace(impl.context, impl.tokenizer, *cli_.command_trie_);
+  }
+  cli_.CompleteParse(impl.parser->Parse(target), impl.context);
+  return {impl.context.program_name_, impl.active_command, impl.ovm};
+}
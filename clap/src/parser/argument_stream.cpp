@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details of the argument stream.
+ */
+
+#include "argument_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace asap::clap::parser {
+
+ArgumentStream::ArgumentStream(ArgumentSource source)
+    : source_{std::move(source)},
+      delimiter_{source_.Delimiter() == ArgumentDelimiter::Nul ? '\0' : '\n'} {
+}
+
+auto ArgumentStream::NextArgument(std::string_view &arg, bool read) -> bool {
+  for (;;) {
+    if (scan_ < size_) {
+      const auto *found = static_cast<const char *>(
+          std::memchr(block_ + scan_, delimiter_, size_ - scan_));
+      if (found != nullptr) {
+        const auto end = static_cast<std::size_t>(found - block_);
+        arg = {block_ + start_, end - start_};
+        start_ = scan_ = end + 1;
+        return true;
+      }
+      scan_ = size_;
+    }
+    if (end_of_data_) {
+      if (start_ == size_) {
+        return false;
+      }
+      // The last argument does not need to be terminated by a delimiter.
+      arg = {block_ + start_, size_ - start_};
+      start_ = size_;
+      return true;
+    }
+    if (!read) {
+      return false;
+    }
+    Fill();
+  }
+}
+
+void ArgumentStream::Fill() {
+  if (size_ == capacity_) {
+    // Start a new block, moving the partial argument at the end of the current
+    // one to its beginning. The block is made big enough to leave room for
+    // more data, even if the argument is very long.
+    const auto partial = size_ - start_;
+    capacity_ = std::max(BLOCK_SIZE, 2 * partial);
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+    auto block = std::make_unique<char[]>(capacity_);
+    if (partial != 0) {
+      std::memcpy(block.get(), block_ + start_, partial);
+    }
+    // A block that had no arguments in it is not needed anymore.
+    if (start_ == 0 && !blocks_.empty()) {
+      blocks_.pop_back();
+    }
+    block_ = block.get();
+    blocks_.push_back(std::move(block));
+    size_ = scan_ = partial;
+    start_ = 0;
+  }
+  const auto count = source_.Read(block_ + size_, capacity_ - size_);
+  if (count == 0) {
+    end_of_data_ = true;
+  }
+  size_ += count;
+}
+
+} // namespace asap::clap::parser
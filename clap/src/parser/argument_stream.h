@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Splitting of the data read from an `ArgumentSource` into command line
+ * arguments.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "clap/argument_source.h"
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap::parser {
+
+/*!
+ * \brief Reads data from an `ArgumentSource` in large blocks and splits it
+ * into arguments, one at a time, as they are requested.
+ *
+ * Arguments are views into the blocks, which are kept for the lifetime of the
+ * `ArgumentStream` object. The data is read only once and never copied, except
+ * for an argument that straddles the end of a block, which is moved to the
+ * beginning of the next block.
+ */
+class ArgumentStream {
+public:
+  /*! \brief Size of the blocks in which the data is read. */
+  static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+  ASAP_CLAP_API explicit ArgumentStream(ArgumentSource source);
+
+  /*!
+   * \brief Extract the next argument, reading more data from the source if
+   * needed and allowed by `read`.
+   *
+   * \return *true* if an argument was extracted into `arg`, or *false* if the
+   * source has no more data, or if more data would need to be read but `read`
+   * is *false*.
+   */
+  ASAP_CLAP_API auto NextArgument(std::string_view &arg, bool read = true)
+      -> bool;
+
+private:
+  void Fill();
+
+  ArgumentSource source_;
+  char delimiter_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // The block currently being filled and split, its capacity and the size of
+  // the data in it.
+  char *block_{nullptr};
+  std::size_t capacity_{0};
+  std::size_t size_{0};
+  // Start of the next argument, and position from which to look for its
+  // delimiter (everything between the two has already been scanned).
+  std::size_t start_{0};
+  std::size_t scan_{0};
+  bool end_of_data_{false};
+};
+
+} // namespace asap::clap::parser
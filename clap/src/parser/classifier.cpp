@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details of the command line arguments classification.
+ */
+
+#include "classifier.h"
+
+#include <array>
+#include <cstring>
+
+#include <contract/contract.h>
+
+#include "clap/debug/allocation_stats.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) ||                                  \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ASAP_CLAP_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace asap::clap::parser {
+
+namespace {
+
+/*
+ * Number of arguments checked together. It matches the width of an AVX2
+ * register, and two SSE2 registers.
+ */
+constexpr std::size_t BATCH_SIZE = 32;
+
+/*
+ * Returns a mask with bit `i` set if `first_chars[i]` is a '-' or a '\0'. Only
+ * arguments starting with a '-' (options) or empty arguments need to be looked
+ * at individually; anything else is a value.
+ */
+auto NeedsAttentionMask(const std::array<char, BATCH_SIZE> &first_chars)
+    -> std::uint32_t {
+#if defined(__AVX2__)
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  const auto chars = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i *>(first_chars.data()));
+  const auto dashes = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('-'));
+  const auto nuls = _mm256_cmpeq_epi8(chars, _mm256_setzero_si256());
+  return static_cast<std::uint32_t>(
+      _mm256_movemask_epi8(_mm256_or_si256(dashes, nuls)));
+#elif defined(ASAP_CLAP_USE_SSE2)
+  std::uint32_t mask{0};
+  for (std::size_t half = 0; half < 2; ++half) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto chars = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(first_chars.data() + half * 16));
+    const auto dashes = _mm_cmpeq_epi8(chars, _mm_set1_epi8('-'));
+    const auto nuls = _mm_cmpeq_epi8(chars, _mm_setzero_si128());
+    mask |= static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_or_si128(dashes, nuls)))
+            << (half * 16);
+  }
+  return mask;
+#else
+  std::uint32_t mask{0};
+  for (std::size_t index = 0; index < BATCH_SIZE; ++index) {
+    const auto first_char = first_chars[index];
+    if (first_char == '-' || first_char == '\0') {
+      mask |= (std::uint32_t{1} << index);
+    }
+  }
+  return mask;
+#endif
+}
+
+auto FindEqualSign(std::string_view arg) -> std::uint32_t {
+  // The long option name always has at least one character (even if that
+  // character is an '=' sign), so the search starts after it.
+  constexpr std::size_t search_start = 3;
+  if (arg.size() <= search_start) {
+    return ArgumentsClassification::NO_EQUAL_SIGN;
+  }
+  const auto *equal_sign = static_cast<const char *>(std::memchr(
+      arg.data() + search_start, '=', arg.size() - search_start));
+  if (equal_sign == nullptr) {
+    return ArgumentsClassification::NO_EQUAL_SIGN;
+  }
+  return static_cast<std::uint32_t>(equal_sign - arg.data());
+}
+
+void ClassifyOne(std::string_view arg, TokenType &type, std::uint32_t &equal) {
+  equal = ArgumentsClassification::NO_EQUAL_SIGN;
+  if (arg.empty()) {
+    type = TokenType::EndOfInput;
+  } else if (arg[0] != '-') {
+    type = TokenType::Value;
+  } else if (arg.size() == 1) {
+    type = TokenType::LoneDash;
+  } else if (arg[1] != '-') {
+    type = TokenType::ShortOption;
+  } else if (arg.size() == 2) {
+    type = TokenType::DashDash;
+  } else {
+    type = TokenType::LongOption;
+    equal = FindEqualSign(arg);
+  }
+}
+
+} // namespace
+
+auto ClassifyArguments(const std::vector<std::string_view> &args)
+    -> ArgumentsClassification {
+  ArgumentsClassification classification;
+  ClassifyArguments(args, 0, classification);
+  return classification;
+}
+
+void ClassifyArguments(const std::vector<std::string_view> &args,
+    std::size_t first, ArgumentsClassification &classification) {
+  ASAP_EXPECT(classification.types.size() == first);
+  ASAP_EXPECT(classification.equal_signs.size() == first);
+  const debug::PhaseScope phase{debug::ParsePhase::Tokenization};
+
+  const auto count = args.size();
+  classification.types.resize(count, TokenType::Value);
+  classification.equal_signs.resize(
+      count, ArgumentsClassification::NO_EQUAL_SIGN);
+
+  auto start = first;
+  std::array<char, BATCH_SIZE> first_chars{};
+  for (; start + BATCH_SIZE <= count; start += BATCH_SIZE) {
+    for (std::size_t index = 0; index < BATCH_SIZE; ++index) {
+      const auto &arg = args[start + index];
+      first_chars[index] = arg.empty() ? '\0' : arg.front();
+    }
+    // Arguments not in the mask are values, which is what the classification
+    // arrays were initialized with.
+    const auto mask = NeedsAttentionMask(first_chars);
+    if (mask == 0) {
+      continue;
+    }
+    for (std::size_t index = 0; index < BATCH_SIZE; ++index) {
+      if (((mask >> index) & 1U) != 0) {
+        ClassifyOne(args[start + index], classification.types[start + index],
+            classification.equal_signs[start + index]);
+      }
+    }
+  }
+  for (; start < count; ++start) {
+    ClassifyOne(args[start], classification.types[start],
+        classification.equal_signs[start]);
+  }
+}
+
+void ClassifyArgument(
+    std::string_view arg, ArgumentsClassification &classification) {
+  TokenType type{TokenType::Value};
+  std::uint32_t equal{ArgumentsClassification::NO_EQUAL_SIGN};
+  ClassifyOne(arg, type, equal);
+  classification.types.push_back(type);
+  classification.equal_signs.push_back(equal);
+}
+
+} // namespace asap::clap::parser
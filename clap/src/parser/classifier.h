@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Bulk classification of command line arguments before tokenization.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "clap/asap_clap_export.h"
+#include "token_type.h"
+
+namespace asap::clap::parser {
+
+/*!
+ * \brief The result of classifying a list of command line arguments, stored as
+ * compact parallel arrays indexed by the argument position.
+ *
+ * Each argument is classified by the type of the first token it produces:
+ *
+ * - `TokenType::Value` for arguments that do not start with '-',
+ * - `TokenType::LoneDash` for "-",
+ * - `TokenType::DashDash` for "--",
+ * - `TokenType::ShortOption` for a cluster of short options ("-abc"),
+ * - `TokenType::LongOption` for a long option, with or without a value
+ *   ("--name" or "--name=value"),
+ * - `TokenType::EndOfInput` for empty arguments, which do not produce any
+ *   token.
+ *
+ * For long options, the offset of the '=' sign separating the option name from
+ * its value is recorded as well, so that the tokenizer never needs to scan the
+ * argument characters again.
+ */
+struct ArgumentsClassification {
+  /*!
+   * \brief Marks an argument which does not have an '=' sign separating an
+   * option name from its value.
+   */
+  static constexpr std::uint32_t NO_EQUAL_SIGN =
+      std::numeric_limits<std::uint32_t>::max();
+
+  /*! \brief The class of each argument. */
+  std::vector<TokenType> types;
+  /*!
+   * \brief The offset of the first '=' sign after a long option name, or
+   * `NO_EQUAL_SIGN`.
+   */
+  std::vector<std::uint32_t> equal_signs;
+};
+
+/*!
+ * \brief Classify all the given command line arguments in a single pass.
+ *
+ * Arguments are processed in batches. The first characters of all arguments in
+ * a batch are checked together (using SSE2 or AVX2 instructions when they are
+ * available at compile time, or a scalar loop otherwise), and batches made only
+ * of plain values, which is by far the most common case for large argument
+ * lists, are classified in bulk without looking at individual arguments.
+ */
+ASAP_CLAP_API auto ClassifyArguments(const std::vector<std::string_view> &args)
+    -> ArgumentsClassification;
+
+/*!
+ * \brief Classify the arguments starting at index `first` and append their
+ * classification to `classification`.
+ *
+ * This is used to classify arguments incrementally, as they become available.
+ *
+ * \pre `classification` holds the classification of exactly `first`
+ * arguments.
+ */
+ASAP_CLAP_API void ClassifyArguments(const std::vector<std::string_view> &args,
+    std::size_t first, ArgumentsClassification &classification);
+
+/*!
+ * \brief Classify the single argument `arg` and append its classification to
+ * `classification`, without batching.
+ */
+ASAP_CLAP_API void ClassifyArgument(
+    std::string_view arg, ArgumentsClassification &classification);
+
+} // namespace asap::clap::parser
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the CommandTrie class.
+ */
+
+#include "command_trie.h"
+
+asap::clap::parser::CommandTrie::CommandTrie(const CommandsList &commands)
+    : commands_{commands}, nodes_(1) {
+  for (const auto &command : commands_) {
+    if (command->IsDefault() && default_command_ == nullptr) {
+      default_command_ = &command;
+    }
+    auto node = ROOT;
+    for (const auto &segment : command->Path()) {
+      const auto next = nodes_.size();
+      const auto child =
+          nodes_[node].children.emplace(segment, next).first->second;
+      // Adding the node may reallocate the nodes, and must come last.
+      if (child == next) {
+        nodes_.emplace_back();
+      }
+      node = child;
+    }
+    nodes_[node].command = &command;
+  }
+}
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief A trie of the commands supported by a CLI, keyed by path segment.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "clap/asap_clap_export.h"
+#include "clap/command.h"
+
+namespace asap::clap::parser {
+
+/*!
+ * \brief An immutable trie of the commands supported by a CLI, where each
+ * level is a hash map from a path segment to the next level.
+ *
+ * The trie is built once, when the CLI is built, so that identifying the
+ * command on the command line only needs one hash lookup per path segment,
+ * regardless of how many commands the CLI has, and without copying any
+ * command pointer.
+ *
+ * Nodes are identified by their index. The root node corresponds to the empty
+ * path. A node has a command if the path leading to it is the full path of a
+ * command, and has children if it is a strict prefix of the path of at least
+ * one command. Like any other command, the default command is in the trie with
+ * its path made of a single empty segment.
+ *
+ * The trie refers to the list of commands it was created from, and to the path
+ * segments of these commands, which must outlive it and must not be modified.
+ */
+class CommandTrie {
+public:
+  using NodeId = std::size_t;
+  using CommandsList = std::vector<Command::Ptr>;
+
+  /*! \brief The node corresponding to the empty command path. */
+  static constexpr NodeId ROOT = 0;
+
+  /*!
+   * \brief Build the trie for the given list of commands.
+   *
+   * If several commands have the same path, the last one in the list is the
+   * one found by the trie.
+   */
+  ASAP_CLAP_API explicit CommandTrie(const CommandsList &commands);
+
+  /*! \brief The list of commands this trie was created from. */
+  [[nodiscard]] auto Commands() const -> const CommandsList & {
+    return commands_;
+  }
+
+  /*!
+   * \brief The node reached from `node` with the given path `segment`, if
+   * any.
+   *
+   * \return `true` and sets `child` if at least one command path continues
+   * with `segment` after the path of `node`, `false` otherwise.
+   */
+  [[nodiscard]] auto FindChild(
+      NodeId node, std::string_view segment, NodeId &child) const -> bool {
+    const auto &children = nodes_[node].children;
+    const auto found = children.find(segment);
+    if (found == children.end()) {
+      return false;
+    }
+    child = found->second;
+    return true;
+  }
+
+  /*!
+   * \brief The command which full path leads to `node`, or `nullptr` if the
+   * path of `node` is only a prefix of other command paths.
+   */
+  [[nodiscard]] auto CommandAt(NodeId node) const -> const Command::Ptr * {
+    return nodes_[node].command;
+  }
+
+  /*! \brief The default command, or `nullptr` if the CLI does not have one. */
+  [[nodiscard]] auto DefaultCommand() const -> const Command::Ptr * {
+    return default_command_;
+  }
+
+private:
+  struct Node {
+    // Keys are views into the path segments of the commands.
+    std::unordered_map<std::string_view, NodeId> children;
+    // Points into the list of commands, which does not change after the trie
+    // is built.
+    const Command::Ptr *command{nullptr};
+  };
+
+  const CommandsList &commands_;
+  std::vector<Node> nodes_;
+  const Command::Ptr *default_command_{nullptr};
+};
+
+} // namespace asap::clap::parser
@@ -13,10 +13,18 @@
 
 #pragma once
 
-#include <memory>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <contract/contract.h>
 
 #include "clap/command.h"
 #include "clap/command_line_context.h"
+#include "command_trie.h"
+#include "notifications.h"
 
 namespace asap::clap::parser::detail {
 
@@ -24,15 +32,29 @@ using CommandPtr = Command::Ptr;
 using CommandsList = std::vector<CommandPtr>;
 using OptionPtr = Option::Ptr;
 
+/*!
+ * \brief What the parser knows of the values a bound option received during
+ * the current parse.
+ */
+struct BoundOccurrence {
+  /// The number of values the option received.
+  std::size_t count{0};
+  /*!
+   * \brief The token of the first value, to report a second occurrence of
+   * the option; only kept for options which are not repeatable.
+   */
+  std::string first_token;
+};
+
 /*!
  * \brief Encapsulates data needed or produced by the command line arguments
  * parser during its lifetime.
  *
  * When a command line parser is started, an instance of this `ParserContext`
- * class is created and passed to its state machine's initial state. This
- * context is then used for the lifetime of the state machine to share data and
- * results between states through the actions produced by events being handled
- * by the states.
+ * class is created and owned by the parser. All the states of the parser's
+ * state machine hold a reference to it, which remains valid for the lifetime
+ * of the state machine, and use it to share data and results between states.
+ * Transitions between states do not need to carry any data.
  *
  * Each state will explicitly document its expectations in terms of data
  * required to be present in the context and data it updates itself.
@@ -41,32 +63,15 @@ using OptionPtr = Option::Ptr;
  */
 struct ParserContext : CommandLineContext {
   /*!
-   * \brief An alias for a smart pointer to a parser context.
-   *
-   * \note The `ParserContext` is intended to be exclusively used through a
-   * shared smart pointer. Hence, its constructors are private and to make a new
-   * `ParserContext` one must use its `New()` factory method.
-   */
-  using Ptr = std::shared_ptr<ParserContext>;
-
-  /*!
-   * \brief Create an instance of the `ParserContext` class, initialized with
-   * the given list of commands.
-   *
-   * For a particular command line parser instance, one `ParserContext` used
-   * from start to finish. Only one instance is created at start, which then
-   * gets passed from state to state via action data.
+   * \brief Create a parser context, initialized with the given commands.
    *
    * \param base the base CLI context that this parser context would use to
    * initialize its base class data.
-   * \param cli_commands the list of commands
-   * supported by the CLI. \return a shared smart pointer to a new instance of
-   * `ParserContext`.
+   * \param trie the trie of the commands supported by the CLI.
    */
-  static auto New(
-      const CommandLineContext &base, const CommandsList &cli_commands) -> Ptr {
-    return std::shared_ptr<ParserContext>(
-        new ParserContext(base, cli_commands));
+  ParserContext(const CommandLineContext &base, const CommandTrie &trie)
+      : CommandLineContext(base), commands{trie.Commands()},
+        command_trie{trie}, notifications{base.notification_workers} {
   }
 
   /*!
@@ -77,14 +82,20 @@ struct ParserContext : CommandLineContext {
    * remains valid for its lifetime.
    */
   const CommandsList &commands;
+  /*!
+   * \brief The trie of the `commands`, used to identify the command on the
+   * command line with one lookup per path segment.
+   */
+  const CommandTrie &command_trie;
   /*!
    * \brief Tracks the `asap::clap::Option` object for the command line option
    * currently being parsed.
    *
    * This field is updated every time a command line argument is identified as a
-   * known option (short name, long name, lone dash or double dash).
+   * known option (short name, long name, lone dash or double dash). The option
+   * is owned by the `active_command`.
    */
-  OptionPtr active_option;
+  const Option *active_option{nullptr};
   /*!
    * \brief Tracks the flag (including the '-' or '--' for long options)
    * corresponding to the command line option currently being parsed.
@@ -93,6 +104,21 @@ struct ParserContext : CommandLineContext {
    * being parsed, refer to the `active_option` field.
    */
   std::string active_option_flag;
+  /*!
+   * \brief The binding of the `active_option` to a member of the
+   * `bound_target`, or `nullptr` if the option's values go to the option
+   * values map.
+   */
+  const ::asap::clap::detail::ValueBinding *active_binding{nullptr};
+  /*!
+   * \brief The occurrences of the bound options during this parse, indexed by
+   * the ids of the options in the option values map.
+   *
+   * Bound options do not have entries in the option values map, and this
+   * table replaces it to detect repeated and missing options. It is only
+   * filled when the parse stores values into a bound target.
+   */
+  std::vector<BoundOccurrence> bound_occurrences;
 
   /*! \brief Value tokens collected while the parser is matching commands and
    * options which do not correspond to a command path segment or an option
@@ -101,17 +127,34 @@ struct ParserContext : CommandLineContext {
    * These positional tokens will be processed all together in the order they
    * were encountered once the command line options parsing is complete.
    *
+   * The tokens are views into the command line arguments, which outlive the
+   * parser.
+   *
    * \see FinalState
    */
-  std::vector<std::string> positional_tokens;
+  std::vector<std::string_view> positional_tokens;
 
-private:
-  // Constructor is private. Use `New()` to create an instance of this class.
-  explicit ParserContext(
-      const CommandLineContext &base, const CommandsList &cli_commands)
-      : CommandLineContext(base), commands{cli_commands} {
-  }
+  /*!
+   * \brief Runs the callbacks of the options as values are accepted, and
+   * when their final values are known.
+   */
+  Notifications notifications;
 };
-using ParserContextPtr = std::shared_ptr<ParserContext>;
+
+/*!
+ * \brief The occurrences of the bound `option` during the current parse.
+ *
+ * Options are bound by the `Cli` which owns them, and always have an id in the
+ * option values map of a bound parse.
+ */
+template <typename Context>
+inline auto BoundOccurrenceOf(Context &context, const Option &option)
+    -> decltype(context.bound_occurrences.front()) {
+  const auto *ids = context.ovm.Ids();
+  ASAP_EXPECT(ids != nullptr);
+  const auto id = ids->IdOf(option);
+  ASAP_EXPECT(id < context.bound_occurrences.size());
+  return context.bound_occurrences[id];
+}
 
 } // namespace asap::clap::parser::detail
@@ -12,23 +12,33 @@
 
 #pragma once
 
+#include <string_view>
+#include <type_traits>
+
 #include "tokenizer.h"
 
 namespace asap::clap::parser::detail {
 
+/*!
+ * \brief An event corresponding to a token of the given type.
+ *
+ * The token value is a view into the command line argument it was extracted
+ * from. It must be copied if it needs to be kept beyond the lifetime of the
+ * command line arguments.
+ *
+ * Events are trivially copyable and are dispatched by value, once per token,
+ * without any allocation.
+ */
 template <TokenType type> struct TokenEvent {
-  std::string token;
-  TokenType token_type{type};
-
-  TokenEvent() = delete;
-  TokenEvent(const TokenEvent &) = default;
-  TokenEvent(TokenEvent &&) noexcept = default;
-  auto operator=(const TokenEvent &) -> TokenEvent & = delete;
-  auto operator=(TokenEvent &&) -> TokenEvent & = delete;
-  virtual ~TokenEvent() = default;
+  static constexpr TokenType token_type{type};
 
-  explicit TokenEvent(std::string token_value) : token{std::move(token_value)} {
+  explicit constexpr TokenEvent(std::string_view token_value) noexcept
+      : token{token_value} {
   }
+
+  std::string_view token;
 };
 
+static_assert(std::is_trivially_copyable_v<TokenEvent<TokenType::Value>>);
+
 } // namespace asap::clap::parser::detail
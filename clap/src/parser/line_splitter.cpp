@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details of the command line string splitter.
+ */
+
+#include "line_splitter.h"
+
+#include <cstring>
+
+#include "../detail/errors.h"
+#include "tokenizer.h"
+
+namespace asap::clap::parser {
+
+namespace {
+
+auto IsSeparator(char character) -> bool {
+  return character == ' ' || character == '\t' || character == '\n';
+}
+
+auto IsSpecial(char character) -> bool {
+  return character == '\'' || character == '"' || character == '\\';
+}
+
+// Characters that keep their special meaning after a backslash inside double
+// quotes.
+auto IsEscapableInDoubleQuotes(char character) -> bool {
+  return character == '$' || character == '`' || character == '"' ||
+         character == '\\' || character == '\n';
+}
+
+} // namespace
+
+auto LineSplitter::NextArgument(std::string_view &arg) -> bool {
+  const auto size = line_.size();
+  while (cursor_ < size) {
+    if (IsSeparator(line_[cursor_])) {
+      ++cursor_;
+    } else if (line_[cursor_] == '\\' && cursor_ + 1 < size &&
+               line_[cursor_ + 1] == '\n') {
+      // Line continuation between arguments
+      cursor_ += 2;
+    } else {
+      break;
+    }
+  }
+  if (cursor_ == size) {
+    return false;
+  }
+
+  // Most arguments do not need any unescaping and can be used as they are.
+  const auto start = cursor_;
+  while (cursor_ < size && !IsSeparator(line_[cursor_]) &&
+         !IsSpecial(line_[cursor_])) {
+    ++cursor_;
+  }
+  if (cursor_ == size || IsSeparator(line_[cursor_])) {
+    arg = line_.substr(start, cursor_ - start);
+    return true;
+  }
+  arg = UnescapeArgument(start);
+  return true;
+}
+
+auto LineSplitter::UnescapeArgument(std::size_t start) -> std::string_view {
+  if (!unescaped_) {
+    // An unescaped argument is never longer than its quoted form, so a buffer
+    // the size of the line is enough for all the arguments in it.
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+    unescaped_ = std::make_unique<char[]>(line_.size());
+  }
+  const auto unescaped_start = unescaped_size_;
+  Append(line_.substr(start, cursor_ - start));
+
+  const auto size = line_.size();
+  while (cursor_ < size && !IsSeparator(line_[cursor_])) {
+    const auto character = line_[cursor_];
+    if (character == '\\') {
+      if (cursor_ + 1 == size) {
+        throw TokenizerError(detail::MalformedCommandLine(
+            line_, "incomplete escape sequence at the end of the line"));
+      }
+      if (line_[cursor_ + 1] != '\n') {
+        Append(line_.substr(cursor_ + 1, 1));
+      }
+      cursor_ += 2;
+    } else if (character == '\'') {
+      const auto closing = line_.find('\'', cursor_ + 1);
+      if (closing == std::string_view::npos) {
+        throw TokenizerError(
+            detail::MalformedCommandLine(line_, "unterminated single quote"));
+      }
+      Append(line_.substr(cursor_ + 1, closing - cursor_ - 1));
+      cursor_ = closing + 1;
+    } else if (character == '"') {
+      ++cursor_;
+      for (;;) {
+        if (cursor_ == size) {
+          throw TokenizerError(
+              detail::MalformedCommandLine(line_, "unterminated double quote"));
+        }
+        const auto quoted = line_[cursor_];
+        if (quoted == '"') {
+          ++cursor_;
+          break;
+        }
+        if (quoted == '\\' && cursor_ + 1 < size &&
+            IsEscapableInDoubleQuotes(line_[cursor_ + 1])) {
+          if (line_[cursor_ + 1] != '\n') {
+            Append(line_.substr(cursor_ + 1, 1));
+          }
+          cursor_ += 2;
+        } else {
+          Append(line_.substr(cursor_, 1));
+          ++cursor_;
+        }
+      }
+    } else {
+      Append(line_.substr(cursor_, 1));
+      ++cursor_;
+    }
+  }
+  return {unescaped_.get() + unescaped_start,
+      unescaped_size_ - unescaped_start};
+}
+
+void LineSplitter::Append(std::string_view characters) {
+  std::memcpy(
+      unescaped_.get() + unescaped_size_, characters.data(), characters.size());
+  unescaped_size_ += characters.size();
+}
+
+} // namespace asap::clap::parser
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Splitting of a single command line string into arguments, using
+ * POSIX shell quoting rules.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap::parser {
+
+/*!
+ * \brief Splits a command line string into arguments, one at a time, as they
+ * are requested, following the POSIX shell quoting rules.
+ *
+ * Arguments are separated by spaces, tabs or new lines. Within an argument:
+ * - characters enclosed in single quotes are taken literally;
+ * - characters enclosed in double quotes are taken literally, except for a
+ *   backslash followed by `$`, `` ` ``, `"`, `\` or a new line, which escapes
+ *   that character;
+ * - outside of quotes, a backslash escapes the character following it;
+ * - an escaped new line is a line continuation and is removed.
+ *
+ * No other shell expansion (variables, globs, etc.) is done.
+ *
+ * Arguments that do not contain any quote or backslash are views into the
+ * command line string, which must outlive the splitter. The others are
+ * unescaped into a buffer owned by the splitter, which is only allocated if
+ * needed, once, for the whole command line.
+ */
+class LineSplitter {
+public:
+  ASAP_CLAP_API explicit LineSplitter(std::string_view line) : line_{line} {
+  }
+
+  /*!
+   * \brief Extract the next argument from the command line.
+   *
+   * \return *true* if an argument was extracted into `arg`, or *false* if the
+   * end of the command line has been reached.
+   *
+   * \throw TokenizerError if the command line has an unterminated quote or
+   * ends with an incomplete escape sequence.
+   */
+  ASAP_CLAP_API auto NextArgument(std::string_view &arg) -> bool;
+
+private:
+  auto UnescapeArgument(std::size_t start) -> std::string_view;
+  void Append(std::string_view characters);
+
+  std::string_view line_;
+  std::size_t cursor_{0};
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+  std::unique_ptr<char[]> unescaped_;
+  std::size_t unescaped_size_{0};
+};
+
+} // namespace asap::clap::parser
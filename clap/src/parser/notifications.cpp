@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the Notifications class.
+ */
+
+#include "notifications.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+class asap::clap::parser::NotificationWorker {
+public:
+  NotificationWorker() : thread_([this]() { Run(); }) {
+  }
+
+  NotificationWorker(const NotificationWorker &) = delete;
+  NotificationWorker(NotificationWorker &&) = delete;
+  auto operator=(const NotificationWorker &) -> NotificationWorker & = delete;
+  auto operator=(NotificationWorker &&) -> NotificationWorker & = delete;
+
+  ~NotificationWorker() {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    queued_.notify_one();
+    thread_.join();
+  }
+
+  void Post(std::function<void()> callback) {
+    {
+      const std::lock_guard<std::mutex> lock(mutex_);
+      callbacks_.push_back(std::move(callback));
+    }
+    queued_.notify_one();
+  }
+
+  // Wait until all the queued callbacks have run, and return the first
+  // exception thrown by one of them since the last call, if any.
+  auto Wait() -> std::exception_ptr {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this]() { return callbacks_.empty() && !busy_; });
+    return std::exchange(error_, nullptr);
+  }
+
+private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      queued_.wait(lock, [this]() { return stop_ || !callbacks_.empty(); });
+      // Callbacks still in the queue are run before stopping.
+      if (callbacks_.empty()) {
+        return;
+      }
+      auto callback = std::move(callbacks_.front());
+      callbacks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      std::exception_ptr error;
+      try {
+        callback();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if (error && !error_) {
+        error_ = error;
+      }
+      busy_ = false;
+      if (callbacks_.empty()) {
+        drained_.notify_all();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  // Signaled when a callback is queued, or when the worker must stop.
+  std::condition_variable queued_;
+  // Signaled when the worker has run all the queued callbacks.
+  std::condition_variable drained_;
+  std::deque<std::function<void()>> callbacks_;
+  bool busy_{false};
+  bool stop_{false};
+  std::exception_ptr error_;
+  // Started last, once the state it uses is initialized.
+  std::thread thread_;
+};
+
+auto asap::clap::parser::NotificationWorkers::Acquire() -> WorkerPtr {
+  {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      auto worker = std::move(idle_.back());
+      idle_.pop_back();
+      return worker;
+    }
+  }
+  return {
+      // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+      new NotificationWorker(),
+      // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+      [](const NotificationWorker *worker) { delete worker; }};
+}
+
+void asap::clap::parser::NotificationWorkers::Release(WorkerPtr worker) {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  idle_.push_back(std::move(worker));
+}
+
+asap::clap::parser::Notifications::Notifications(NotificationWorkers *workers)
+    : workers_{workers}, worker_{nullptr, nullptr} {
+}
+
+asap::clap::parser::Notifications::~Notifications() {
+  // A parse which ended with an exception did not wait for its callbacks.
+  // They still run before the worker goes back to the pool, but their errors
+  // are dropped, as there is nobody left to report them to.
+  if (worker_) {
+    static_cast<void>(worker_->Wait());
+    workers_->Release(std::move(worker_));
+  }
+}
+
+void asap::clap::parser::Notifications::Post(std::function<void()> callback) {
+  if (workers_ == nullptr) {
+    callback();
+    return;
+  }
+  if (!worker_) {
+    worker_ = workers_->Acquire();
+  }
+  worker_->Post(std::move(callback));
+}
+
+void asap::clap::parser::Notifications::Wait() {
+  if (!worker_) {
+    return;
+  }
+  auto error = worker_->Wait();
+  workers_->Release(std::move(worker_));
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief The queue of option value notifications produced by a parse.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap::parser {
+
+class NotificationWorker;
+
+/*!
+ * \brief The worker threads which run the option value callbacks of the
+ * parses of a CLI, reused from one parse to the next.
+ *
+ * A parse takes an idle worker from the pool when it posts its first callback,
+ * or starts a new one when all the workers are busy with concurrent parses,
+ * and gives it back once all its callbacks have run. The worker threads run
+ * until the pool is destroyed with the CLI.
+ */
+class NotificationWorkers {
+public:
+  using WorkerPtr =
+      std::unique_ptr<NotificationWorker, void (*)(const NotificationWorker *)>;
+
+  NotificationWorkers() = default;
+
+  NotificationWorkers(const NotificationWorkers &) = delete;
+  NotificationWorkers(NotificationWorkers &&) = delete;
+  auto operator=(const NotificationWorkers &) -> NotificationWorkers & = delete;
+  auto operator=(NotificationWorkers &&) -> NotificationWorkers & = delete;
+
+  ~NotificationWorkers() = default;
+
+  /*!
+   * \brief Take an idle worker, or start a new one if there is none.
+   */
+  ASAP_CLAP_API auto Acquire() -> WorkerPtr;
+
+  /*!
+   * \brief Give back a worker, which has run all its callbacks, for the next
+   * parse.
+   */
+  ASAP_CLAP_API void Release(WorkerPtr worker);
+
+private:
+  std::mutex mutex_;
+  std::vector<WorkerPtr> idle_;
+};
+
+/*!
+ * \brief Runs the option value callbacks of a parse, in the order in which
+ * the parser posts them.
+ *
+ * Without `workers`, callbacks run immediately, on the parser's thread.
+ * Otherwise, posting a callback only queues it, and the parser goes on with
+ * the next arguments while a worker from the pool runs the callbacks in the
+ * background. The worker is taken from the pool by the first posted callback,
+ * and given back by `Wait()`.
+ *
+ * The parser calls `Wait()` at the end of each parse, so that all the
+ * callbacks have run when the parse returns.
+ */
+class Notifications {
+public:
+  ASAP_CLAP_API explicit Notifications(NotificationWorkers *workers);
+
+  Notifications(const Notifications &) = delete;
+  Notifications(Notifications &&) = delete;
+  auto operator=(const Notifications &) -> Notifications & = delete;
+  auto operator=(Notifications &&) -> Notifications & = delete;
+
+  ASAP_CLAP_API ~Notifications();
+
+  [[nodiscard]] auto OnWorkerThread() const -> bool {
+    return workers_ != nullptr;
+  }
+
+  /*!
+   * \brief Run `callback`, or queue it for the worker thread.
+   */
+  ASAP_CLAP_API void Post(std::function<void()> callback);
+
+  /*!
+   * \brief Wait until all the posted callbacks have run, and give the worker
+   * back to the pool.
+   *
+   * \throws the first exception thrown by a callback on the worker thread
+   * since the last call to `Wait()`. Callbacks queued after it are still run.
+   */
+  ASAP_CLAP_API void Wait();
+
+private:
+  NotificationWorkers *workers_;
+  // Only taken from the pool when a callback is posted, so that parses which
+  // post no callbacks do not keep a worker busy.
+  NotificationWorkers::WorkerPtr worker_;
+};
+
+} // namespace asap::clap::parser
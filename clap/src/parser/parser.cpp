@@ -27,14 +27,7 @@ using asap::fsm::Status;
 using asap::fsm::Terminate;
 using asap::fsm::TerminateWithError;
 
-using asap::clap::parser::detail::DashDashState;
-using asap::clap::parser::detail::FinalState;
-using asap::clap::parser::detail::IdentifyCommandState;
 using asap::clap::parser::detail::InitialState;
-using asap::clap::parser::detail::Machine;
-using asap::clap::parser::detail::ParseLongOptionState;
-using asap::clap::parser::detail::ParseOptionsState;
-using asap::clap::parser::detail::ParseShortOptionState;
 using asap::clap::parser::detail::TokenEvent;
 
 /*!
@@ -49,18 +42,60 @@ struct Overload : Ts... {
 // template parameters out of the constructor arguments.
 template <class... Ts> Overload(Ts...) -> Overload<Ts...>;
 
+void asap::clap::parser::CmdLineParser::Reset() {
+  // Clearing keeps the memory of the containers for the next parse.
+  context_.active_option = nullptr;
+  context_.active_binding = nullptr;
+  context_.active_option_flag.clear();
+  // The table of the bound options is only needed when the parse stores into a
+  // bound target. Clearing the tokens keeps their memory for the next parse.
+  if (context_.bound_target.object != nullptr) {
+    const auto *ids = context_.ovm.Ids();
+    context_.bound_occurrences.resize(ids != nullptr ? ids->Count() : 0);
+    for (auto &occurrence : context_.bound_occurrences) {
+      occurrence.count = 0;
+      occurrence.first_token.clear();
+    }
+  }
+  context_.positional_tokens.clear();
+  machine_.TransitionTo<InitialState>().Start();
+}
+
+auto asap::clap::parser::CmdLineParser::Parse(clap::detail::BoundTarget target)
+    -> bool {
+  context_.bound_target = target;
+  return Parse();
+}
+
 auto asap::clap::parser::CmdLineParser::Parse() -> bool {
+  Reset();
+  const auto parsed = RunStateMachine();
+  // Value callbacks may still be running on the worker thread; the parse is
+  // only complete when they are all done.
+  context_.notifications.Wait();
+  return parsed;
+}
+
+auto asap::clap::parser::CmdLineParser::RunStateMachine() -> bool {
   auto &logger = asap::logging::Registry::GetLogger("CmdLineParser");
 
-  auto machine = Machine{InitialState{context_}, IdentifyCommandState{},
-      ParseOptionsState{}, ParseShortOptionState{}, ParseLongOptionState{},
-      DashDashState{}, FinalState{}};
+  // Walk the tokens by index; the tokenizer produces them as they are
+  // requested. Past the last token, the tokenizer yields EndOfInput.
+  std::size_t index = 0;
 
   bool continue_running{true};
   bool no_errors{true};
-  auto token = tokenizer_.NextToken();
-  bool reissue = false;
   do {
+    Token token;
+    try {
+      token = tokenizer_.TokenAt(index);
+    } catch (const TokenizerError &error) {
+      ASLOG_TO_LOGGER(logger, error, "{}", error.what());
+      context_.err_ << fmt::format(
+                           "{}: {}", context_.program_name_, error.what())
+                    << std::endl;
+      return false;
+    }
     const auto &[token_type, token_value] = token;
     ASLOG_TO_LOGGER(
         logger, debug, "next event: {}/{}", token.first, token.second);
@@ -70,31 +105,31 @@ auto asap::clap::parser::CmdLineParser::Parse() -> bool {
     switch (token_type) {
     case TokenType::ShortOption:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::ShortOption>{token_value});
+          machine_.Handle(TokenEvent<TokenType::ShortOption>{token_value});
       break;
     case TokenType::LongOption:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::LongOption>{token_value});
+          machine_.Handle(TokenEvent<TokenType::LongOption>{token_value});
       break;
     case TokenType::LoneDash:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::LoneDash>{token_value});
+          machine_.Handle(TokenEvent<TokenType::LoneDash>{token_value});
       break;
     case TokenType::DashDash:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::DashDash>{token_value});
+          machine_.Handle(TokenEvent<TokenType::DashDash>{token_value});
       break;
     case TokenType::EqualSign:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::EqualSign>{token_value});
+          machine_.Handle(TokenEvent<TokenType::EqualSign>{token_value});
       break;
     case TokenType::Value:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::Value>{token_value});
+          machine_.Handle(TokenEvent<TokenType::Value>{token_value});
       break;
     case TokenType::EndOfInput:
       execution_status =
-          machine.Handle(TokenEvent<TokenType::EndOfInput>{token_value});
+          machine_.Handle(TokenEvent<TokenType::EndOfInput>{token_value});
       break;
     default:
       ASAP_UNREACHABLE();
@@ -112,31 +147,27 @@ auto asap::clap::parser::CmdLineParser::Parse() -> bool {
                    [this, &continue_running, &no_errors, &logger](
                        const TerminateWithError &status) {
                      ASLOG_TO_LOGGER(logger, error, "{}", status.error_message);
-                     context_->err_
-                         << fmt::format("{}: {}", context_->program_name_,
+                     context_.err_
+                         << fmt::format("{}: {}", context_.program_name_,
                                 status.error_message)
                          << std::endl;
                      continue_running = false;
                      no_errors = false;
                    },
-                   [&continue_running, &reissue](
-                       const ReissueEvent & /*status*/) noexcept {
-                     reissue = true;
-                     continue_running = true;
+                   [](const ReissueEvent & /*status*/) noexcept {
+                     // States hand over tokens directly to the state that
+                     // handles them, and never ask for an event to be
+                     // re-issued.
+                     ASAP_UNREACHABLE();
                    },
                },
         execution_status);
 
     if (continue_running) {
-      if (reissue) {
-        reissue = false;
-        // reuse the same token again
-        ASLOG_TO_LOGGER(logger, debug, "re-issuing event({}/{}) as requested ",
-            token_type, token_value);
-      } else {
-        ASAP_ASSERT(token.first != TokenType::EndOfInput);
-        token = tokenizer_.NextToken();
-      }
+      ASAP_ASSERT(token.first != TokenType::EndOfInput);
+      ++index;
+      // Tokens before the current one will never be needed again.
+      tokenizer_.Release(index);
     }
   } while (continue_running);
   return no_errors;
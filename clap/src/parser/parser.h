@@ -15,25 +15,58 @@
 #include "clap/command.h"
 
 #include "clap/asap_clap_export.h"
+#include "command_trie.h"
 #include "context.h"
+#include "states.h"
 #include "tokenizer.h"
 
 namespace asap::clap::parser {
 
+/*!
+ * \brief Parses the tokens produced by a `Tokenizer` using the parser state
+ * machine.
+ *
+ * The parser context and the state machine are created once with the parser.
+ * `Parse()` can be called several times, for example after the tokenizer has
+ * been reset with new arguments, and reuses the memory of the states and of
+ * the context from one call to the next.
+ */
 class CmdLineParser {
 public:
-  using CommandsList = const std::vector<Command::Ptr>;
   explicit CmdLineParser(const CommandLineContext &context,
-      const Tokenizer &tokenizer, CommandsList &commands)
-      : tokenizer_(tokenizer), context_{detail::ParserContext::New(
-                                   context, commands)} {
+      const Tokenizer &tokenizer, const CommandTrie &commands)
+      : tokenizer_(tokenizer), context_{context, commands},
+        machine_{detail::InitialState{context_},
+            detail::IdentifyCommandState{context_},
+            detail::ParseOptionsState{context_},
+            detail::ParseShortOptionState{context_},
+            detail::ParseLongOptionState{context_}, detail::DashDashState{},
+            detail::FinalState{context_}} {
   }
 
+  // The states of the machine refer to the context owned by the parser.
+  CmdLineParser(const CmdLineParser &) = delete;
+  CmdLineParser(CmdLineParser &&) = delete;
+  auto operator=(const CmdLineParser &) -> CmdLineParser & = delete;
+  auto operator=(CmdLineParser &&) -> CmdLineParser & = delete;
+
+  ~CmdLineParser() = default;
+
   ASAP_CLAP_API auto Parse() -> bool;
 
+  /*!
+   * \brief Parse, storing the values of the bound options into `target`
+   * instead of the bound target of the context the parser was created with.
+   */
+  ASAP_CLAP_API auto Parse(clap::detail::BoundTarget target) -> bool;
+
 private:
+  void Reset();
+  auto RunStateMachine() -> bool;
+
   const Tokenizer &tokenizer_;
-  detail::ParserContextPtr context_;
+  detail::ParserContext context_;
+  detail::Machine machine_;
 };
 
 } // namespace asap::clap::parser
@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details of the memory mapped response files.
+ */
+
+#include "response_file.h"
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <common/compilers.h>
+
+namespace asap::clap::parser {
+
+namespace {
+
+auto IsSpace(char character) -> bool {
+  return character == ' ' || character == '\t' || character == '\n' ||
+         character == '\r' || character == '\v' || character == '\f';
+}
+
+/*
+ * Writes a character of the argument being unescaped in place. The write only
+ * happens if the output has fallen behind the input, to avoid touching (and
+ * therefore copying) pages of the mapped file that do not need to change.
+ */
+void Put(char *data, std::size_t &write, std::size_t read, char character) {
+  if (write != read) {
+    data[write] = character;
+  }
+  ++write;
+}
+
+} // namespace
+
+#if defined(_WIN32)
+
+auto ResponseFile::Open(const std::string &path)
+    -> std::unique_ptr<ResponseFile> {
+  auto *file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER file_size;
+  if (::GetFileSizeEx(file, &file_size) == 0) {
+    ::CloseHandle(file);
+    return nullptr;
+  }
+  const auto size = static_cast<std::size_t>(file_size.QuadPart);
+  if (size == 0) {
+    ::CloseHandle(file);
+    return std::unique_ptr<ResponseFile>(new ResponseFile(nullptr, 0));
+  }
+  auto *mapping =
+      ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  ::CloseHandle(file);
+  if (mapping == nullptr) {
+    return nullptr;
+  }
+  auto *data = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  ::CloseHandle(mapping);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  return std::unique_ptr<ResponseFile>(
+      new ResponseFile(static_cast<char *>(data), size));
+}
+
+ResponseFile::~ResponseFile() {
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+  }
+}
+
+#else
+
+auto ResponseFile::Open(const std::string &path)
+    -> std::unique_ptr<ResponseFile> {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+  const auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0) {
+    return nullptr;
+  }
+  struct stat file_stat {};
+  if (::fstat(file, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+    ::close(file);
+    return nullptr;
+  }
+  const auto size = static_cast<std::size_t>(file_stat.st_size);
+  if (size == 0) {
+    ::close(file);
+    return std::unique_ptr<ResponseFile>(new ResponseFile(nullptr, 0));
+  }
+  // A private writable mapping gives us copy-on-write pages, which is what
+  // allows arguments to be unescaped in place without modifying the file.
+  auto *data = ::mmap(
+      nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+  ::close(file);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  ::madvise(data, size, MADV_SEQUENTIAL);
+  return std::unique_ptr<ResponseFile>(
+      new ResponseFile(static_cast<char *>(data), size));
+}
+
+ResponseFile::~ResponseFile() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+}
+
+#endif
+
+auto ResponseFile::NextArgument(ResponseFileSyntax syntax,
+    std::string_view &arg) -> bool {
+  while (cursor_ < size_ && IsSpace(data_[cursor_])) {
+    ++cursor_;
+  }
+  if (cursor_ == size_) {
+    return false;
+  }
+  switch (syntax) {
+  case ResponseFileSyntax::Gnu:
+    arg = NextGnuArgument();
+    break;
+  case ResponseFileSyntax::Windows:
+    arg = NextWindowsArgument();
+    break;
+  default:
+    ASAP_UNREACHABLE();
+  }
+  return true;
+}
+
+auto ResponseFile::NextGnuArgument() -> std::string_view {
+  const auto start = cursor_;
+  auto write = cursor_;
+  auto read = cursor_;
+  bool single_quote{false};
+  bool double_quote{false};
+  bool backslash{false};
+  for (; read < size_; ++read) {
+    const auto character = data_[read];
+    if (backslash) {
+      backslash = false;
+      Put(data_, write, read, character);
+    } else if (character == '\\') {
+      backslash = true;
+    } else if (single_quote) {
+      if (character == '\'') {
+        single_quote = false;
+      } else {
+        Put(data_, write, read, character);
+      }
+    } else if (double_quote) {
+      if (character == '"') {
+        double_quote = false;
+      } else {
+        Put(data_, write, read, character);
+      }
+    } else if (IsSpace(character)) {
+      break;
+    } else if (character == '\'') {
+      single_quote = true;
+    } else if (character == '"') {
+      double_quote = true;
+    } else {
+      Put(data_, write, read, character);
+    }
+  }
+  cursor_ = read;
+  return {data_ + start, write - start};
+}
+
+auto ResponseFile::NextWindowsArgument() -> std::string_view {
+  const auto start = cursor_;
+  auto write = cursor_;
+  auto read = cursor_;
+  bool quoted{false};
+  while (read < size_) {
+    const auto character = data_[read];
+    if (!quoted && IsSpace(character)) {
+      break;
+    }
+    if (character == '\\') {
+      auto backslashes = read;
+      while (backslashes < size_ && data_[backslashes] == '\\') {
+        ++backslashes;
+      }
+      const auto count = backslashes - read;
+      if (backslashes < size_ && data_[backslashes] == '"') {
+        // 2n backslashes + quote -> n backslashes, and the quote is processed
+        // normally; 2n+1 backslashes + quote -> n backslashes and a literal
+        // quote.
+        for (std::size_t index = 0; index < count / 2; ++index) {
+          Put(data_, write, read + index, '\\');
+        }
+        read += count;
+        if (count % 2 == 1) {
+          Put(data_, write, read, '"');
+          ++read;
+        }
+      } else {
+        for (std::size_t index = 0; index < count; ++index) {
+          Put(data_, write, read + index, '\\');
+        }
+        read += count;
+      }
+      continue;
+    }
+    if (character == '"') {
+      if (quoted && read + 1 < size_ && data_[read + 1] == '"') {
+        Put(data_, write, read, '"');
+        read += 2;
+      } else {
+        quoted = !quoted;
+        ++read;
+      }
+      continue;
+    }
+    Put(data_, write, read, character);
+    ++read;
+  }
+  cursor_ = read;
+  return {data_ + start, write - start};
+}
+
+} // namespace asap::clap::parser
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Memory mapped response files, split lazily into command line
+ * arguments.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "clap/asap_clap_export.h"
+#include "clap/response_files.h"
+
+namespace asap::clap::parser {
+
+/*!
+ * \brief A response file, mapped in memory and split into arguments one at a
+ * time, as they are requested.
+ *
+ * The file is mapped privately (copy-on-write) so that quotes and escapes can
+ * be removed in place: the arguments are views into the mapped file contents
+ * and no copy of the file is ever made. Pages of the file are only copied by
+ * the system if an argument inside them needs to be unescaped.
+ *
+ * The arguments remain valid for the lifetime of the `ResponseFile` object.
+ */
+class ResponseFile {
+public:
+  /*!
+   * \brief Open and map the file at the given path.
+   *
+   * \return the response file, or `nullptr` if the file could not be opened or
+   * mapped.
+   */
+  ASAP_CLAP_API static auto Open(const std::string &path)
+      -> std::unique_ptr<ResponseFile>;
+
+  ResponseFile(const ResponseFile &) = delete;
+  ResponseFile(ResponseFile &&) = delete;
+  auto operator=(const ResponseFile &) -> ResponseFile & = delete;
+  auto operator=(ResponseFile &&) -> ResponseFile & = delete;
+
+  ASAP_CLAP_API ~ResponseFile();
+
+  /*!
+   * \brief Extract the next argument from the file contents, using the given
+   * quoting rules.
+   *
+   * \return *true* if an argument was extracted into `arg`, or *false* if the
+   * end of the file has been reached.
+   */
+  ASAP_CLAP_API auto NextArgument(ResponseFileSyntax syntax,
+      std::string_view &arg) -> bool;
+
+private:
+  ResponseFile(char *data, std::size_t size) : data_{data}, size_{size} {
+  }
+
+  auto NextGnuArgument() -> std::string_view;
+  auto NextWindowsArgument() -> std::string_view;
+
+  char *data_;
+  std::size_t size_;
+  std::size_t cursor_{0};
+};
+
+} // namespace asap::clap::parser
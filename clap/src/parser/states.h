@@ -12,9 +12,14 @@
 
 #pragma once
 
+#include <any>
+#include <iterator>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "clap/command.h"
+#include "clap/debug/allocation_stats.h"
 #include <common/compilers.h>
 #include <contract/contract.h>
 #include <fsm/fsm.h>
@@ -32,7 +37,6 @@ using asap::fsm::DoNothing;
 using asap::fsm::Maybe;
 using asap::fsm::On;
 using asap::fsm::OneOf;
-using asap::fsm::ReissueEvent;
 using asap::fsm::ReportError;
 using asap::fsm::StateMachine;
 using asap::fsm::Status;
@@ -57,11 +61,49 @@ using Machine =
     StateMachine<InitialState, IdentifyCommandState, ParseOptionsState,
         ParseShortOptionState, ParseLongOptionState, DashDashState, FinalState>;
 
+/*!
+ * \brief The state handling a token of the given type once the parser is
+ * parsing the options of the active command.
+ *
+ * States handing over to options parsing transition directly to the state
+ * that handles the current token, so that the token does not need to be
+ * dispatched a second time. Only value tokens, which may be positional
+ * arguments, are handled by the `ParseOptionsState` itself.
+ */
+template <TokenType token_type> struct OptionsParsingState {
+  using type = ParseOptionsState;
+};
+template <> struct OptionsParsingState<TokenType::ShortOption> {
+  using type = ParseShortOptionState;
+};
+template <> struct OptionsParsingState<TokenType::LoneDash> {
+  using type = ParseShortOptionState;
+};
+template <> struct OptionsParsingState<TokenType::LongOption> {
+  using type = ParseLongOptionState;
+};
+template <> struct OptionsParsingState<TokenType::DashDash> {
+  using type = DashDashState;
+};
+template <> struct OptionsParsingState<TokenType::EndOfInput> {
+  using type = FinalState;
+};
+
+/*!
+ * \brief The transition to the state handling a token of the given type once
+ * the parser is parsing the options of the active command.
+ */
+template <TokenType token_type>
+using TransitionToOptionsParsing =
+    TransitionTo<typename OptionsParsingState<token_type>::type>;
+
 /*!
  * \brief The initial state of the parser's state machine.
  *
  * When the parser is created, its starting state is automatically set to the
- * `InitialState` created with the list of commands supported by the CLI.
+ * `InitialState` created with the parser context, which holds the list of
+ * commands supported by the CLI. The parser goes back to this state, and
+ * calls `Start()`, at the beginning of each parse.
  *
  * **Parser context**:
  *
@@ -70,14 +112,14 @@ using Machine =
  *
  * **Transitions**:
  *
- * - ParseOptionsState:
- *   - if the current token is a `TokenType::Value` and it does not match the
- *     initial segment of any of the supported commands.
- *   - if the current token is a `TokenType::ShortOption` or
- *     `TokenType::LongOption` or `TokenType::LoneDash` and the CLI has a
- *     default command.
+ * - ParseOptionsState: if the current token is a `TokenType::Value` and it
+ *   does not match the initial segment of any of the supported commands.
  * - IdentifyCommandState: if the current token is a `TokenType::Value` and it
  *   matches the initial segment of one of the supported commands.
+ * - ParseShortOptionState: if the current token is a `TokenType::ShortOption`
+ *   or `TokenType::LoneDash` and the CLI has a default command.
+ * - ParseLongOptionState: if the current token is a `TokenType::LongOption`
+ *   and the CLI has a default command.
  * - DashDashState: if the current token is a `TokenType::DashDash` and the CLI
  *   has a default command.
  * - FinalState: if the current token is a `TokenType::EndOfInput` and the CLI
@@ -93,13 +135,23 @@ using Machine =
  */
 struct InitialState {
 
-  explicit InitialState(ParserContextPtr context)
-      : context_{std::move(context)} {
-    for (const auto &command : context_->commands) {
-      if (command->IsDefault()) {
-        context_->active_command = command;
-        break;
-      }
+  explicit InitialState(ParserContext &context)
+      : context_{context},
+        default_command_{context.command_trie.DefaultCommand()} {
+    Start();
+  }
+
+  /*!
+   * \brief Prepare the parser context for a new parse, starting in this state.
+   *
+   * This is done when the state is created, and must be done again before
+   * reusing the state machine for another parse.
+   */
+  void Start() const {
+    if (default_command_ != nullptr) {
+      context_.active_command = *default_command_;
+    } else {
+      context_.active_command.reset();
     }
   }
 
@@ -110,52 +162,46 @@ struct InitialState {
     // we are sure this is the start of a command path. Otherwise, this can only
     // be a value, and we must have a default command.
     if (MaybeCommand(event.token)) {
-      return TransitionTo<IdentifyCommandState>(context_);
+      return TransitionTo<IdentifyCommandState>{};
     }
-    if (context_->active_command) {
-      return TransitionTo<ParseOptionsState>(context_);
+    if (context_.active_command) {
+      return TransitionTo<ParseOptionsState>{};
     }
     return ReportError(UnrecognizedCommand({event.token}));
   }
 
   auto Handle(const TokenEvent<TokenType::EndOfInput> & /*event*/)
       -> OneOf<ReportError, TransitionTo<FinalState>> {
-    if (context_->active_command) {
-      return TransitionTo<FinalState>(context_);
+    if (context_.active_command) {
+      return TransitionTo<FinalState>{};
     }
     return ReportError(MissingCommand(context_));
   }
 
   template <TokenType token_type>
   auto Handle(const TokenEvent<token_type> & /*event*/)
-      -> OneOf<TransitionTo<ParseOptionsState>, TransitionTo<FinalState>,
-          TransitionTo<DashDashState>, ReportError> {
+      -> OneOf<TransitionToOptionsParsing<token_type>, ReportError> {
     static_assert(token_type != TokenType::Value);
     // For any token type other than TokenType::Value, we require a default
     // command to be present.
-    if (context_->active_command) {
-      if constexpr (token_type == TokenType::DashDash) {
-        return TransitionTo<DashDashState>(context_);
-      } else {
-        return TransitionTo<ParseOptionsState>(context_);
-      }
+    if (context_.active_command) {
+      return TransitionToOptionsParsing<token_type>{};
     }
     return ReportError(MissingCommand(context_));
   }
 
-  [[nodiscard]] auto context() const -> const ParserContextPtr & {
+  [[nodiscard]] auto context() const -> const ParserContext & {
     return context_;
   }
 
 private:
-  [[nodiscard]] auto MaybeCommand(const std::string &token) const -> bool {
-    return std::any_of(std::cbegin(context_->commands),
-        std::cend(context_->commands), [&token](const auto &command) {
-          return (!command->Path().empty() && command->Path()[0] == token);
-        });
+  [[nodiscard]] auto MaybeCommand(std::string_view token) const -> bool {
+    CommandTrie::NodeId node{};
+    return context_.command_trie.FindChild(CommandTrie::ROOT, token, node);
   }
 
-  ParserContextPtr context_;
+  ParserContext &context_;
+  const CommandPtr *default_command_;
 };
 
 /*!
@@ -167,9 +213,8 @@ private:
  *
  * **Parser context**:
  *
- * - Upon entering, it is expected that a `ParserContext` object is passed as
- *   `data` to the `OnEnter()` handler, and that such context contains a non
- *   empty list of commands.
+ * - Upon entering, it is expected that the parser context contains a non empty
+ *   list of commands.
  * - Before leaving, this state will ensure that the context's `active_command`
  *   field contains the deepest match of a supported command if possible. For
  *   example, a command line interface that supports commands with paths `do`
@@ -188,14 +233,16 @@ private:
  * - IdentifyCommandState: as long as tokens encountered are TokenType::Value
  *   and they incrementally match path segments of known commands, the state
  *   machine will stay at the same state.
- * - ParseOptionsState: if tokens previously collected match a known command or
- *   the CLI has a default one, and the current token is not a
- *   `TokenType::EndOfInput` or `TokenType::DashDash` and will not produce a
- *   deeper match.
- * - DashDashState: if tokens previously collected match a known command or the
- *   CLI has a default one, and the current token is a `TokenType::DashDash`.
- * - FinalState: if tokens previously collected match a known command or the CLI
- *   has a default one, and the current token is a `TokenType::EndOfInput`.
+ * - Otherwise, if tokens previously collected match a known command or the CLI
+ *   has a default one, the state handling the current token while parsing
+ *   options (see `OptionsParsingState`):
+ *   - ParseOptionsState: if the current token is a `TokenType::Value` that
+ *     will not produce a deeper match.
+ *   - ParseShortOptionState: if the current token is a
+ *     `TokenType::ShortOption` or a `TokenType::LoneDash`.
+ *   - ParseLongOptionState: if the current token is a `TokenType::LongOption`.
+ *   - DashDashState: if the current token is a `TokenType::DashDash`.
+ *   - FinalState: if the current token is a `TokenType::EndOfInput`.
  *
  * **Errors**:
  *
@@ -204,35 +251,26 @@ private:
  */
 struct IdentifyCommandState {
 
-  auto OnEnter(const TokenEvent<TokenType::Value> &event, std::any data)
-      -> Status {
+  explicit IdentifyCommandState(ParserContext &context)
+      : default_command_{context.command_trie.DefaultCommand()},
+        context_{context} {
+  }
+
+  auto OnEnter(const TokenEvent<TokenType::Value> &event) -> Status {
     // Entering here, we have the assurance that the token already matches (at
-    // least partially), one of the commands. We'll now start narrowing down the
-    // matches by identifying and tracking any full match and by filtering the
-    // rest of the commands to only keep those with partial match.
-    ASAP_EXPECT(data.has_value());
-    context_ = std::any_cast<ParserContextPtr>(data);
+    // least partially), one of the commands. We'll now walk down the command
+    // trie, one path segment at a time, while tracking the deepest full match.
     ASAP_EXPECT(!Commands().empty());
 
+    // A previous parse that failed in this state did not leave it, and the
+    // state storage is reused from one parse to the next.
+    Reset();
     path_segments_.push_back(event.token);
 
-    const auto commands_begin = Commands().cbegin();
-    const auto commands_end = Commands().cend();
-    std::copy_if(commands_begin, commands_end,
-        std::back_inserter(filtered_commands_),
-        [this, &event](const CommandPtr &command) {
-          if (command->IsDefault()) {
-            default_command_ = command;
-          }
-          if (command->Path().empty() || command->Path()[0] != event.token) {
-            return false;
-          }
-          if (command->Path().size() == 1) {
-            last_matched_command_ = command;
-          }
-          return true;
-        });
-    ASAP_ENSURE(!filtered_commands_.empty());
+    const auto found = context_.command_trie.FindChild(
+        CommandTrie::ROOT, event.token, current_node_);
+    ASAP_ENSURE(found);
+    MatchCurrentNode();
     return Continue{};
   }
 
@@ -245,34 +283,20 @@ struct IdentifyCommandState {
 
   template <TokenType token_type>
   auto Handle(const TokenEvent<token_type> & /*event*/)
-      -> OneOf<TransitionTo<ParseOptionsState>, TransitionTo<DashDashState>,
-          TransitionTo<FinalState>, ReportError> {
+      -> OneOf<TransitionToOptionsParsing<token_type>, ReportError> {
     // Protect against calling `Handle` without a prior call to `Enter`
     ASAP_EXPECT(!path_segments_.empty());
 
-    if (last_matched_command_) {
-      context_->active_command = last_matched_command_;
-      switch (token_type) {
-      case TokenType::DashDash:
-        return TransitionTo<DashDashState>(context_);
-      case TokenType::EndOfInput:
-        return TransitionTo<FinalState>(context_);
-      case TokenType::LongOption:
-      case TokenType::ShortOption:
-      case TokenType::LoneDash:
-      case TokenType::Value:
-      case TokenType::EqualSign:
-        return TransitionTo<ParseOptionsState>(context_);
-      default:
-        ASAP_UNREACHABLE();
-      }
+    if (last_matched_command_ != nullptr) {
+      context_.active_command = *last_matched_command_;
+      return TransitionToOptionsParsing<token_type>{};
     }
-    if (default_command_) {
-      context_->active_command = default_command_;
-      ASAP_ASSERT(context_->positional_tokens.empty());
+    if (default_command_ != nullptr) {
+      context_.active_command = *default_command_;
+      ASAP_ASSERT(context_.positional_tokens.empty());
       std::copy(std::begin(path_segments_), std::end(path_segments_),
-          std::back_inserter(context_->positional_tokens));
-      return TransitionTo<ParseOptionsState>(context_);
+          std::back_inserter(context_.positional_tokens));
+      return TransitionToOptionsParsing<token_type>{};
     }
     return ReportError(UnrecognizedCommand(path_segments_));
   }
@@ -283,137 +307,123 @@ struct IdentifyCommandState {
     ASAP_EXPECT(!path_segments_.empty());
 
     path_segments_.push_back(event.token);
-    auto segments_count = path_segments_.size();
-    filtered_commands_.erase(
-        std::remove_if(filtered_commands_.begin(), filtered_commands_.end(),
-            [this, segments_count, &event](const CommandPtr &command) {
-              const auto &command_path = command->Path();
-              if (command_path.size() < segments_count ||
-                  command_path[segments_count - 1] != event.token) {
-                return true;
-              }
-              if (command->Path().size() == segments_count) {
-                last_matched_command_ = command;
-              }
-              return false;
-            }),
-        filtered_commands_.end());
-    if (filtered_commands_.empty()) {
-      if (!last_matched_command_) {
-        if (!default_command_) {
-          return ReportError(UnrecognizedCommand(path_segments_));
-        }
-        context_->active_command = default_command_;
-        ASAP_ASSERT(context_->positional_tokens.empty());
-        // Remove the last pushed token in the path segments as it will be
-        // transmitted to the ParseOptionsState as the next event.
-        path_segments_.pop_back();
-        std::copy(std::begin(path_segments_), std::end(path_segments_),
-            std::back_inserter(context_->positional_tokens));
-        return TransitionTo<ParseOptionsState>(context_);
+    if (context_.command_trie.FindChild(
+            current_node_, event.token, current_node_)) {
+      MatchCurrentNode();
+      return DoNothing{};
+    }
+    // No command path continues with this token.
+    if (last_matched_command_ == nullptr) {
+      if (default_command_ == nullptr) {
+        return ReportError(UnrecognizedCommand(path_segments_));
       }
-      context_->active_command = last_matched_command_;
-      return TransitionTo<ParseOptionsState>(context_);
+      context_.active_command = *default_command_;
+      ASAP_ASSERT(context_.positional_tokens.empty());
+      // Remove the last pushed token in the path segments as it will be
+      // handled by the ParseOptionsState when entering it.
+      path_segments_.pop_back();
+      std::copy(std::begin(path_segments_), std::end(path_segments_),
+          std::back_inserter(context_.positional_tokens));
+      return TransitionTo<ParseOptionsState>{};
     }
-    return DoNothing{};
+    context_.active_command = *last_matched_command_;
+    return TransitionTo<ParseOptionsState>{};
   }
 
 private:
   [[nodiscard]] auto Commands() const -> const CommandsList & {
-    return context_->commands;
+    return context_.commands;
+  }
+
+  void MatchCurrentNode() {
+    const auto *command = context_.command_trie.CommandAt(current_node_);
+    if (command != nullptr) {
+      last_matched_command_ = command;
+    }
   }
 
   void Reset() {
-    filtered_commands_.clear();
-    last_matched_command_.reset();
-    default_command_.reset();
+    current_node_ = CommandTrie::ROOT;
+    last_matched_command_ = nullptr;
     path_segments_.clear();
   }
 
-  CommandsList filtered_commands_;
-  CommandPtr last_matched_command_;
-  CommandPtr default_command_;
-  std::vector<std::string> path_segments_;
+  // The node of the command trie reached with the path segments so far. The
+  // commands are tracked by their address in the context's list of commands,
+  // which does not change during parsing, to avoid reference counting on every
+  // token.
+  CommandTrie::NodeId current_node_{CommandTrie::ROOT};
+  const CommandPtr *last_matched_command_{nullptr};
+  const CommandPtr *default_command_;
+  std::vector<std::string_view> path_segments_;
 
-  ParserContextPtr context_;
+  ParserContext &context_;
 };
 
 /*!
  * \brief The parser's state while parsing command options.
  *
- * This state is entered from the InitialState, IdentifyCommandState or
- * ParseShortOptionState with any token except a TokenType::EndOfInput token.
+ * This state is entered from the InitialState, IdentifyCommandState,
+ * ParseShortOptionState or ParseLongOptionState with a TokenType::Value token.
+ * Other tokens are directly handed over by these states to the state which
+ * handles them (see `OptionsParsingState`).
  *
  * **Parser context**:
  *
- * - Upon entering from the ParseShortOptionState state, it is expected that the
- *   existing parser context is valid. Otherwise, the parser context must be
- *   passed as data to the action transitioning into this state. It is expected
- *   that such context contains a valid `active_command`. Optionally, it may
- *   also contain values in the `positional_tokens` list.
- * - This state will add any token of type TokenType::Value it encounters to the
+ * - Upon entering, it is expected that the parser context contains a valid
+ *   `active_command`. Optionally, it may also contain values in the
  *   `positional_tokens` list.
+ * - This state will add any token of type TokenType::Value it encounters,
+ *   including the one it was entered with, to the `positional_tokens` list.
  *
  * **Transitions**:
  *
  * - ParseOptionsState: if the current token is a `TokenType::Value`, it will be
  *   added to the `positional_tokens` list and the state machine will stay at
  *   the same state.
- * - ParseShortOptionState: if the current token is a `TokenType::ShortOption`,
- *   `TokenType::LongOption` or `TokenType::LoneDash`.
+ * - ParseShortOptionState: if the current token is a `TokenType::ShortOption`
+ *   or `TokenType::LoneDash`.
+ * - ParseLongOptionState: if the current token is a `TokenType::LongOption`.
  * - DashDashState: if the current token is a `TokenType::DashDash`.
  * - FinalState: if the current token is a `TokenType::EndOfInput`.
  *
  * **Errors**:
  *
- * None.
+ * - OptionSyntaxError: if the current token is a `TokenType::EqualSign`.
  */
 struct ParseOptionsState {
 
-  template <TokenType token_type>
-  auto OnEnter(const TokenEvent<token_type> & /*event*/, std::any data)
-      -> Status {
-    if constexpr (token_type == TokenType::EndOfInput) {
-      ASAP_EXPECT("token_type != TokenType::EndOfInput" && false);
-    }
-    ASAP_EXPECT(data.has_value());
-    context_ = std::any_cast<ParserContextPtr>(data);
-    ASAP_EXPECT(context_->active_command);
-    // recycle the event that transitioned us here so that we dispatch it
-    // properly to the next state.
-    return ReissueEvent{};
+  explicit ParseOptionsState(ParserContext &context) : context_{context} {
   }
 
-  template <TokenType token_type>
-  auto OnEnter(const TokenEvent<token_type> & /*event*/) -> Status {
-    // Entering from a ParseShortOptionState, which means that must already have
-    // a valid parser context.
-    ASAP_EXPECT(context_);
-    // recycle the event that transitioned us here so that we dispatch it
-    // properly to the right event handler.
-    return ReissueEvent{};
+  auto OnEnter(const TokenEvent<TokenType::Value> &event) -> Status {
+    ASAP_EXPECT(context_.active_command);
+    // The value token that transitioned us here is handled right away, as it
+    // would have been if we were already in this state.
+    context_.positional_tokens.push_back(event.token);
+    return Continue{};
   }
 
   auto Handle(const TokenEvent<TokenType::Value> &event) -> DoNothing {
     // This may be a positional argument. Store it for later processing with the
     // rest of positional arguments.
-    context_->positional_tokens.push_back(event.token);
+    context_.positional_tokens.push_back(event.token);
     return DoNothing{};
   }
 
   auto Handle(const TokenEvent<TokenType::EndOfInput> & /*event*/)
       -> TransitionTo<FinalState> {
-    return TransitionTo<FinalState>{context_};
+    return TransitionTo<FinalState>{};
   }
 
   auto Handle(const TokenEvent<TokenType::DashDash> & /*event*/)
       -> TransitionTo<DashDashState> {
-    return TransitionTo<DashDashState>{context_};
+    return TransitionTo<DashDashState>{};
   }
 
   auto Handle(const TokenEvent<TokenType::LongOption> & /*event*/)
       -> TransitionTo<ParseLongOptionState> {
-    return TransitionTo<ParseLongOptionState>{context_};
+    return TransitionTo<ParseLongOptionState>{};
   }
 
   auto Handle(const TokenEvent<TokenType::EqualSign> & /*event*/)
@@ -426,33 +436,114 @@ struct ParseOptionsState {
       -> TransitionTo<ParseShortOptionState> {
     static_assert(token_type == TokenType::ShortOption ||
                   token_type == TokenType::LoneDash);
-    return TransitionTo<ParseShortOptionState>{context_};
+    return TransitionTo<ParseShortOptionState>{};
   }
 
 private:
-  ParserContextPtr context_;
+  ParserContext &context_;
 
   friend struct ParseOptionsStateTestData;
 };
 
-inline auto TryImplicitValue(const ParserContextPtr &context) -> bool {
-  const auto semantics = context->active_option->value_semantic();
-  std::any value;
-  std::string value_as_text;
-  if (semantics->ApplyImplicit(value, value_as_text)) {
-    context->ovm.StoreValue(
-        context->active_option->Key(), {value, value_as_text, false});
+inline void ActivateOption(ParserContext &context, const Option *option) {
+  context.active_option = option;
+  context.active_binding =
+      context.active_command->BindingOf(option, context.bound_target);
+}
+
+inline void RecordBoundOccurrence(
+    ParserContext &context, const Option &option, std::string_view token) {
+  auto &occurrence = BoundOccurrenceOf(context, option);
+  // Only the first token of an option which is not repeatable is needed, to
+  // report a second occurrence.
+  if (occurrence.count++ == 0 && !option.value_semantic()->IsRepeatable()) {
+    occurrence.first_token.assign(token);
+  }
+}
+
+/*
+ * Run `notify` with `value` on the parser's thread, or hand both over to the
+ * worker thread. The option semantics are owned by the CLI, which outlives the
+ * parse.
+ */
+inline void PostNotification(ParserContext &context,
+    const ValueSemantics &semantics,
+    void (ValueSemantics::*notify)(const std::any &) const, std::any value) {
+  if (!context.notifications.OnWorkerThread()) {
+    (semantics.*notify)(value);
+    return;
+  }
+  context.notifications.Post(
+      [&semantics, notify, value = std::move(value)]() {
+        (semantics.*notify)(value);
+      });
+}
+
+/*
+ * Notify the option, if it wants it, of a value that was just accepted and
+ * stored for it, either in the member it is bound to or in the option values
+ * map.
+ */
+inline void NotifyEachValue(ParserContext &context, const Option &option,
+    const ::asap::clap::detail::ValueBinding *binding) {
+  const auto &semantics = *option.value_semantic();
+  if (!semantics.NotifiesEachValue()) {
+    return;
+  }
+  auto value = binding != nullptr
+                   ? binding->LastValue(context.bound_target.object)
+                   : context.ovm.ValuesOf(option).back().Value();
+  PostNotification(context, semantics, &ValueSemantics::NotifyEachValue,
+      std::move(value));
+}
+
+/*
+ * Store a value for the active option, converted from `token`, either
+ * directly into the member it is bound to or into the option values map.
+ */
+inline auto StoreOptionValue(ParserContext &context, std::string_view token)
+    -> bool {
+  const auto &option = *context.active_option;
+  if (const auto *binding = context.active_binding) {
+    if (!binding->Parse(context.bound_target.object, token)) {
+      return false;
+    }
+    RecordBoundOccurrence(context, option, token);
+    NotifyEachValue(context, option, binding);
+    return true;
+  }
+  if (context.ovm.StoreValue(option, token)) {
+    NotifyEachValue(context, option, nullptr);
     return true;
   }
   return false;
 }
 
-[[nodiscard]] inline auto CheckMultipleOccurrence(
-    const ParserContextPtr &context) -> bool {
-  const auto semantics = context->active_option->value_semantic();
-  const auto occurrences =
-      context->ovm.OccurrencesOf(context->active_option->Key());
-  return (occurrences < 1 || semantics->IsRepeatable());
+inline auto TryImplicitValue(ParserContext &context) -> bool {
+  const auto &option = *context.active_option;
+  if (const auto *binding = context.active_binding) {
+    if (binding->ApplyImplicit(context.bound_target.object)) {
+      RecordBoundOccurrence(context, option, binding->ImplicitValueAsText());
+      NotifyEachValue(context, option, binding);
+      return true;
+    }
+    return false;
+  }
+  if (context.ovm.StoreImplicitValue(option)) {
+    NotifyEachValue(context, option, nullptr);
+    return true;
+  }
+  return false;
+}
+
+[[nodiscard]] inline auto CheckMultipleOccurrence(const ParserContext &context)
+    -> bool {
+  const auto &semantics = context.active_option->value_semantic();
+  const auto occurred =
+      context.active_binding != nullptr
+          ? BoundOccurrenceOf(context, *context.active_option).count > 0
+          : context.ovm.OccurrencesOf(*context.active_option) > 0;
+  return (!occurred || semantics->IsRepeatable());
 }
 
 /*!
@@ -464,9 +555,8 @@ inline auto TryImplicitValue(const ParserContextPtr &context) -> bool {
  *
  * **Parser context**:
  *
- * - Upon entering, it is expected that a `ParserContext` object is passed as
- *   `data` to the `OnEnter()` handler. It is expected that such context
- *   contains a valid `active_command`.
+ * - Upon entering, it is expected that the parser context contains a valid
+ *   `active_command`.
  * - This state will update `active_option` and `active_option_flag` fields with
  *   the option currently being parsed. Both flags are primarily used within
  *   this state but they are also used for diagnostics messages outside.
@@ -475,9 +565,10 @@ inline auto TryImplicitValue(const ParserContextPtr &context) -> bool {
  *
  * **Transitions**:
  *
- * - ParseOptionsState: immediately after taking one more token. The token is
- *   eventually processed as a value for the option (if the option can take more
- *   values).
+ * - Immediately after taking one more token, the state handling that token
+ *   while parsing options (see `OptionsParsingState`). A `TokenType::Value`
+ *   token is processed as a value for the option if the option can take more
+ *   values, otherwise it is handed over to the ParseOptionsState.
  *
  * **Errors**:
  *
@@ -488,25 +579,26 @@ inline auto TryImplicitValue(const ParserContextPtr &context) -> bool {
  * - MissingValueForOption: if the current token is not a `TokenType::Value` and
  *   the option does not have an implicit value.
  */
-struct ParseShortOptionState
-    : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
-  using Will::Handle;
+struct ParseShortOptionState {
+
+  explicit ParseShortOptionState(ParserContext &context) : context_{context} {
+  }
 
   template <TokenType token_type>
-  auto OnEnter(const TokenEvent<token_type> &event, std::any data) -> Status {
+  auto OnEnter(const TokenEvent<token_type> &event) -> Status {
     static_assert(token_type == TokenType::ShortOption ||
                   token_type == TokenType::LoneDash);
-    ASAP_EXPECT(data.has_value());
-    context_ = std::any_cast<ParserContextPtr>(data);
-    ASAP_EXPECT(context_->active_command);
+    ASAP_EXPECT(context_.active_command);
+    // Do not assume that a previous parse left this state cleanly.
+    Reset();
 
-    std::optional<OptionPtr> option;
+    const Option *option{nullptr};
     switch (token_type) {
     case TokenType::ShortOption:
       [[fallthrough]];
     case TokenType::LoneDash:
-      context_->active_option_flag = "-" + event.token;
-      option = context_->active_command->FindShortOption(event.token);
+      context_.active_option_flag.assign("-").append(event.token);
+      option = context_.active_command->FindShortOption(event.token);
       break;
     case TokenType::LongOption:
     case TokenType::DashDash:
@@ -517,10 +609,10 @@ struct ParseShortOptionState
       // See contract assertions for entering this state
       ASAP_UNREACHABLE();
     }
-    if (!option) {
+    if (option == nullptr) {
       return TerminateWithError{UnrecognizedOption(context_, event.token)};
     }
-    context_->active_option.swap(option.value());
+    ActivateOption(context_, option);
     if (!CheckMultipleOccurrence(context_)) {
       return TerminateWithError{IllegalMultipleOccurrence(context_)};
     }
@@ -531,7 +623,7 @@ struct ParseShortOptionState
   auto OnLeave(const TokenEvent<token_type> & /*event*/) -> Status {
     if (!value_) {
       if (!TryImplicitValue(context_)) {
-        const auto semantics = context_->active_option->value_semantic();
+        const auto &semantics = context_.active_option->value_semantic();
         if (semantics->IsRequired()) {
           return TerminateWithError{MissingValueForOption(context_)};
         }
@@ -542,10 +634,16 @@ struct ParseShortOptionState
     return Continue{};
   }
 
+  template <TokenType token_type>
+  auto Handle(const TokenEvent<token_type> & /*event*/)
+      -> TransitionToOptionsParsing<token_type> {
+    return TransitionToOptionsParsing<token_type>{};
+  }
+
   auto Handle(const TokenEvent<TokenType::Value> &event)
       -> OneOf<DoNothing, ReportError, TransitionTo<ParseOptionsState>> {
-    ASAP_ASSERT(context_->active_option);
-    const auto semantics = context_->active_option->value_semantic();
+    ASAP_ASSERT(context_.active_option);
+    const auto &semantics = context_.active_option->value_semantic();
     ASAP_ASSERT(semantics);
 
     // If we already accepted a value, we're done
@@ -556,10 +654,7 @@ struct ParseShortOptionState
 
     // Try the value and if it fails parsing, try the implicit value, if
     // none is available, then fail
-    std::any value;
-    if (semantics->Parse(value, event.token)) {
-      context_->ovm.StoreValue(
-          context_->active_option->Key(), {value, event.token, false});
+    if (StoreOptionValue(context_, event.token)) {
       value_ = event.token;
       return DoNothing{};
     }
@@ -575,8 +670,8 @@ private:
     value_.reset();
   }
 
-  ParserContextPtr context_;
-  std::optional<std::string> value_;
+  ParserContext &context_;
+  std::optional<std::string_view> value_;
 
   friend struct ParseShortOptionStateTestData;
 };
@@ -590,13 +685,14 @@ private:
  *
  * **Parser context**:
  *
- * - Upon entering, it is expected that a `ParserContext` object is passed as
- *   `data` to the `OnEnter()` handler. It is expected that such context
- *   contains a valid `active_command`.
+ * - Upon entering, it is expected that the parser context contains a valid
+ *   `active_command`.
  * - This state will update the context's `action_option` and
  *   `active_option_flag` fields with the option currently being parsed. Both
  *   flags are primarily used within this state but they are also used for
  *   diagnostics messages outside.
+ * - If the context allows abbreviated long options, a token which is not the
+ *   full name of an option selects the only option which name starts with it.
  * - If the parsed option takes a value and the last parsed tokens are an
  *   optional `TokenType::EqualSign` followed by a `TokenType::Value`, this
  *   state store the option value in the context.
@@ -604,34 +700,51 @@ private:
  * **Transitions**:
  *
  * - ParseLongOptionState: if the current token is a `TokenType::EqualSign`.
- * - ParseOptionsState: if the current token is not a `TokenType::EqualSign`. If
- *   that token is a `TokenType::Value` it will eventually get processed as a
- *   value for the option (if the option can take more values)
+ * - Otherwise, the state handling the current token while parsing options (see
+ *   `OptionsParsingState`). A `TokenType::Value` token is processed as a value
+ *   for the option if the option can take more values, otherwise it is handed
+ *   over to the ParseOptionsState.
  *
  * **Errors**:
  *
  * - UnrecognizedOption: if the first token provided when entering this state
  *   does not match any of the options defined for the `active_command`.
+ * - AmbiguousOption: if abbreviated long options are allowed, the first token
+ *   is not the full name of an option and it is the prefix of the names of
+ *   several options.
  * - InvalidValueForOption: if the value token failed to parse as a valid value
  *   for the option and the option does not have an implicit value.
  * - MissingValueForOption: if the current token is not a `TokenType::Value` and
  *   the option does not have an implicit value.
  */
-struct ParseLongOptionState : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
-  using Will::Handle;
+struct ParseLongOptionState {
+
+  explicit ParseLongOptionState(ParserContext &context) : context_{context} {
+  }
 
   template <TokenType token_type>
-  auto OnEnter(const TokenEvent<token_type> &event, std::any data) -> Status {
+  auto OnEnter(const TokenEvent<token_type> &event) -> Status {
     static_assert(token_type == TokenType::LongOption);
-    ASAP_EXPECT(data.has_value());
-    context_ = std::any_cast<ParserContextPtr>(data);
-    ASAP_EXPECT(context_->active_command);
+    ASAP_EXPECT(context_.active_command);
+    // Do not assume that a previous parse left this state cleanly.
+    Reset();
 
-    std::optional<OptionPtr> option;
+    const Option *option{nullptr};
     switch (token_type) {
     case TokenType::LongOption:
-      context_->active_option_flag = "--" + event.token;
-      option = context_->active_command->FindLongOption(event.token);
+      context_.active_option_flag.assign("--").append(event.token);
+      option = context_.active_command->FindLongOption(event.token);
+      if (option == nullptr && context_.allow_abbreviated_long_options) {
+        const auto [first, last] =
+            context_.active_command->FindLongOptionsByPrefix(event.token);
+        if (std::distance(first, last) > 1) {
+          return TerminateWithError{
+              AmbiguousOption(context_, event.token, first, last)};
+        }
+        if (first != last) {
+          option = *first;
+        }
+      }
       break;
     case TokenType::ShortOption:
     case TokenType::LoneDash:
@@ -643,10 +756,10 @@ struct ParseLongOptionState : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
       // See contract assertions for entering this state
       ASAP_UNREACHABLE();
     }
-    if (!option) {
+    if (option == nullptr) {
       return TerminateWithError{UnrecognizedOption(context_, event.token)};
     }
-    context_->active_option.swap(option.value());
+    ActivateOption(context_, option);
     if (!CheckMultipleOccurrence(context_)) {
       return TerminateWithError{IllegalMultipleOccurrence(context_)};
     }
@@ -657,7 +770,7 @@ struct ParseLongOptionState : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
   auto OnLeave(const TokenEvent<token_type> & /*event*/) -> Status {
     if (!value_) {
       if (!TryImplicitValue(context_)) {
-        const auto semantics = context_->active_option->value_semantic();
+        const auto &semantics = context_.active_option->value_semantic();
         if (semantics->IsRequired()) {
           return TerminateWithError{MissingValueForOption(context_)};
         }
@@ -668,10 +781,16 @@ struct ParseLongOptionState : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
     return Continue{};
   }
 
+  template <TokenType token_type>
+  auto Handle(const TokenEvent<token_type> & /*event*/)
+      -> TransitionToOptionsParsing<token_type> {
+    return TransitionToOptionsParsing<token_type>{};
+  }
+
   auto Handle(const TokenEvent<TokenType::EqualSign> & /*event*/)
       -> OneOf<DoNothing, ReportError> {
-    ASAP_ASSERT(context_->active_option);
-    const auto semantics = context_->active_option->value_semantic();
+    ASAP_ASSERT(context_.active_option);
+    const auto &semantics = context_.active_option->value_semantic();
     ASAP_ASSERT(semantics);
     after_equal_sign = true;
     return DoNothing{};
@@ -679,15 +798,15 @@ struct ParseLongOptionState : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
 
   auto Handle(const TokenEvent<TokenType::Value> &event)
       -> OneOf<DoNothing, TransitionTo<ParseOptionsState>, ReportError> {
-    ASAP_ASSERT(context_->active_option);
-    const auto semantics = context_->active_option->value_semantic();
+    ASAP_ASSERT(context_.active_option);
+    const auto &semantics = context_.active_option->value_semantic();
     ASAP_ASSERT(semantics);
 
     if (value_) {
       return TransitionTo<ParseOptionsState>{};
     }
     if (!after_equal_sign) {
-      if (!context_->allow_long_option_value_with_no_equal) {
+      if (!context_.allow_long_option_value_with_no_equal) {
         return ReportError(OptionSyntaxError(context_,
             "option name must be followed by '=' sign because this option "
             "takes a value and does not have an implicit one"));
@@ -696,10 +815,7 @@ struct ParseLongOptionState : Will<ByDefault<TransitionTo<ParseOptionsState>>> {
 
     // Try the value and if it fails parsing, try the implicit value, if
     // none is available, then fail
-    std::any value;
-    if (semantics->Parse(value, event.token)) {
-      context_->ovm.StoreValue(
-          context_->active_option->Key(), {value, event.token, false});
+    if (StoreOptionValue(context_, event.token)) {
       value_ = event.token;
       return DoNothing{};
     }
@@ -718,8 +834,8 @@ private:
     value_.reset();
   }
 
-  ParserContextPtr context_;
-  std::optional<std::string> value_;
+  ParserContext &context_;
+  std::optional<std::string_view> value_;
   bool after_equal_sign{false};
 
   friend struct ParseLongOptionStateTestData;
@@ -727,105 +843,129 @@ private:
 
 struct DashDashState : Will<ByDefault<DoNothing>> {
   using Will::Handle;
-
-  template <TokenType token_type>
-  auto OnEnter(const TokenEvent<token_type> & /*event*/, std::any data)
-      -> Status {
-    ASAP_EXPECT(data.has_value());
-    context_ = std::any_cast<ParserContextPtr>(data);
-    return Continue{};
-  }
-
-private:
-  ParserContextPtr context_;
 };
 
 struct FinalState : Will<ByDefault<DoNothing>> {
   using Will::Handle;
 
+  explicit FinalState(ParserContext &context) : context_{context} {
+  }
+
   template <TokenType token_type>
-  auto OnEnter(const TokenEvent<token_type> & /*event*/, std::any data)
-      -> Status {
-    ASAP_EXPECT(data.has_value());
-    context_ = std::any_cast<ParserContextPtr>(data);
+  auto OnEnter(const TokenEvent<token_type> & /*event*/) -> Status {
 
     // process buffered positional arguments
-    bool before_rest{true};
-    auto &positional_args = context_->positional_tokens;
-    OptionPtr rest_option{};
-    for (const auto &option : context_->active_command->PositionalArguments()) {
-      ASAP_EXPECT(option->IsPositional());
-      if (!option->IsPositionalRest()) {
-        if (before_rest) {
-          // Pick a value from positional arguments starting from the front
-          StorePositional(option, positional_args.front());
-          positional_args.erase(positional_args.begin());
+    {
+      const debug::PhaseScope phase{debug::ParsePhase::PositionalBinding};
+      bool before_rest{true};
+      auto &positional_args = context_.positional_tokens;
+      OptionPtr rest_option{};
+      for (const auto &option :
+          context_.active_command->PositionalArguments()) {
+        ASAP_EXPECT(option->IsPositional());
+        if (!option->IsPositionalRest()) {
+          if (before_rest) {
+            // Pick a value from positional arguments starting from the front
+            StorePositional(option, positional_args.front());
+            positional_args.erase(positional_args.begin());
+          } else {
+            // Pick a value from positional arguments starting from the front
+            StorePositional(option, positional_args.back());
+            positional_args.pop_back();
+          }
         } else {
-          // Pick a value from positional arguments starting from the front
-          StorePositional(option, positional_args.back());
-          positional_args.pop_back();
+          rest_option = option;
+          before_rest = false;
         }
-      } else {
-        rest_option = option;
-        before_rest = false;
       }
-    }
-    if (!positional_args.empty()) {
-      if (rest_option) {
-        // Put the rest in 'rest'
-        for (const auto &token : positional_args) {
-          StorePositional(rest_option, token);
+      if (!positional_args.empty()) {
+        if (rest_option) {
+          // Put the rest in 'rest'
+          for (const auto &token : positional_args) {
+            StorePositional(rest_option, token);
+          }
+          positional_args.clear();
+        } else {
+          return TerminateWithError{UnexpectedPositionalArguments(context_)};
         }
-        positional_args.clear();
-      } else {
-        return TerminateWithError{UnexpectedPositionalArguments(context_)};
       }
     }
 
     // Validate options
     try {
-      CheckRequiredOptions(context_->active_command->CommandOptions());
-      CheckRequiredOptions(context_->active_command->PositionalArguments());
+      CheckRequiredOptions(context_.active_command->CommandOptions());
+      CheckRequiredOptions(context_.active_command->PositionalArguments());
     } catch (std::exception &error) {
       return TerminateWithError{error.what()};
     }
 
-    // FIXME(Abdessattar) implement notifiers and store_to
+    // Now that defaults are applied, the final values are known.
+    NotifyFinalValues(context_.active_command->CommandOptions());
+    NotifyFinalValues(context_.active_command->PositionalArguments());
 
     return Terminate{};
   }
 
 private:
+  void NotifyFinalValues(const std::vector<Option::Ptr> &options) {
+    for (const auto &option : options) {
+      const auto &semantics = *option->value_semantic();
+      if (!semantics.NotifiesFinalValue()) {
+        continue;
+      }
+      if (const auto *binding = context_.active_command->BindingOf(
+              option.get(), context_.bound_target)) {
+        for (auto &value : binding->Values(context_.bound_target.object)) {
+          PostNotification(
+              context_, semantics, &ValueSemantics::Notify, std::move(value));
+        }
+      } else if (context_.ovm.HasOption(*option)) {
+        for (const auto &value : context_.ovm.ValuesOf(*option)) {
+          PostNotification(
+              context_, semantics, &ValueSemantics::Notify, value.Value());
+        }
+      }
+    }
+  }
+
   void CheckRequiredOptions(const std::vector<Option::Ptr> &options) {
     // Check if we have any required options with default values that were not
     // provided on the command line and use the defaults
     for (const auto &option : options) {
-      const auto semantics = option->value_semantic();
-      if (!context_->ovm.HasOption(option->Key())) {
-        std::any value;
-        std::string value_as_text;
-        if (!semantics->ApplyDefault(value, value_as_text)) {
-          if (option->IsRequired()) {
-            throw std::logic_error(
-                MissingRequiredOption(context_->active_command, option));
-          }
-        } else {
-          context_->ovm.StoreValue(
-              option->Key(), {value, value_as_text, false});
+      const auto *binding = context_.active_command->BindingOf(
+          option.get(), context_.bound_target);
+      if (binding != nullptr) {
+        if (BoundOccurrenceOf(context_, *option).count == 0 &&
+            !binding->ApplyDefault(context_.bound_target.object) &&
+            option->IsRequired()) {
+          throw std::logic_error(
+              MissingRequiredOption(context_.active_command, option));
         }
+        continue;
+      }
+      if (!context_.ovm.HasOption(*option) &&
+          !context_.ovm.StoreDefaultValue(*option) && option->IsRequired()) {
+        throw std::logic_error(
+            MissingRequiredOption(context_.active_command, option));
       }
     }
   }
-  void StorePositional(const OptionPtr &option, std::string token) {
-    const auto semantics = option->value_semantic();
-    ASAP_ASSERT(semantics);
-    std::any value;
-    if (semantics->Parse(value, token)) {
-      context_->ovm.StoreValue(option->Key(), {value, std::move(token), true});
+  void StorePositional(const OptionPtr &option, std::string_view token) {
+    if (const auto *binding = context_.active_command->BindingOf(
+            option.get(), context_.bound_target)) {
+      if (binding->Parse(context_.bound_target.object, token)) {
+        RecordBoundOccurrence(context_, *option, token);
+        NotifyEachValue(context_, *option, binding);
+      }
+      return;
+    }
+    ASAP_ASSERT(option->value_semantic());
+    if (context_.ovm.StoreValue(*option, token)) {
+      NotifyEachValue(context_, *option, nullptr);
     }
   }
 
-  ParserContextPtr context_;
+  ParserContext &context_;
 };
 
 } // namespace asap::clap::parser::detail
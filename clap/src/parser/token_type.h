@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Types of tokens produced by the command line arguments tokenizer.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+#include <common/compilers.h>
+#include <magic_enum.hpp>
+
+// Disable compiler and linter warnings originating from 'fmt' and for which we
+// cannot do anything.
+ASAP_DIAGNOSTIC_PUSH
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wsigned-enum-bitfield"
+#pragma clang diagnostic ignored "-Wweak-vtables"
+#pragma clang diagnostic ignored "-Wfloat-equal"
+#pragma clang diagnostic ignored "-Wswitch-enum"
+#endif
+#if defined(ASAP_GNUC_VERSION)
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+#pragma GCC diagnostic ignored "-Wswitch-default"
+#endif
+#include <fmt/core.h>
+ASAP_DIAGNOSTIC_POP
+
+#include "clap/asap_clap_export.h"
+
+namespace asap::clap::parser {
+
+/*!
+ * \brief The type of a token produced by the command line arguments
+ * tokenizer.
+ */
+enum class TokenType : std::uint8_t {
+  ShortOption,
+  LongOption,
+  LoneDash,
+  DashDash,
+  Value,
+  EqualSign,
+  EndOfInput
+};
+
+ASAP_CLAP_API auto operator<<(std::ostream &out, const TokenType &token_type)
+    -> std::ostream &;
+
+} // namespace asap::clap::parser
+
+#if !defined(DOXYGEN_DOCUMENTATION_BUILD)
+template <> struct fmt::formatter<asap::clap::parser::TokenType> {
+  template <typename ParseContext>
+  static constexpr auto parse(ParseContext &ctx) {
+    return ctx.begin();
+  }
+
+  template <typename FormatContext>
+  auto format(
+      const asap::clap::parser::TokenType &token_type, FormatContext &ctx) {
+    return fmt::format_to(ctx.out(), "{}", magic_enum::enum_name(token_type));
+  }
+};
+#endif // DOXYGEN_DOCUMENTATION_BUILD
@@ -13,20 +13,13 @@
 
 #include "tokenizer.h"
 
-#include <utility>
+#include <algorithm>
 
-#include <fsm/fsm.h>
+#include <common/compilers.h>
+#include <contract/contract.h>
 
-using asap::fsm::ByDefault;
-using asap::fsm::Continue;
-using asap::fsm::DoNothing;
-using asap::fsm::Maybe;
-using asap::fsm::On;
-using asap::fsm::OneOf;
-using asap::fsm::StateMachine;
-using asap::fsm::Status;
-using asap::fsm::TransitionTo;
-using asap::fsm::Will;
+#include "../detail/errors.h"
+#include "clap/debug/allocation_stats.h"
 
 namespace asap::clap::parser {
 
@@ -38,257 +31,263 @@ auto operator<<(std::ostream &out, const TokenType &token_type)
 
 namespace {
 
-class InputChar {
-public:
-  explicit InputChar(char character) : value{character} {
-  }
-
-  [[nodiscard]] auto Value() const -> char {
-    return value;
-  }
+// Number of arguments pulled at once from the command line, the response files
+// and the argument stream when arguments are pulled lazily.
+constexpr std::size_t PULL_BATCH_SIZE = 256;
 
-private:
-  char value;
-};
-struct InputEnd {};
-
-using TokenConsumer =
-    std::function<void(TokenType token_type, std::string token)>;
-
-struct InitialState;
-struct ValueState;
-struct OptionState;
-struct ShortOptionState;
-struct LongOptionState;
-struct DashDashState;
-struct FinalState;
-
-struct FinalState : public Will<ByDefault<DoNothing>> {
-  [[maybe_unused]] static auto OnEnter(const InputEnd & /*event*/) -> Status {
-    //    std::cout << "InputEnd -> FinalState" << std::endl;
-    return Continue{};
-  }
-};
+// Minimum number of released tokens before the tokens buffer and the
+// arguments window are compacted.
+constexpr std::size_t MIN_COMPACTION_SIZE = 4096;
 
-struct InitialState : public ByDefault<TransitionTo<FinalState>> {
-  using ByDefault::Handle;
-
-  template <typename Event>
-  static auto OnLeave(const Event & /*event*/) -> Status {
-    //    std::cout << "InitialState -> " << std::endl;
-    return Continue{};
-  }
+} // namespace
 
-  [[maybe_unused]] static auto Handle(const InputChar &event)
-      -> OneOf<TransitionTo<ValueState>, TransitionTo<OptionState>> {
-    switch (event.Value()) {
-    case '-':
-      return TransitionTo<OptionState>{};
-    default:
-      return TransitionTo<ValueState>{};
-    }
-  }
-};
+TokenizerError::~TokenizerError() = default;
 
-struct ValueState : public On<InputEnd, TransitionTo<FinalState>> {
-  using On::Handle;
+Tokenizer::Tokenizer(std::vector<std::string_view> args)
+    : args_{std::move(args)} {
+}
 
-  explicit ValueState(TokenConsumer callback)
-      : consume_token_{std::move(callback)} {
+Tokenizer::Tokenizer(std::vector<std::string_view> args,
+    std::optional<ResponseFileOptions> response_files)
+    : response_files_{response_files} {
+  if (response_files_) {
+    // Arguments will be pulled lazily, expanding response files on the way.
+    input_ = std::move(args);
+  } else {
+    args_ = std::move(args);
   }
+}
 
-  [[maybe_unused]] auto OnEnter(const InputChar &event) -> Status {
-    //    std::cout << "InputChar(" << event.Value() << ") -> ValueState" <<
-    //    std::endl;
-    token_.push_back((event.Value()));
-    return Continue{};
-  }
+Tokenizer::Tokenizer(std::vector<std::string_view> args,
+    ArgumentSource source, std::optional<ResponseFileOptions> response_files)
+    : input_{std::move(args)},
+      stream_{std::make_unique<ArgumentStream>(std::move(source))},
+      response_files_{response_files} {
+}
 
-  [[maybe_unused]] auto OnLeave(const InputEnd & /*event*/) -> Status {
-    //    std::cout << "ValueState -> " << std::endl;
-    consume_token_(TokenType::Value, token_);
-    return Continue{};
-  }
+Tokenizer::Tokenizer(std::vector<std::string_view> args, LineSplitter line,
+    std::optional<ResponseFileOptions> response_files)
+    : input_{std::move(args)}, line_{std::move(line)},
+      response_files_{response_files} {
+}
 
-  [[maybe_unused]] auto Handle(const InputChar &event) -> DoNothing {
-    token_.push_back(event.Value());
-    return DoNothing{};
+Tokenizer::~Tokenizer() = default;
+
+void Tokenizer::Reset(const std::vector<std::string_view> &args) {
+  ASAP_EXPECT(!line_ && stream_ == nullptr);
+  open_files_.clear();
+  files_.clear();
+  input_cursor_ = 0;
+  args_base_ = 0;
+  cursor_ = 0;
+  tokens_.Clear();
+  next_token_ = 0;
+  released_ = 0;
+  args_.clear();
+  classification_.types.clear();
+  classification_.equal_signs.clear();
+  if (response_files_) {
+    input_.assign(args.cbegin(), args.cend());
+  } else {
+    args_.assign(args.cbegin(), args.cend());
   }
+}
 
-private:
-  std::string token_;
-  TokenConsumer consume_token_;
-};
-
-struct OptionState {
-
-  explicit OptionState(TokenConsumer callback)
-      : consume_token_{std::move(callback)} {
+auto Tokenizer::NextToken() const -> Token {
+  const auto token = TokenAt(next_token_);
+  if (token.first != TokenType::EndOfInput) {
+    ++next_token_;
   }
+  return token;
+}
 
-  [[maybe_unused]] static auto OnEnter(const InputChar & /*event*/) -> Status {
-    //    std::cout << "InputChar(" << event.Value() << ") -> OptionState" <<
-    //    std::endl;
-    return Continue{};
-  }
+auto Tokenizer::HasMoreTokens() const -> bool {
+  return TokenAt(next_token_).first != TokenType::EndOfInput;
+}
 
-  template <typename Event>
-  static auto OnLeave(const Event & /*event*/) -> Status {
-    //    std::cout << "OptionState -> " << std::endl;
-    return Continue{};
+auto Tokenizer::TokenizeAll() const -> const TokenBuffer & {
+  const debug::PhaseScope phase{debug::ParsePhase::Tokenization};
+  if (!IsLazy()) {
+    tokens_.Reserve(tokens_.Size() + args_base_ + args_.size() - cursor_);
   }
-
-  [[maybe_unused]] auto Handle([[maybe_unused]] const InputEnd &event)
-      -> TransitionTo<FinalState> {
-    consume_token_(TokenType::LoneDash, "-");
-    return TransitionTo<FinalState>{};
+  while (TokenizeNextArgument()) {
   }
+  return tokens_;
+}
 
-  [[maybe_unused]] static auto Handle(const InputChar &event)
-      -> OneOf<TransitionTo<DashDashState>, TransitionTo<ShortOptionState>> {
-    switch (event.Value()) {
-    case '-':
-      return TransitionTo<DashDashState>{};
-    default:
-      return TransitionTo<ShortOptionState>{};
+auto Tokenizer::TokenAt(std::size_t index) const -> Token {
+  ASAP_EXPECT(index >= tokens_.Offset());
+  if (index >= tokens_.End()) {
+    const debug::PhaseScope phase{debug::ParsePhase::Tokenization};
+    while (index >= tokens_.End()) {
+      if (!TokenizeNextArgument()) {
+        return Token{TokenType::EndOfInput, {}};
+      }
     }
   }
+  const auto position = index - tokens_.Offset();
+  const auto &span = tokens_.spans_[position];
+  return Token{tokens_.types_[position],
+      args_[span.argument - args_base_].substr(span.offset, span.length)};
+}
 
-private:
-  TokenConsumer consume_token_;
-};
-
-struct ShortOptionState : public On<InputEnd, TransitionTo<FinalState>> {
-  using On::Handle;
-
-  explicit ShortOptionState(TokenConsumer callback)
-      : consume_token_{std::move(callback)} {
-  }
-
-  [[maybe_unused]] auto OnEnter(const InputChar &event) -> Status {
-    //    std::cout << "InputChar(" << event.Value() << ") -> ShortOptionState"
-    //    << std::endl;
-    consume_token_(TokenType::ShortOption, std::string{event.Value()});
-    return Continue{};
-  }
-
-  template <typename Event>
-  static auto OnLeave(const Event & /*event*/) -> Status {
-    //    std::cout << "ShortOptionState -> " << std::endl;
-    return Continue{};
-  }
+void Tokenizer::Release(std::size_t index) const {
+  ASAP_EXPECT(index <= tokens_.End());
+  released_ = std::max(released_, index);
 
-  [[maybe_unused]] auto Handle(const InputChar &event) -> DoNothing {
-    consume_token_(TokenType::ShortOption, std::string{event.Value()});
-    return DoNothing{};
+  // Compact only when a significant part of the buffer can be dropped, so
+  // that the cost of moving the remaining tokens is amortized.
+  const auto releasable = released_ - tokens_.Offset();
+  if (releasable < MIN_COMPACTION_SIZE || releasable < tokens_.Size() / 2) {
+    return;
   }
+  tokens_.DropFront(releasable);
+
+  // Arguments before the first remaining token, which have already been
+  // tokenized, are not needed anymore.
+  const auto first_needed_argument =
+      tokens_.Size() == 0
+          ? cursor_
+          : std::min<std::size_t>(tokens_.spans_.front().argument, cursor_);
+  const auto droppable = first_needed_argument - args_base_;
+  args_.erase(args_.begin(), args_.begin() + droppable);
+  classification_.types.erase(classification_.types.begin(),
+      classification_.types.begin() + droppable);
+  classification_.equal_signs.erase(classification_.equal_signs.begin(),
+      classification_.equal_signs.begin() + droppable);
+  args_base_ = first_needed_argument;
+}
 
-private:
-  TokenConsumer consume_token_;
-};
-
-struct DashDashState : On<InputChar, TransitionTo<LongOptionState>> {
-  using On::Handle;
-
-  explicit DashDashState(TokenConsumer callback)
-      : consume_token_{std::move(callback)} {
+auto Tokenizer::TokenizeNextArgument() const -> bool {
+  if (cursor_ == args_base_ + args_.size() && !PullArguments()) {
+    return false;
   }
+  Tokenize(cursor_++);
+  return true;
+}
 
-  [[maybe_unused]] static auto OnEnter(const InputChar & /*event*/) -> Status {
-    //    std::cout << "InputChar(" << event.Value() << ") -> DashDashState" <<
-    //    std::endl;
-    return Continue{};
+auto Tokenizer::PullArguments() const -> bool {
+  if (!IsLazy()) {
+    // All arguments were already placed in the window at construction.
+    return false;
   }
-
-  template <typename Event>
-  static auto OnLeave(const Event & /*event*/) -> Status {
-    //    std::cout << "DashDashState -> " << std::endl;
-    return Continue{};
+  const auto first_new = args_.size();
+  std::string_view arg;
+  // Only wait for the argument source to produce more data if no argument
+  // could be pulled yet, so that the tokens that are already available can be
+  // parsed while the rest of the input is not ready.
+  while (args_.size() - first_new < PULL_BATCH_SIZE &&
+         NextArgument(arg, args_.size() == first_new)) {
+    args_.push_back(arg);
   }
+  return args_.size() != first_new;
+}
 
-  [[maybe_unused]] auto Handle([[maybe_unused]] const InputEnd &event)
-      -> TransitionTo<FinalState> {
-    consume_token_(TokenType::DashDash, "--");
-    return TransitionTo<FinalState>{};
+auto Tokenizer::NextArgument(std::string_view &arg, bool wait) const
+    -> bool {
+  for (;;) {
+    if (!open_files_.empty()) {
+      if (!open_files_.back()->NextArgument(response_files_->syntax, arg)) {
+        open_files_.pop_back();
+        continue;
+      }
+    } else if (input_cursor_ != input_.size()) {
+      arg = input_[input_cursor_++];
+    } else if (!(line_ && line_->NextArgument(arg)) &&
+               !(stream_ && NextStreamArgument(arg, wait))) {
+      return false;
+    }
+    if (response_files_ && arg.size() > 1 && arg.front() == '@' &&
+        ExpandResponseFile(arg.substr(1))) {
+      continue;
+    }
+    return true;
   }
+}
 
-private:
-  TokenConsumer consume_token_;
-};
-
-struct LongOptionState : public On<InputEnd, TransitionTo<FinalState>> {
-  using On::Handle;
-
-  explicit LongOptionState(TokenConsumer callback)
-      : consume_token_{std::move(callback)} {
+auto Tokenizer::NextStreamArgument(std::string_view &arg, bool wait) const
+    -> bool {
+  try {
+    return stream_->NextArgument(arg, wait);
+  } catch (const std::exception &error) {
+    throw TokenizerError(detail::ArgumentSourceReadFailed(error.what()));
   }
+}
 
-  [[maybe_unused]] auto OnEnter(const InputChar &event) -> Status {
-    //    std::cout << "InputChar(" << event.Value() << ") -> LongOptionState"
-    //    << std::endl;
-    token_.push_back((event.Value()));
-    return Continue{};
+auto Tokenizer::ExpandResponseFile(std::string_view path) const -> bool {
+  auto file = ResponseFile::Open(std::string{path});
+  if (!file) {
+    // As with GCC, an argument that does not name a readable file is used
+    // literally.
+    return false;
   }
-
-  [[maybe_unused]] auto OnLeave(const InputEnd & /*event*/) -> Status {
-    //    std::cout << "LongOptionState -> " << std::endl;
-    consume_token_(TokenType::LongOption, token_);
-    return Continue{};
+  if (open_files_.size() >= response_files_->max_depth) {
+    throw TokenizerError(
+        detail::ResponseFileNestingTooDeep(path, response_files_->max_depth));
   }
+  open_files_.push_back(file.get());
+  files_.push_back(std::move(file));
+  return true;
+}
 
-  [[maybe_unused]] auto OnLeave(const InputChar & /*event*/) -> Status {
-    //    std::cout << "LongOptionState -> " << std::endl;
-    after_equal_sign = false;
-    return Continue{};
+void Tokenizer::Tokenize(std::size_t index) const {
+  const auto local_index = index - args_base_;
+  const auto arg = args_[local_index];
+  // Arguments are tokenized in order, and classified when first needed.
+  if (local_index == classification_.types.size()) {
+    if (classify_upfront_) {
+      ClassifyArguments(args_, local_index, classification_);
+    } else {
+      // Allocate once for the arguments of the window.
+      classification_.types.reserve(args_.size());
+      classification_.equal_signs.reserve(args_.size());
+      ClassifyArgument(arg, classification_);
+    }
   }
-
-  [[maybe_unused]] auto Handle(const InputChar &event)
-      -> Maybe<TransitionTo<ValueState>> {
-    switch (event.Value()) {
-    case '=':
-      consume_token_(TokenType::LongOption, token_);
-      consume_token_(TokenType::EqualSign, "=");
-      after_equal_sign = true;
+  switch (classification_.types[local_index]) {
+  case TokenType::EndOfInput:
+    // Empty arguments do not produce any token
+    break;
+
+  case TokenType::Value:
+  case TokenType::LoneDash:
+  case TokenType::DashDash:
+    tokens_.Append(classification_.types[local_index], index, 0, arg.size());
+    break;
+
+  case TokenType::ShortOption:
+    // Each character after the dash is a separate short option, including any
+    // '=' sign, which is not special in a short options cluster.
+    for (std::size_t position = 1; position < arg.size(); ++position) {
+      tokens_.Append(TokenType::ShortOption, index, position, 1);
+    }
+    break;
+
+  case TokenType::LongOption: {
+    // Anything after the first '=' sign following the option name is the
+    // value, even if it contains more '=' signs.
+    constexpr std::size_t name_start = 2;
+    const auto equal_position = classification_.equal_signs[local_index];
+    if (equal_position == ArgumentsClassification::NO_EQUAL_SIGN) {
+      tokens_.Append(
+          TokenType::LongOption, index, name_start, arg.size() - name_start);
       break;
-    default:
-      if (after_equal_sign) {
-        return TransitionTo<ValueState>{};
-      }
-      token_.push_back(event.Value());
     }
-    return DoNothing{};
+    tokens_.Append(
+        TokenType::LongOption, index, name_start, equal_position - name_start);
+    tokens_.Append(TokenType::EqualSign, index, equal_position, 1);
+    if (equal_position + 1 < arg.size()) {
+      tokens_.Append(TokenType::Value, index, equal_position + 1,
+          arg.size() - equal_position - 1);
+    }
+    break;
   }
 
-private:
-  std::string token_;
-  bool after_equal_sign{false};
-  TokenConsumer consume_token_;
-};
-
-} // namespace
-
-void Tokenizer::Tokenize(const std::string &arg) const {
-
-  const TokenConsumer consume_token = [this](TokenType token_type,
-                                          std::string token) -> void {
-    //    std::cout << "New token: " << token_type << " / " << token <<
-    //    std::endl;
-    this->tokens_.emplace_back(token_type, std::move(token));
-  };
-
-  StateMachine<InitialState, ValueState, OptionState, ShortOptionState,
-      DashDashState, LongOptionState, FinalState>
-      machine{InitialState{}, ValueState{consume_token},
-          OptionState{consume_token}, ShortOptionState{consume_token},
-          DashDashState{consume_token}, LongOptionState{consume_token},
-          FinalState{}};
-
-  auto cursor = arg.begin();
-  while (cursor != arg.end()) {
-    machine.Handle(InputChar{*cursor});
-    ++cursor;
+  case TokenType::EqualSign:
+  default:
+    // Not an argument classification
+    ASAP_UNREACHABLE();
   }
-  machine.Handle(InputEnd{});
 }
 
 } // namespace asap::clap::parser
@@ -12,54 +12,148 @@
 
 #pragma once
 
-#include <deque>
-#include <iostream>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
-#include <common/compilers.h>
-#include <magic_enum.hpp>
-
-// Disable compiler and linter warnings originating from 'fmt' and for which we
-// cannot do anything.
-ASAP_DIAGNOSTIC_PUSH
-#if defined(__clang__)
-#pragma clang diagnostic ignored "-Wsigned-enum-bitfield"
-#pragma clang diagnostic ignored "-Wweak-vtables"
-#pragma clang diagnostic ignored "-Wfloat-equal"
-#pragma clang diagnostic ignored "-Wswitch-enum"
-#endif
-#if defined(ASAP_GNUC_VERSION)
-#pragma GCC diagnostic ignored "-Wswitch-enum"
-#pragma GCC diagnostic ignored "-Wswitch-default"
-#endif
-#include <fmt/core.h>
-ASAP_DIAGNOSTIC_POP
-
+#include "argument_stream.h"
+#include "clap/argument_source.h"
 #include "clap/asap_clap_export.h"
+#include "clap/response_files.h"
+#include "classifier.h"
+#include "line_splitter.h"
+#include "response_file.h"
+#include "token_type.h"
 
 namespace asap::clap::parser {
 
-enum class TokenType {
-  ShortOption,
-  LongOption,
-  LoneDash,
-  DashDash,
-  Value,
-  EqualSign,
-  EndOfInput
+/*!
+ * \brief A token produced by the `Tokenizer`.
+ *
+ * The token value is a view into the command line argument from which it was
+ * extracted, and is only valid as long as that argument is.
+ */
+using Token = std::pair<TokenType, std::string_view>;
+
+/*!
+ * \brief Location of a token's text within the command line arguments: the
+ * index of the argument and the position of the token inside it.
+ */
+struct TokenSpan {
+  std::uint32_t argument;
+  std::uint32_t offset;
+  std::uint32_t length;
 };
 
-ASAP_CLAP_API auto operator<<(std::ostream &out, const TokenType &token_type)
-    -> std::ostream &;
+/*!
+ * \brief A contiguous buffer of tokens, stored as a struct of arrays: one
+ * array of token types and one array of spans locating the token text in the
+ * command line arguments.
+ *
+ * Tokens in the buffer are addressed by their index, which makes it trivial to
+ * look ahead or to go back to a previous token. Tokens that have been released
+ * (see Tokenizer::Release) may be removed from the front of the buffer, in
+ * which case `Offset()` gives the index of the first token still in the
+ * buffer.
+ *
+ * \see Tokenizer::TokenizeAll
+ */
+class TokenBuffer {
+public:
+  /*! \brief The number of tokens in the buffer. */
+  [[nodiscard]] auto Size() const -> std::size_t {
+    return types_.size();
+  }
+
+  /*! \brief The index of the first token in the buffer. */
+  [[nodiscard]] auto Offset() const -> std::size_t {
+    return offset_;
+  }
+
+  /*! \brief The type of each token in the buffer. */
+  [[nodiscard]] auto Types() const -> const std::vector<TokenType> & {
+    return types_;
+  }
+
+  /*! \brief The location of each token's text in the arguments. */
+  [[nodiscard]] auto Spans() const -> const std::vector<TokenSpan> & {
+    return spans_;
+  }
+
+private:
+  friend class Tokenizer;
 
-using Token = std::pair<TokenType, std::string>;
+  [[nodiscard]] auto End() const -> std::size_t {
+    return offset_ + types_.size();
+  }
+
+  void Reserve(std::size_t size) {
+    types_.reserve(size);
+    spans_.reserve(size);
+  }
+
+  void Append(TokenType type, std::size_t argument, std::size_t offset,
+      std::size_t length) {
+    types_.push_back(type);
+    spans_.push_back({static_cast<std::uint32_t>(argument),
+        static_cast<std::uint32_t>(offset),
+        static_cast<std::uint32_t>(length)});
+  }
+
+  void Clear() {
+    types_.clear();
+    spans_.clear();
+    offset_ = 0;
+  }
+
+  void DropFront(std::size_t count) {
+    types_.erase(types_.begin(), types_.begin() + count);
+    spans_.erase(spans_.begin(), spans_.begin() + count);
+    offset_ += count;
+  }
+
+  std::vector<TokenType> types_;
+  std::vector<TokenSpan> spans_;
+  std::size_t offset_{0};
+};
+
+/*!
+ * \brief An exception thrown by the `Tokenizer` when the command line
+ * arguments cannot be tokenized, for example because response files are nested
+ * too deeply.
+ */
+class TokenizerError : public std::runtime_error {
+public:
+  using runtime_error::runtime_error;
+  TokenizerError(const TokenizerError &) = default;
+  TokenizerError(TokenizerError &&) noexcept = default;
+  auto operator=(const TokenizerError &) -> TokenizerError & = default;
+  auto operator=(TokenizerError &&) noexcept -> TokenizerError & = default;
+  ASAP_CLAP_API ~TokenizerError() override;
+};
 
 /*!
  * \brief Transform a list of command line arguments into a stream of typed
  * tokens for later processing by the command line parser.
  *
+ * Tokens can be obtained one at a time with NextToken(), or by index with
+ * TokenAt(), or all at once with TokenizeAll(). In all cases, arguments are
+ * only tokenized when the tokens are requested.
+ *
+ * When response files are enabled, arguments of the form `@path` are replaced
+ * by the arguments read from the corresponding file. Response files are memory
+ * mapped and split into arguments lazily, as the tokens are requested.
+ *
+ * Arguments can also be split from a single command line string, using POSIX
+ * shell quoting rules, or streamed from an `ArgumentSource`, in which case they
+ * are read incrementally, as the tokens are requested, after the command line
+ * arguments.
+ *
  * **Example**
  *
  * \snippet tokenizer_test.cpp Tokenizer example
@@ -72,54 +166,178 @@ public:
    * When calling this from a main function with argc/argv, remove the program
    * name (argv[0]) from the command line arguments before passing the remaining
    * arguments to the tokenizer.
+   *
+   * \note The tokenizer does not copy the argument strings. Tokens it produces
+   * are views into those strings, which must outlive the tokenizer and any
+   * token obtained from it.
+   *
+   * Each argument is classified when it is first tokenized, unless bulk
+   * classification is enabled with ClassifyUpfront().
    */
-  explicit Tokenizer(std::vector<std::string> args)
-      : args_{std::move(args)}, cursor_{args_.begin()} {
-  }
+  ASAP_CLAP_API explicit Tokenizer(std::vector<std::string_view> args);
 
-  auto NextToken() const -> Token {
-    if (!tokens_.empty()) {
-      auto token = tokens_.front();
-      tokens_.pop_front();
-      return token;
-    }
-    if (cursor_ != args_.end()) {
-      const auto arg = *cursor_++;
-      Tokenize(arg);
-      if (!tokens_.empty()) {
-        auto token = tokens_.front();
-        tokens_.pop_front();
-        return token;
-      }
-    }
-    return Token{TokenType::EndOfInput, ""};
-  }
+  /*!
+   * \brief Make a tokenizer with the given command line arguments, expanding
+   * response files in them if `response_files` has a value.
+   *
+   * \note Tokens produced from the contents of a response file are views into
+   * the memory mapped file, which remains mapped as long as the tokenizer is
+   * alive.
+   */
+  ASAP_CLAP_API Tokenizer(std::vector<std::string_view> args,
+      std::optional<ResponseFileOptions> response_files);
 
-  auto HasMoreTokens() const -> bool {
-    return !tokens_.empty() || cursor_ != args_.end();
-  }
+  /*!
+   * \brief Make a tokenizer with the given command line arguments, followed by
+   * the arguments read from `source`, expanding response files in all of them
+   * if `response_files` has a value.
+   *
+   * Data is only read from the source when more tokens are needed, so that
+   * parsing can start before the source is exhausted.
+   *
+   * \note Tokens produced from the arguments read from the source are views
+   * into buffers owned by the tokenizer, and remain valid as long as the
+   * tokenizer is alive.
+   */
+  ASAP_CLAP_API Tokenizer(std::vector<std::string_view> args,
+      ArgumentSource source,
+      std::optional<ResponseFileOptions> response_files = {});
 
-private:
-  ASAP_CLAP_API void Tokenize(const std::string &arg) const;
+  /*!
+   * \brief Make a tokenizer with the given command line arguments, followed by
+   * the arguments split from a command line string, expanding response files
+   * in all of them if `response_files` has a value.
+   *
+   * The command line is split lazily, as tokens are requested, and malformed
+   * quoting is reported by throwing a TokenizerError at that time.
+   *
+   * \note Tokens produced from the command line are views into the command
+   * line string, or into a buffer owned by the tokenizer for arguments that
+   * needed to be unescaped.
+   */
+  ASAP_CLAP_API Tokenizer(std::vector<std::string_view> args, LineSplitter line,
+      std::optional<ResponseFileOptions> response_files = {});
 
-  std::vector<std::string> args_;
-  mutable std::vector<std::string>::const_iterator cursor_;
-  mutable std::deque<Token> tokens_;
-};
+  Tokenizer(const Tokenizer &) = delete;
+  Tokenizer(Tokenizer &&) noexcept = default;
+  auto operator=(const Tokenizer &) -> Tokenizer & = delete;
+  auto operator=(Tokenizer &&) noexcept -> Tokenizer & = default;
 
-} // namespace asap::clap::parser
+  ASAP_CLAP_API ~Tokenizer();
 
-#if !defined(DOXYGEN_DOCUMENTATION_BUILD)
-template <> struct fmt::formatter<asap::clap::parser::TokenType> {
-  template <typename ParseContext>
-  static constexpr auto parse(ParseContext &ctx) {
-    return ctx.begin();
+  /*!
+   * \brief Start over with a new list of command line arguments, as if the
+   * tokenizer was created again with them and with the same response files
+   * settings.
+   *
+   * The memory used by the tokenizer for the arguments, their classification
+   * and the tokens is kept and reused, which makes a tokenizer that is reset
+   * for each new command line much cheaper than a new tokenizer.
+   *
+   * \pre the tokenizer was not created with an argument source or a command
+   * line string.
+   */
+  ASAP_CLAP_API void Reset(const std::vector<std::string_view> &args);
+
+  /*!
+   * \brief Classify the arguments in bulk, before tokenizing the first of
+   * them, instead of one at a time as they are tokenized.
+   *
+   * The bulk pass (see ClassifyArguments()) checks the arguments by batches,
+   * and skips batches made only of plain values. This pays off for very long
+   * argument lists, e.g. of file paths, but the pass goes over all the
+   * arguments available, even when the parse stops at the first ones. The
+   * tokens are the same either way.
+   *
+   * The setting is kept by Reset(), and applies to the arguments which are not
+   * classified yet.
+   */
+  void ClassifyUpfront(bool enable) {
+    classify_upfront_ = enable;
   }
 
-  template <typename FormatContext>
-  auto format(
-      const asap::clap::parser::TokenType &token_type, FormatContext &ctx) {
-    return fmt::format_to(ctx.out(), "{}", magic_enum::enum_name(token_type));
+  /*!
+   * \brief Get the next token, or a `TokenType::EndOfInput` token if there are
+   * no more tokens.
+   */
+  ASAP_CLAP_API auto NextToken() const -> Token;
+
+  /*!
+   * \brief Check if there are more tokens, tokenizing more arguments (and
+   * reading from the argument source) if needed.
+   */
+  ASAP_CLAP_API auto HasMoreTokens() const -> bool;
+
+  /*!
+   * \brief Tokenize all the remaining arguments at once and get the buffer
+   * holding the tokens that have not been released yet.
+   *
+   * The returned buffer also includes tokens previously obtained with
+   * NextToken(), and remains valid for the lifetime of the tokenizer.
+   */
+  ASAP_CLAP_API auto TokenizeAll() const -> const TokenBuffer &;
+
+  /*!
+   * \brief Get the token at the given index, tokenizing more arguments if
+   * needed.
+   *
+   * \return the token at `index`, or a `TokenType::EndOfInput` token if the
+   * index is past the last token.
+   *
+   * \pre the token at `index` has not been released.
+   */
+  ASAP_CLAP_API auto TokenAt(std::size_t index) const -> Token;
+
+  /*!
+   * \brief Indicate that the tokens before the given index will not be
+   * requested anymore, so that the memory used to keep track of them can be
+   * reclaimed.
+   *
+   * This does not affect the validity of the tokens values, which are views
+   * into the arguments. It is only needed to keep the memory usage of the
+   * tokenizer constant when processing a very large number of arguments.
+   */
+  ASAP_CLAP_API void Release(std::size_t index) const;
+
+private:
+  [[nodiscard]] auto IsLazy() const -> bool {
+    return response_files_.has_value() || line_.has_value() ||
+           stream_ != nullptr;
   }
+  auto TokenizeNextArgument() const -> bool;
+  auto PullArguments() const -> bool;
+  auto NextArgument(std::string_view &arg, bool wait) const -> bool;
+  auto NextStreamArgument(std::string_view &arg, bool wait) const -> bool;
+  auto ExpandResponseFile(std::string_view path) const -> bool;
+  void Tokenize(std::size_t index) const;
+
+  // Command line arguments not yet pulled into the arguments window. Only used
+  // when arguments are pulled lazily, i.e. when response files are enabled, as
+  // arguments need to be expanded before they can be classified, or when
+  // arguments are split from a command line string or streamed from a source.
+  std::vector<std::string_view> input_;
+  mutable std::size_t input_cursor_{0};
+  mutable std::optional<LineSplitter> line_;
+  std::unique_ptr<ArgumentStream> stream_;
+  std::optional<ResponseFileOptions> response_files_;
+  // All the response files opened so far, kept mapped as tokens refer to
+  // their contents, and the stack of files currently being read.
+  mutable std::vector<std::unique_ptr<ResponseFile>> files_;
+  mutable std::vector<ResponseFile *> open_files_;
+
+  // The window of arguments being tokenized and the classification of those
+  // which were classified so far, from the start of the window.
+  // `args_base_` is the index of the first argument in the window.
+  mutable std::vector<std::string_view> args_;
+  mutable ArgumentsClassification classification_;
+  bool classify_upfront_{false};
+  mutable std::size_t args_base_{0};
+  // Index of the next argument to tokenize.
+  mutable std::size_t cursor_{0};
+
+  mutable TokenBuffer tokens_;
+  mutable std::size_t next_token_{0};
+  mutable std::size_t released_{0};
 };
-#endif // DOXYGEN_DOCUMENTATION_BUILD
+
+} // namespace asap::clap::parser
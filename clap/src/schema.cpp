@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Implementation details for the parser of compile time schemas.
+ */
+
+#include "clap/schema.h"
+#include "clap/cli.h"
+#include "clap/command.h"
+#include "clap/detail/args.h"
+#include "detail/errors.h"
+#include "parser/tokenizer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include <common/compilers.h>
+#include <contract/contract.h>
+#include <textwrap/textwrap.h>
+
+// Disable compiler and linter warnings originating from 'fmt' and for which we
+// cannot do anything.
+ASAP_DIAGNOSTIC_PUSH
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wsigned-enum-bitfield"
+#endif
+#if defined(ASAP_GNUC_VERSION)
+#pragma GCC diagnostic ignored "-Wswitch-enum"
+#pragma GCC diagnostic ignored "-Wswitch-default"
+#endif
+#include <fmt/core.h>
+ASAP_DIAGNOSTIC_POP
+
+using asap::clap::parser::TokenType;
+
+namespace asap::clap::schema::detail {
+
+namespace {
+
+// Schemas only describe the default command, which diagnostics do not
+// mention.
+constexpr std::string_view DEFAULT_COMMAND_PATH;
+
+// The token stored for a flag that appears without a value.
+constexpr std::string_view FLAG_IMPLICIT_VALUE{"true"};
+
+auto FindShort(const CommandTable &table, std::string_view name) -> OptionId {
+  if (name.size() != 1) {
+    return NO_OPTION;
+  }
+  return table.short_names[static_cast<unsigned char>(name.front())];
+}
+
+auto FindLong(const CommandTable &table, std::string_view name) -> OptionId {
+  const auto *first = table.sorted_long_names;
+  const auto *last = first + table.long_names_count;
+  const auto *found = std::lower_bound(first, last, name,
+      [&table](OptionId id, std::string_view value) {
+        return table.entries[id].long_name < value;
+      });
+  if (found == last || table.entries[*found].long_name != name) {
+    return NO_OPTION;
+  }
+  return *found;
+}
+
+/*
+ * Walks the tokens and stores the values of the options, following the same
+ * rules as the dynamic parser states: an option takes the next value token if
+ * it converts to the option's type, and otherwise falls back to its implicit
+ * value (for flags) or fails.
+ *
+ * Returns the error message if the command line is not valid.
+ */
+auto ParseTokens(const CommandTable &table, const parser::Tokenizer &tokenizer,
+    void *values, StoreValueFn store, std::string_view *seen_tokens)
+    -> std::optional<std::string> {
+  using parser::detail::IllegalMultipleOccurrence;
+  using parser::detail::MissingValueForOption;
+  using parser::detail::UnexpectedPositionalArguments;
+  using parser::detail::UnrecognizedOption;
+
+  std::vector<std::string_view> unexpected_positionals;
+  std::size_t index = 0;
+  while (true) {
+    const auto [token_type, token_value] = tokenizer.TokenAt(index++);
+    // As with the dynamic parser, what follows `--` is not parsed.
+    if (token_type == TokenType::EndOfInput ||
+        token_type == TokenType::DashDash) {
+      break;
+    }
+    if (token_type == TokenType::Value) {
+      if (table.positional == NO_OPTION) {
+        unexpected_positionals.push_back(token_value);
+      } else {
+        // Positional values that fail to convert are dropped, as they are by
+        // the dynamic parser.
+        store(values, table.positional, token_value);
+      }
+      continue;
+    }
+    ASAP_ASSERT(token_type != TokenType::EqualSign);
+
+    const auto is_long = (token_type == TokenType::LongOption);
+    const auto id = is_long ? FindLong(table, token_value)
+                            : FindShort(table, token_value);
+    if (id == NO_OPTION) {
+      return UnrecognizedOption(DEFAULT_COMMAND_PATH, token_value);
+    }
+    const auto &entry = table.entries[id];
+    // The flag, as it appeared on the command line, is only needed for
+    // diagnostics.
+    const auto flag = [is_long, token_value = token_value]() {
+      return std::string(is_long ? "--" : "-").append(token_value);
+    };
+    if (!entry.repeatable && !seen_tokens[id].empty()) {
+      return IllegalMultipleOccurrence(
+          DEFAULT_COMMAND_PATH, entry.key, flag(), seen_tokens[id]);
+    }
+
+    auto next = tokenizer.TokenAt(index);
+    auto after_equal_sign = false;
+    if (next.first == TokenType::EqualSign) {
+      after_equal_sign = true;
+      next = tokenizer.TokenAt(++index);
+    }
+    if (next.first == TokenType::Value && store(values, id, next.second)) {
+      seen_tokens[id] = next.second;
+      ++index;
+      continue;
+    }
+    // A value given with '=' must be valid; otherwise the value token, if
+    // any, is left to be parsed as a positional argument.
+    const auto has_invalid_value =
+        after_equal_sign && next.first == TokenType::Value;
+    if (!entry.is_flag || has_invalid_value) {
+      return MissingValueForOption(DEFAULT_COMMAND_PATH, entry.key, flag());
+    }
+    store(values, id, FLAG_IMPLICIT_VALUE);
+    seen_tokens[id] = FLAG_IMPLICIT_VALUE;
+  }
+
+  if (!unexpected_positionals.empty()) {
+    return UnexpectedPositionalArguments(
+        DEFAULT_COMMAND_PATH, unexpected_positionals);
+  }
+  return std::nullopt;
+}
+
+auto MakeWrapper(unsigned int width) -> wrap::TextWrapper {
+  return wrap::TextWrapper::Create()
+      .Width(width)
+      .CollapseWhiteSpace()
+      .TrimLines()
+      .IndentWith()
+      .Initially("   ")
+      .Then("   ");
+}
+
+void PrintValueDescription(
+    std::ostream &out, const OptionEntry &entry, const char *separator) {
+  if (!entry.is_flag) {
+    out << separator << "<" << entry.user_friendly_name << ">";
+    if (entry.repeatable) {
+      out << "...";
+    }
+  }
+  out << "\n";
+}
+
+void PrintSynopsis(std::ostream &out, const CommandTable &table,
+    std::string_view program_name) {
+  // Same layout as `Command::PrintSynopsis()` for the default command, which
+  // has an empty path.
+  out << program_name << "  [-h,--help] ";
+  for (std::size_t id = 0; id < table.size; ++id) {
+    const auto &entry = table.entries[id];
+    if (entry.positional) {
+      continue;
+    }
+    out << (entry.is_flag ? "[" : "");
+    if (!entry.short_name.empty()) {
+      out << "-" << entry.short_name;
+      if (!entry.long_name.empty()) {
+        out << ",";
+      }
+    }
+    if (!entry.long_name.empty()) {
+      out << "--" << entry.long_name;
+    }
+    out << (entry.is_flag ? "] " : " ");
+  }
+  if (table.positional != NO_OPTION) {
+    out << "[<" << table.entries[table.positional].user_friendly_name << ">]";
+  }
+}
+
+} // namespace
+
+auto HandleProgramRequest(const ProgramInfo &program, const CommandTable &table,
+    int argc, const char **argv) -> ProgramRequest {
+  if (argc < 2) {
+    return ProgramRequest::Parse;
+  }
+  const std::string_view first{argv[1]};
+  const auto is_short_name_free = [&table](char name) {
+    return table.short_names[static_cast<unsigned char>(name)] == NO_OPTION;
+  };
+  const CliView view{program, table};
+  if (first == Command::HELP || first == Command::HELP_LONG ||
+      (first == Command::HELP_SHORT && is_short_name_free('h'))) {
+    view.PrintHelp(std::cout, argv[0]);
+    return ProgramRequest::Help;
+  }
+  if (first == Command::VERSION || first == Command::VERSION_LONG ||
+      (first == Command::VERSION_SHORT && is_short_name_free('v'))) {
+    view.PrintVersion(std::cout, argv[0]);
+    return ProgramRequest::Version;
+  }
+  return ProgramRequest::Parse;
+}
+
+void ParseCommandLine(const CommandTable &table, const ProgramInfo *program,
+    int argc, const char **argv, void *values, StoreValueFn store,
+    std::string_view *seen_tokens) {
+  const clap::detail::Arguments cla{argc, argv};
+  const std::string_view program_name =
+      (program != nullptr && !program->name.empty()) ? program->name
+                                                      : cla.ProgramName();
+  std::optional<std::string> error;
+  try {
+    const parser::Tokenizer tokenizer{std::move(cla.Args())};
+    error = ParseTokens(table, tokenizer, values, store, seen_tokens);
+  } catch (const parser::TokenizerError &tokenizer_error) {
+    error = tokenizer_error.what();
+  }
+  if (!error) {
+    return;
+  }
+  std::cerr << fmt::format("{}: {}", program_name, *error) << std::endl;
+  if (program != nullptr) {
+    std::cout << fmt::format(
+                     "Try '{} --help' for more information.", program_name)
+              << std::endl;
+  }
+  throw CmdLineArgumentsError(
+      fmt::format("command line arguments parsing failed, try '{} --help' for "
+                  "more information.",
+          program_name));
+}
+
+} // namespace asap::clap::schema::detail
+
+namespace asap::clap::schema {
+
+void CliView::PrintHelp(std::ostream &out, std::string_view program_name,
+    unsigned int width) const {
+  if (!program_.name.empty()) {
+    program_name = program_.name;
+  }
+  const auto wrap = detail::MakeWrapper(width);
+  std::ostringstream ostr;
+
+  out << "SYNOPSIS\n";
+  detail::PrintSynopsis(ostr, table_, program_name);
+  out << wrap.Fill(ostr.str()).value();
+  out << "\n\n";
+
+  out << "DESCRIPTION\n";
+  out << wrap.Fill(std::string{program_.about}).value();
+  out << "\n\n";
+
+  out << "OPTIONS\n";
+  out << "   -h\n   --help\n"
+      << wrap.Fill("Display detailed help information.").value() << "\n\n";
+  for (std::size_t id = 0; id < table_.size; ++id) {
+    const auto &entry = table_.entries[id];
+    if (entry.positional) {
+      continue;
+    }
+    if (!entry.short_name.empty()) {
+      out << "   -" << entry.short_name;
+      detail::PrintValueDescription(out, entry, " ");
+    }
+    if (!entry.long_name.empty()) {
+      out << "   --" << entry.long_name;
+      detail::PrintValueDescription(out, entry, "=");
+    }
+    out << wrap.Fill(std::string{entry.about}).value() << "\n\n";
+  }
+  if (table_.positional != detail::NO_OPTION) {
+    const auto &entry = table_.entries[table_.positional];
+    out << "   [<" << entry.user_friendly_name << ">]\n"
+        << wrap.Fill(std::string{entry.about}).value() << "\n\n";
+  }
+}
+
+void CliView::PrintVersion(
+    std::ostream &out, std::string_view program_name) const {
+  if (!program_.name.empty()) {
+    program_name = program_.name;
+  }
+  out << fmt::format("{} version {}\n", program_name, program_.version)
+      << std::endl;
+}
+
+} // namespace asap::clap::schema
@@ -0,0 +1,204 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/debug/allocation_stats.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <magic_enum.hpp>
+
+#include "clap/cli.h"
+#include "clap/command_line_context.h"
+#include "clap/fluent/dsl.h"
+#include "clap/parse_session.h"
+#include "clap/schema.h"
+
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Le;
+
+namespace asap::clap::debug {
+
+namespace {
+
+// NOLINTNEXTLINE
+TEST(AllocationStatsTest, PhaseScopesNest) {
+  EXPECT_THAT(CurrentPhase(), Eq(ParsePhase::None));
+  {
+    const PhaseScope parsing{ParsePhase::Parsing};
+    EXPECT_THAT(CurrentPhase(), Eq(ParsePhase::Parsing));
+    {
+      const PhaseScope storage{ParsePhase::ValueStorage};
+      EXPECT_THAT(CurrentPhase(), Eq(ParsePhase::ValueStorage));
+    }
+    EXPECT_THAT(CurrentPhase(), Eq(ParsePhase::Parsing));
+  }
+  EXPECT_THAT(CurrentPhase(), Eq(ParsePhase::None));
+}
+
+// NOLINTNEXTLINE
+TEST(AllocationStatsTest, AllocationsAreCountedInTheCurrentPhase) {
+  ResetAllocationStats();
+  {
+    const PhaseScope parsing{ParsePhase::Parsing};
+    // Calls to `operator new`, unlike new expressions, are never elided.
+    void *memory = ::operator new(100);
+    ::operator delete(memory);
+  }
+  const auto stats = GetAllocationStats();
+  EXPECT_THAT(stats.Of(ParsePhase::Parsing).allocations, Eq(1));
+  EXPECT_THAT(stats.Of(ParsePhase::Parsing).bytes, Eq(100));
+  EXPECT_THAT(stats.Total().allocations, Eq(1));
+
+  ResetAllocationStats();
+  EXPECT_THAT(GetAllocationStats().Total().allocations, Eq(0));
+}
+
+// NOLINTNEXTLINE
+TEST(AllocationStatsTest, AlignedAllocationsAreCounted) {
+  ResetAllocationStats();
+  {
+    const PhaseScope parsing{ParsePhase::Parsing};
+    constexpr std::align_val_t alignment{64};
+    void *memory = ::operator new(100, alignment);
+    EXPECT_THAT(reinterpret_cast<std::uintptr_t>(memory) % 64, Eq(0));
+    ::operator delete(memory, alignment);
+  }
+  EXPECT_THAT(GetAllocationStats().Of(ParsePhase::Parsing).allocations, Eq(1));
+}
+
+/*
+ * Allocation budgets, per phase, of a steady state parse of the fixed command
+ * line below. Lower these when an optimization removes allocations; a test
+ * failure means that a change added allocations on the parsing path.
+ */
+struct PhaseBudget {
+  ParsePhase phase;
+  std::size_t allocations;
+};
+using ParseBudget = std::array<PhaseBudget, 5>;
+constexpr ParseBudget PARSE_BUDGET{{
+    {ParsePhase::Arguments, 2},
+    {ParsePhase::Tokenization, 12},
+    {ParsePhase::Parsing, 8},
+    {ParsePhase::PositionalBinding, 4},
+    // Each `ParseResult` owns a new option values map, with its own entries.
+    {ParsePhase::ValueStorage, 13},
+}};
+// A session reuses the memory of the previous parses, including the stores of
+// the option values. What remains is the conversion of the values themselves.
+constexpr ParseBudget SESSION_PARSE_BUDGET{{
+    {ParsePhase::Arguments, 0},
+    {ParsePhase::Tokenization, 0},
+    {ParsePhase::Parsing, 4},
+    {ParsePhase::PositionalBinding, 4},
+    {ParsePhase::ValueStorage, 0},
+}};
+
+constexpr int argc = 9;
+std::array<const char *, argc> argv{{"tool", "run", "-v", "--jobs=4",
+    "--define", "first", "--define=second", "input.txt", "output.txt"}};
+
+auto MakeCli() -> std::unique_ptr<Cli> {
+  return CliBuilder()
+      .ProgramName("tool")
+      .WithCommand(
+          CommandBuilder("run")
+              .WithOption(Option::WithKey("verbose")
+                              .Short("v")
+                              .WithValue<bool>()
+                              .Build())
+              .WithOption(Option::WithKey("jobs")
+                              .Long("jobs")
+                              .WithValue<int>()
+                              .Build())
+              .WithOption(Option::WithKey("define")
+                              .Long("define")
+                              .WithValue<std::string>()
+                              .Repeatable()
+                              .Build())
+              .WithPositionalArguments(
+                  Option::Rest().WithValue<std::string>().Build()))
+      .Build();
+}
+
+void ExpectWithinBudget(const ParseBudget &budget) {
+  const auto stats = GetAllocationStats();
+  for (const auto &phase_budget : budget) {
+    EXPECT_THAT(
+        stats.Of(phase_budget.phase).allocations, Le(phase_budget.allocations))
+        << "phase " << magic_enum::enum_name(phase_budget.phase);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(AllocationStatsTest, SteadyStateParseStaysWithinBudget) {
+  const auto cli = MakeCli();
+
+  // Warm up, so that one time allocations (logger registration, caches...)
+  // are not counted.
+  cli->Parse(argc, argv.data());
+
+  ResetAllocationStats();
+  {
+    const auto &ovm = cli->Parse(argc, argv.data()).ovm;
+    EXPECT_THAT(ovm.ValuesOf("define").size(), Eq(2));
+  }
+  ExpectWithinBudget(PARSE_BUDGET);
+  // A new option values map always allocates the stores of its values; this
+  // guards against the phases silently not being counted.
+  EXPECT_THAT(
+      GetAllocationStats().Of(ParsePhase::ValueStorage).allocations, Ge(1));
+}
+
+// NOLINTNEXTLINE
+TEST(AllocationStatsTest, SteadyStateSessionParseStaysWithinBudget) {
+  const auto cli = MakeCli();
+  ParseSession session(*cli);
+  session.Parse(argc, argv.data());
+
+  ResetAllocationStats();
+  {
+    const auto &ovm = session.Parse(argc, argv.data()).ovm;
+    EXPECT_THAT(ovm.ValuesOf("define").size(), Eq(2));
+  }
+  ExpectWithinBudget(SESSION_PARSE_BUDGET);
+}
+
+// NOLINTNEXTLINE
+TEST(AllocationStatsTest, StaticProgramDoesNotAllocateBeforeParse) {
+  ResetAllocationStats();
+  static constexpr auto program = schema::Program({"tool", "1.0", "A tool."},
+      schema::Command(schema::Option<bool>("verbose").Short("v"),
+          schema::Option<int>("jobs").Long("jobs"),
+          schema::Option<std::vector<std::string>>("define").Long("define"),
+          schema::Rest<std::vector<std::string>>("files")));
+  const auto view = program.View();
+  EXPECT_THAT(view.ProgramName(), Eq("tool"));
+  EXPECT_THAT(view.OptionsCount(), Eq(4));
+  EXPECT_THAT(GetAllocationStats().Of(ParsePhase::None).allocations, Eq(0));
+
+  // The program has the same options as the dynamic one, but for the command.
+  std::array<const char *, argc - 1> program_argv{};
+  std::copy_if(argv.begin(), argv.end(), program_argv.begin(),
+      [](const char *arg) { return std::string_view{arg} != "run"; });
+  const auto values = program.Parse(argc - 1, program_argv.data());
+  ASSERT_THAT(values.has_value(), Eq(true));
+  EXPECT_THAT(values->Get<program.Command().IndexOf("define")>().size(), Eq(2));
+}
+
+} // namespace
+
+} // namespace asap::clap::debug
@@ -47,6 +47,16 @@ TEST(ConstructArguments, WithManyArgs) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST(ConstructArguments, ArgsAreViewsIntoArgv) {
+  constexpr auto argc = 3;
+  std::array<const char *, 3> argv{{"test", "-x", "--opt=value"}};
+  const Arguments cla{argc, argv.data()};
+  ASSERT_THAT(cla.Args().size(), Eq(2));
+  EXPECT_THAT(cla.Args()[0].data(), Eq(gsl::at(argv, 1)));
+  EXPECT_THAT(cla.Args()[1].data(), Eq(gsl::at(argv, 2)));
+}
+
 #if defined(ASAP_IS_DEBUG_BUILD)
 // NOLINTNEXTLINE
 TEST(ConstructArguments, WithNoArgs) {
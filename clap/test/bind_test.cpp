@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Optional;
+
+namespace asap::clap {
+
+namespace {
+
+//! [Bind options to struct members]
+struct Config {
+  bool verbose{false};
+  int level{0};
+  std::optional<std::string> output;
+  std::vector<std::string> includes;
+  std::vector<std::string> files;
+};
+
+auto MakeCli() -> std::unique_ptr<Cli> {
+  return CliBuilder()
+      .ProgramName("test")
+      .WithCommand(
+          CommandBuilder(Command::DEFAULT)
+              .WithOption(Option::WithKey("verbose")
+                              .Short("v")
+                              .Long("verbose")
+                              .WithValue<bool>()
+                              .ImplicitValue(true, "true")
+                              .Build())
+              .WithOption(Option::WithKey("level")
+                              .Short("l")
+                              .Long("level")
+                              .WithValue<int>()
+                              .DefaultValue(1, "1")
+                              .Build())
+              .WithOption(Option::WithKey("output")
+                              .Short("o")
+                              .Long("output")
+                              .WithValue<std::string>()
+                              .Build())
+              .WithOption(Option::WithKey("include")
+                              .Short("I")
+                              .Long("include")
+                              .WithValue<std::string>()
+                              .Repeatable()
+                              .Build())
+              .WithOption(Option::WithKey("jobs")
+                              .Long("jobs")
+                              .WithValue<int>()
+                              .Build())
+              .WithPositionalArguments(
+                  Option::Rest().WithValue<std::string>().Build())
+              .BindTo<Config>()
+              .Bind("verbose", &Config::verbose)
+              .Bind("level", &Config::level)
+              .Bind("output", &Config::output)
+              .Bind("include", &Config::includes)
+              .Bind(Option::key_rest, &Config::files))
+      .Build();
+}
+//! [Bind options to struct members]
+
+template <std::size_t size>
+auto ParseInto(Config &config, std::array<const char *, size> argv)
+    -> ParseResult {
+  static const auto cli = MakeCli();
+  return cli->ParseInto(config, static_cast<int>(argv.size()), argv.data());
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, ValuesAreStoredIntoTheMembers) {
+  Config config;
+  const auto result = ParseInto(config,
+      std::array{"test", "-v", "--level=3", "-o", "out.txt", "-I", "a",
+          "--include=b", "one", "two"});
+
+  EXPECT_THAT(config.verbose, IsTrue());
+  EXPECT_THAT(config.level, Eq(3));
+  EXPECT_THAT(config.output, Optional(Eq("out.txt")));
+  EXPECT_THAT(config.includes, ElementsAre("a", "b"));
+  EXPECT_THAT(config.files, ElementsAre("one", "two"));
+
+  // Bound options do not go through the option values map.
+  EXPECT_THAT(result.ovm.HasOption("level"), IsFalse());
+  EXPECT_THAT(result.ovm.HasOption("include"), IsFalse());
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, DefaultValuesAreStoredIntoTheMembers) {
+  Config config;
+  static_cast<void>(ParseInto(config, std::array{"test"}));
+
+  EXPECT_THAT(config.verbose, IsFalse());
+  EXPECT_THAT(config.level, Eq(1));
+  EXPECT_THAT(config.output.has_value(), IsFalse());
+  EXPECT_THAT(config.includes, IsEmpty());
+  EXPECT_THAT(config.files, IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, OptionsThatAreNotBoundGoToTheOptionValuesMap) {
+  Config config;
+  const auto result =
+      ParseInto(config, std::array{"test", "--jobs", "4", "-v"});
+
+  EXPECT_THAT(config.verbose, IsTrue());
+  ASSERT_THAT(result.ovm.HasOption("jobs"), IsTrue());
+  EXPECT_THAT(
+      std::any_cast<int>(result.ovm.ValuesOf("jobs").front().Value()), Eq(4));
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, BoundOptionsCanOnlyOccurOnceUnlessRepeatable) {
+  Config config;
+  testing::internal::CaptureStderr();
+  EXPECT_THROW(static_cast<void>(ParseInto(
+                   config, std::array{"test", "--level=1", "-l", "2"})),
+      CmdLineArgumentsError);
+  EXPECT_THAT(testing::internal::GetCapturedStderr(),
+      HasSubstr("appeared before with value '1'"));
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, ParseWithoutTargetUsesTheOptionValuesMap) {
+  const auto cli = MakeCli();
+  std::array argv{"test", "--level=3"};
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+
+  ASSERT_THAT(result.ovm.HasOption("level"), IsTrue());
+  EXPECT_THAT(
+      std::any_cast<int>(result.ovm.ValuesOf("level").front().Value()), Eq(3));
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, OnlyOptionsOfTheMemberTypeCanBeBound) {
+  auto builder = CommandBuilder(Command::DEFAULT)
+                     .WithOption(Option::WithKey("level")
+                                     .Long("level")
+                                     .WithValue<int>()
+                                     .Build())
+                     .BindTo<Config>();
+  EXPECT_THROW(builder.Bind("level", &Config::output), std::domain_error);
+  EXPECT_THROW(builder.Bind("unknown", &Config::level), std::domain_error);
+  EXPECT_NO_THROW(builder.Bind("level", &Config::level));
+}
+
+// NOLINTNEXTLINE
+TEST(Bind, ListOptionsAppendTheirElementsToTheMember) {
+  struct ListConfig {
+    std::vector<int> ids;
+  };
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(CommandBuilder(Command::DEFAULT)
+                           .WithOption(Option::WithKey("ids")
+                                           .Long("ids")
+                                           .WithValue<std::vector<int>>()
+                                           .Delimiter(',')
+                                           .Repeatable()
+                                           .Build())
+                           .BindTo<ListConfig>()
+                           .Bind("ids", &ListConfig::ids))
+          .Build();
+
+  ListConfig config;
+  std::array argv{"test", "--ids=1,2", "--ids=3"};
+  const auto result =
+      cli->ParseInto(config, static_cast<int>(argv.size()), argv.data());
+
+  EXPECT_THAT(config.ids, ElementsAre(1, 2, 3));
+  EXPECT_THAT(result.ovm.HasOption("ids"), IsFalse());
+}
+
+} // namespace
+
+} // namespace asap::clap
@@ -8,7 +8,12 @@
 #include "clap/command_line_context.h"
 
 #include <array>
+#include <iostream>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -32,7 +37,10 @@ ASAP_DIAGNOSTIC_POP
 #include "clap/fluent/dsl.h"
 #include "clap/option.h"
 
+using ::testing::Each;
+using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::IsFalse;
 using ::testing::IsTrue;
 
 namespace asap::clap {
@@ -353,6 +361,258 @@ TEST(CommandLineTest, Test) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST(CommandLineTest, ArgumentsFromSource) {
+  constexpr size_t argc = 3;
+  std::array<const char *, argc> argv{
+      {"/usr/bin/test-program.exe", "head", "-q"}};
+  using namespace std::string_literals;
+  std::istringstream input("--lines=5\0first file.txt\0second.txt\0"s);
+
+  UtilsCli cli;
+  const auto &matches =
+      cli.CommandLine()
+          .Parse(argc, argv.data(), ArgumentSource::FromStream(input))
+          .ovm;
+
+  const auto &v_lines = matches.ValuesOf(("lines"));
+  EXPECT_THAT(v_lines.size(), Eq(1));
+  EXPECT_THAT(v_lines.at(0).GetAs<int>(), Eq(5));
+
+  const auto &v_quiet = matches.ValuesOf(("quiet"));
+  EXPECT_THAT(v_quiet.size(), Eq(1));
+  EXPECT_THAT(v_quiet.at(0).GetAs<bool>(), Eq(true));
+
+  const auto &v_rest = matches.ValuesOf(Option::key_rest);
+  EXPECT_THAT(v_rest.size(), Eq(2));
+  EXPECT_THAT(v_rest.at(0).GetAs<std::string>(), Eq("first file.txt"));
+  EXPECT_THAT(v_rest.at(1).GetAs<std::string>(), Eq("second.txt"));
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, ParseLine) {
+  {
+    UtilsCli cli;
+    const auto &matches =
+        cli.CommandLine()
+            .ParseLine("head -q --lines \"+20\" 'my file.txt'")
+            .ovm;
+
+    const auto &v_lines = matches.ValuesOf(("lines"));
+    EXPECT_THAT(v_lines.size(), Eq(1));
+    EXPECT_THAT(v_lines.at(0).GetAs<int>(), Eq(20));
+
+    const auto &v_quiet = matches.ValuesOf(("quiet"));
+    EXPECT_THAT(v_quiet.size(), Eq(1));
+    EXPECT_THAT(v_quiet.at(0).GetAs<bool>(), Eq(true));
+
+    const auto &v_rest = matches.ValuesOf(Option::key_rest);
+    EXPECT_THAT(v_rest.size(), Eq(1));
+    EXPECT_THAT(v_rest.at(0).GetAs<std::string>(), Eq("my file.txt"));
+  }
+  {
+    UtilsCli cli;
+    const auto &matches = cli.CommandLine().ParseLine("  --version").ovm;
+    const auto &values = matches.ValuesOf(("version"));
+    EXPECT_THAT(values.size(), Eq(1));
+    EXPECT_THAT(values.at(0).GetAs<bool>(), IsTrue());
+  }
+  {
+    UtilsCli cli;
+    EXPECT_THROW(cli.CommandLine().ParseLine("head \"unterminated"),
+        CmdLineArgumentsError);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, ParseSameCliTwice) {
+  UtilsCli cli;
+  cli.CommandLine().ParseLine("head -q --lines=5 first.txt");
+  const auto &matches =
+      cli.CommandLine().ParseLine("head --lines=7 second.txt").ovm;
+
+  const auto &v_lines = matches.ValuesOf(("lines"));
+  EXPECT_THAT(v_lines.size(), Eq(1));
+  EXPECT_THAT(v_lines.at(0).GetAs<int>(), Eq(7));
+  EXPECT_THAT(matches.HasOption("quiet"), Eq(false));
+
+  const auto &v_rest = matches.ValuesOf(Option::key_rest);
+  EXPECT_THAT(v_rest.size(), Eq(1));
+  EXPECT_THAT(v_rest.at(0).GetAs<std::string>(), Eq("second.txt"));
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, ResultsAreIndependentFromLaterParses) {
+  UtilsCli cli;
+  const auto first = cli.CommandLine().ParseLine("head -q --lines=5 a.txt");
+  const auto second = cli.CommandLine().ParseLine("paint --color=blue");
+
+  EXPECT_THAT(first.program_name, Eq("utils"));
+  EXPECT_THAT(first.active_command->PathAsString(), Eq("head"));
+  EXPECT_THAT(first.ovm.ValuesOf("lines").at(0).GetAs<int>(), Eq(5));
+  EXPECT_THAT(first.ovm.HasOption("quiet"), IsTrue());
+  EXPECT_THAT(first.ovm.HasOption("color"), IsFalse());
+  EXPECT_THAT(second.active_command->PathAsString(), Eq("paint"));
+  EXPECT_THAT(second.ovm.HasOption("lines"), IsFalse());
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, ConcurrentParsesWithSameCli) {
+  const std::unique_ptr<Cli> cli =
+      CliBuilder()
+          .WithCommand(CommandBuilder("run").WithOption(
+              Option::WithKey("jobs").Long("jobs").WithValue<int>().Build()))
+          .Build();
+  const Cli &shared_cli = *cli;
+
+  constexpr int num_threads = 4;
+  constexpr int num_parses = 200;
+  std::vector<int> failures(num_threads, 0);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int thread = 0; thread < num_threads; ++thread) {
+    threads.emplace_back([&shared_cli, &failures, thread]() {
+      // Each thread uses its own program name and option values, so that a
+      // result mixing data from another parse would be detected.
+      const std::string program_name = fmt::format("worker-{}", thread);
+      for (int parse = 0; parse < num_parses; ++parse) {
+        const std::string jobs = std::to_string(thread * num_parses + parse);
+        std::array<const char *, 4> argv{
+            {program_name.c_str(), "run", "--jobs", jobs.c_str()}};
+        const auto result =
+            shared_cli.Parse(static_cast<int>(argv.size()), argv.data());
+        if (result.program_name != program_name ||
+            result.active_command->PathAsString() != "run" ||
+            result.ovm.ValuesOf("jobs").at(0).GetAs<int>() !=
+                thread * num_parses + parse) {
+          ++failures[static_cast<std::size_t>(thread)];
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_THAT(failures, Each(Eq(0)));
+  // Deducing the program name during a parse does not change the `Cli`.
+  EXPECT_THAT(shared_cli.ProgramName(), Eq(""));
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, AbbreviatedLongOptions) {
+  const auto make_cli = [](bool abbreviated) {
+    auto builder = CliBuilder();
+    builder.ProgramName("tool").WithCommand(
+        CommandBuilder("run")
+            .WithOption(
+                Option::WithKey("jobs").Long("jobs").WithValue<int>().Build())
+            .WithOption(Option::WithKey("verbose")
+                            .Long("verbose")
+                            .WithValue<bool>()
+                            .Build()));
+    if (abbreviated) {
+      builder.WithAbbreviatedLongOptions();
+    }
+    return builder.Build();
+  };
+
+  const auto cli = make_cli(true);
+  EXPECT_THAT(cli->AbbreviatedLongOptions(), IsTrue());
+  const auto result = cli->ParseLine("run --j=4 --verb");
+  EXPECT_THAT(result.ovm.ValuesOf("jobs").at(0).GetAs<int>(), Eq(4));
+  EXPECT_THAT(result.ovm.HasOption("verbose"), IsTrue());
+
+  const auto strict_cli = make_cli(false);
+  EXPECT_THAT(strict_cli->AbbreviatedLongOptions(), IsFalse());
+  // NOLINTNEXTLINE(hicpp-avoid-goto, cppcoreguidelines-avoid-goto)
+  EXPECT_THROW(strict_cli->ParseLine("run --j=4"), CmdLineArgumentsError);
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, BulkArgumentClassification) {
+  const auto make_cli = [](bool bulk) {
+    auto builder = CliBuilder();
+    builder.ProgramName("tool").WithCommand(
+        CommandBuilder("run")
+            .WithOption(
+                Option::WithKey("jobs").Long("jobs").WithValue<int>().Build())
+            .WithOption(
+                Option::WithKey("verbose").Short("v").WithValue<bool>().Build())
+            .WithPositionalArguments(
+                Option::Rest().WithValue<std::string>().Build()));
+    if (bulk) {
+      builder.WithBulkArgumentClassification();
+    }
+    return builder.Build();
+  };
+
+  // Enough arguments for several batches, with options in the last one.
+  std::vector<std::string> storage{"tool", "run"};
+  for (int index = 0; index < 100; ++index) {
+    storage.push_back("file" + std::to_string(index));
+  }
+  storage.emplace_back("--jobs=4");
+  storage.emplace_back("-v");
+  std::vector<const char *> argv;
+  for (const auto &arg : storage) {
+    argv.push_back(arg.c_str());
+  }
+
+  for (const auto bulk : {false, true}) {
+    const auto cli = make_cli(bulk);
+    EXPECT_THAT(cli->BulkArgumentClassification(), Eq(bulk));
+    const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+    EXPECT_THAT(result.ovm.ValuesOf("jobs").at(0).GetAs<int>(), Eq(4));
+    EXPECT_THAT(result.ovm.HasOption("verbose"), IsTrue());
+    EXPECT_THAT(result.ovm.ValuesOf(Option::key_rest).size(), Eq(100U));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, HelpCommandWithoutDefaultCommand) {
+  const std::unique_ptr<Cli> cli =
+      CliBuilder()
+          .ProgramName("tool")
+          .WithCommand(CommandBuilder("run").Build())
+          .WithHelpCommand()
+          .WithVersionCommand()
+          .Build();
+
+  // The implicit default command has no path segment, not even the program
+  // name.
+  const auto result = cli->ParseLine("");
+  EXPECT_THAT(result.active_command->IsDefault(), IsTrue());
+  EXPECT_THAT(result.active_command->Path(), ElementsAre(Command::DEFAULT));
+  EXPECT_THAT(cli->ParseLine("run").active_command->PathAsString(), Eq("run"));
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineTest, HelpUsesTheProgramNameOfTheParse) {
+  const std::unique_ptr<Cli> cli =
+      CliBuilder()
+          .WithCommand(CommandBuilder("run").Build())
+          .WithHelpCommand()
+          .Build();
+
+  std::ostringstream output;
+  auto *const cout_buffer = std::cout.rdbuf(output.rdbuf());
+  std::array argv{"tool", "run", "--help"};
+  try {
+    static_cast<void>(
+        cli->Parse(static_cast<int>(argv.size()), argv.data()));
+  } catch (...) {
+    std::cout.rdbuf(cout_buffer);
+    throw;
+  }
+  std::cout.rdbuf(cout_buffer);
+
+  // The synopsis is the first line after the `SYNOPSIS` title.
+  const auto help = output.str();
+  const auto synopsis = help.find_first_not_of(' ', help.find('\n') + 1);
+  EXPECT_THAT(help.substr(synopsis, 9), Eq("tool run "));
+}
+
 } // namespace
 
 } // namespace asap::clap
@@ -6,14 +6,19 @@
 
 #include "clap/command.h"
 #include "clap/fluent/command_builder.h"
+#include "clap/fluent/option_builder.h"
+#include "clap/fluent/option_value_builder.h"
 
 #include <exception>
+#include <string>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 using testing::Eq;
+using testing::IsNull;
 using testing::IsTrue;
+using testing::NotNull;
 
 namespace asap::clap {
 
@@ -58,6 +63,57 @@ TEST(Command, MultipleSegmentsContainingDefaultIsIllegalPath) {
   ASSERT_THROW(CommandBuilder("sgement1", "", "segment2"), std::exception);
 }
 
+// NOLINTNEXTLINE
+TEST(Command, FindOptionsByName) {
+  CommandBuilder builder("build");
+  for (int index = 0; index < 100; ++index) {
+    auto option = Option::WithKey("option-" + std::to_string(index));
+    option.Long("option-" + std::to_string(index));
+    if (index < 26) {
+      option.Short(std::string(1, static_cast<char>('a' + index)));
+    }
+    builder.WithOption(option.WithValue<int>().Build());
+  }
+  const std::unique_ptr<Command> cmd = builder;
+
+  for (int index = 0; index < 100; ++index) {
+    const auto *option = cmd->FindLongOption("option-" + std::to_string(index));
+    ASSERT_THAT(option, NotNull());
+    EXPECT_THAT(option->Key(), Eq("option-" + std::to_string(index)));
+  }
+  ASSERT_THAT(cmd->FindShortOption("z"), NotNull());
+  EXPECT_THAT(cmd->FindShortOption("z")->Key(), Eq("option-25"));
+  EXPECT_THAT(cmd->FindShortOption("A"), IsNull());
+  EXPECT_THAT(cmd->FindShortOption(""), IsNull());
+  EXPECT_THAT(cmd->FindLongOption("option-100"), IsNull());
+  EXPECT_THAT(cmd->FindLongOption("option"), IsNull());
+  EXPECT_THAT(cmd->FindLongOption(""), IsNull());
+}
+
+// NOLINTNEXTLINE
+TEST(Command, FindOptionWithDuplicateName) {
+  const std::unique_ptr<Command> cmd =
+      CommandBuilder("run")
+          .WithOption(Option::WithKey("first")
+                          .Short("h")
+                          .Long("same")
+                          .WithValue<bool>()
+                          .Build())
+          .WithOption(Option::WithKey("second")
+                          .Long("same")
+                          .WithValue<bool>()
+                          .Build())
+          .WithOption(Option::WithKey(Command::HELP)
+                          .Short("h")
+                          .WithValue<bool>()
+                          .Build());
+
+  // The first option in the list of options wins, and the `help` option is
+  // always at the front.
+  EXPECT_THAT(cmd->FindLongOption("same")->Key(), Eq("first"));
+  EXPECT_THAT(cmd->FindShortOption("h")->Key(), Eq(Command::HELP));
+}
+
 } // namespace
 
 } // namespace asap::clap
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/detail/name_index.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+namespace asap::clap::detail {
+
+namespace {
+
+constexpr std::array<std::string_view, 5> SIZES{
+    "tiny", "Small", "MEDIUM", "large", "x"};
+constexpr NameIndex<SIZES.size()> SIZES_INDEX{SIZES};
+
+// The table is built, and can be used, at compile time.
+static_assert(SIZES_INDEX.Find("medium") == 2);
+static_assert(!SIZES_INDEX.Find("huge").has_value());
+
+// NOLINTNEXTLINE
+TEST(NameIndex, FindsEachNameIgnoringCase) {
+  for (std::size_t index = 0; index < SIZES.size(); ++index) {
+    EXPECT_THAT(SIZES_INDEX.Find(SIZES[index]), Optional(Eq(index)));
+    EXPECT_THAT(SIZES_INDEX.Find(ToLower(std::string{SIZES[index]})),
+        Optional(Eq(index)));
+  }
+  EXPECT_THAT(SIZES_INDEX.Find("TiNy"), Optional(Eq(0U)));
+  EXPECT_THAT(SIZES_INDEX.Find("X"), Optional(Eq(4U)));
+}
+
+// NOLINTNEXTLINE
+TEST(NameIndex, DoesNotFindOtherWords) {
+  for (const auto *word : {"", "tin", "tinyy", "smal", "y", "large "}) {
+    EXPECT_FALSE(SIZES_INDEX.Find(word).has_value()) << word;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(NameIndex, WorksWithManyNames) {
+  constexpr std::size_t count = 200;
+  std::vector<std::string> storage;
+  storage.reserve(count);
+  std::array<std::string_view, count> names{};
+  for (std::size_t index = 0; index < count; ++index) {
+    storage.push_back("name_" + std::to_string(index));
+    names[index] = storage.back();
+  }
+  const NameIndex<count> index{names};
+  for (std::size_t name = 0; name < count; ++name) {
+    EXPECT_THAT(index.Find(names[name]), Optional(Eq(name)));
+  }
+  EXPECT_FALSE(index.Find("name_200").has_value());
+}
+
+// NOLINTNEXTLINE
+TEST(NameIndex, RejectsNamesEqualIgnoringCase) {
+  const std::array<std::string_view, 3> names{"red", "green", "Red"};
+  EXPECT_THROW(NameIndex<names.size()>{names}, std::logic_error);
+}
+
+// NOLINTNEXTLINE
+TEST(NameIndex, CanBeEmpty) {
+  constexpr NameIndex<0> index{std::array<std::string_view, 0>{}};
+  EXPECT_FALSE(index.Find("any").has_value());
+}
+
+} // namespace
+
+} // namespace asap::clap::detail
@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::Ne;
+
+namespace asap::clap {
+
+namespace {
+
+template <std::size_t size>
+auto Parse(const Cli &cli, std::array<const char *, size> argv)
+    -> ParseResult {
+  return cli.Parse(static_cast<int>(argv.size()), argv.data());
+}
+
+// NOLINTNEXTLINE
+TEST(Notify, FinalValuesAreNotifiedAfterDefaultsAreApplied) {
+  int level{0};
+  std::vector<int> notified;
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(CommandBuilder(Command::DEFAULT)
+                           .WithOption(Option::WithKey("level")
+                                           .Long("level")
+                                           .WithValue<int>()
+                                           .DefaultValue(3, "3")
+                                           .StoreTo(&level)
+                                           .Notifier([&notified](int value) {
+                                             notified.push_back(value);
+                                           })
+                                           .Build()))
+          .Build();
+
+  static_cast<void>(Parse(*cli, std::array{"test"}));
+  EXPECT_THAT(level, Eq(3));
+  EXPECT_THAT(notified, ElementsAre(3));
+
+  static_cast<void>(Parse(*cli, std::array{"test", "--level=5"}));
+  EXPECT_THAT(level, Eq(5));
+  EXPECT_THAT(notified, ElementsAre(3, 5));
+}
+
+// NOLINTNEXTLINE
+TEST(Notify, EachValueIsNotifiedBeforeFinalValues) {
+  std::vector<std::string> events;
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(
+              CommandBuilder(Command::DEFAULT)
+                  .WithOption(
+                      Option::WithKey("input")
+                          .Short("i")
+                          .WithValue<std::string>()
+                          .Repeatable()
+                          .NotifyOnEachValue([&events](const std::string &v) {
+                            events.push_back("each " + v);
+                          })
+                          .Notifier([&events](const std::string &v) {
+                            events.push_back("final " + v);
+                          })
+                          .Build())
+                  .WithPositionalArguments(
+                      Option::Rest()
+                          .WithValue<std::string>()
+                          .NotifyOnEachValue([&events](const std::string &v) {
+                            events.push_back("rest " + v);
+                          })
+                          .Build()))
+          .Build();
+
+  static_cast<void>(
+      Parse(*cli, std::array{"test", "-i", "a", "-i", "b", "file"}));
+  EXPECT_THAT(events,
+      ElementsAre("each a", "each b", "rest file", "final a", "final b"));
+}
+
+// NOLINTNEXTLINE
+TEST(Notify, BoundValuesAreNotified) {
+  struct Config {
+    std::vector<int> sizes;
+  };
+  std::vector<int> each;
+  std::vector<int> final_values;
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(CommandBuilder(Command::DEFAULT)
+                           .WithOption(Option::WithKey("size")
+                                           .Short("s")
+                                           .WithValue<int>()
+                                           .Repeatable()
+                                           .NotifyOnEachValue([&each](int v) {
+                                             each.push_back(v);
+                                           })
+                                           .Notifier([&final_values](int v) {
+                                             final_values.push_back(v);
+                                           })
+                                           .Build())
+                           .BindTo<Config>()
+                           .Bind("size", &Config::sizes))
+          .Build();
+
+  Config config;
+  std::array argv{"test", "-s", "1", "-s", "2"};
+  static_cast<void>(
+      cli->ParseInto(config, static_cast<int>(argv.size()), argv.data()));
+  EXPECT_THAT(config.sizes, ElementsAre(1, 2));
+  EXPECT_THAT(each, ElementsAre(1, 2));
+  EXPECT_THAT(final_values, ElementsAre(1, 2));
+}
+
+auto MakeWorkerThreadCli(std::vector<std::string> &inputs,
+    std::vector<std::thread::id> &threads) -> std::unique_ptr<Cli> {
+  return CliBuilder()
+      .ProgramName("test")
+      .WithNotificationsOnWorkerThread()
+      .WithCommand(CommandBuilder(Command::DEFAULT)
+                       .WithPositionalArguments(
+                           Option::Rest()
+                               .WithValue<std::string>()
+                               .NotifyOnEachValue(
+                                   [&inputs, &threads](const std::string &v) {
+                                     if (v == "bad") {
+                                       throw std::runtime_error("bad input");
+                                     }
+                                     inputs.push_back(v);
+                                     threads.push_back(
+                                         std::this_thread::get_id());
+                                   })
+                               .Build()))
+      .Build();
+}
+
+// NOLINTNEXTLINE
+TEST(Notify, CallbacksCanRunOnAWorkerThread) {
+  std::vector<std::string> inputs;
+  std::vector<std::thread::id> threads;
+  const auto cli = MakeWorkerThreadCli(inputs, threads);
+
+  static_cast<void>(Parse(*cli, std::array{"test", "one", "two", "three"}));
+  // All the callbacks have run, in order, when the parse returns.
+  EXPECT_THAT(inputs, ElementsAre("one", "two", "three"));
+  ASSERT_THAT(threads.size(), Eq(3U));
+  EXPECT_THAT(threads.front(), Ne(std::this_thread::get_id()));
+}
+
+// NOLINTNEXTLINE
+TEST(Notify, ParsesReuseTheWorkerThreadOfTheCli) {
+  std::vector<std::string> inputs;
+  std::vector<std::thread::id> threads;
+  const auto cli = MakeWorkerThreadCli(inputs, threads);
+
+  static_cast<void>(Parse(*cli, std::array{"test", "one"}));
+  static_cast<void>(Parse(*cli, std::array{"test", "two"}));
+  EXPECT_THAT(inputs, ElementsAre("one", "two"));
+  ASSERT_THAT(threads.size(), Eq(2U));
+  EXPECT_THAT(threads.back(), Eq(threads.front()));
+}
+
+// NOLINTNEXTLINE
+TEST(Notify, ExceptionsOnTheWorkerThreadAreRethrownByParse) {
+  std::vector<std::string> inputs;
+  std::vector<std::thread::id> threads;
+  const auto cli = MakeWorkerThreadCli(inputs, threads);
+
+  EXPECT_THROW(
+      static_cast<void>(Parse(*cli, std::array{"test", "one", "bad", "two"})),
+      std::runtime_error);
+  EXPECT_THAT(inputs, ElementsAre("one", "two"));
+}
+
+} // namespace
+
+} // namespace asap::clap
@@ -6,9 +6,26 @@
 
 #include "clap/option_values_map.h"
 
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+
+#include <any>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
 namespace asap::clap {
 
 namespace {
@@ -24,6 +41,265 @@ TEST(OptionValuesMapTest, StoringAfterFinalThrows) {
   ovm.StoreValue("verbose", {std::make_any<bool>(true), "true", false});
 }
 
+// NOLINTNEXTLINE
+TEST(OptionIdsTest, IdsAreGivenInTheOrderOptionsAreAdded) {
+  const std::shared_ptr<Option> before = Option::WithKey("before").Build();
+  const std::shared_ptr<Option> first = Option::WithKey("first").Build();
+  const std::shared_ptr<Option> second = Option::WithKey("second").Build();
+  const std::shared_ptr<Option> after = Option::WithKey("after").Build();
+  const Option copy = *first;
+
+  OptionIds ids;
+  EXPECT_THAT(ids.IdOf(*first), Eq(OptionIds::NO_ID));
+  EXPECT_THAT(ids.Add(*second), Eq(0U));
+  // Options created before the first one added are found as well.
+  EXPECT_THAT(ids.Add(*first), Eq(1U));
+  EXPECT_THAT(ids.Add(*second), Eq(0U));
+  EXPECT_THAT(ids.IdOf(*first), Eq(1U));
+  EXPECT_THAT(ids.IdOf(*second), Eq(0U));
+  EXPECT_THAT(ids.IdOf(*before), Eq(OptionIds::NO_ID));
+  EXPECT_THAT(ids.IdOf(*after), Eq(OptionIds::NO_ID));
+  // A copy of an option is another option, with the same key.
+  EXPECT_THAT(ids.IdOf(copy), Eq(OptionIds::NO_ID));
+  EXPECT_THAT(ids.Add(copy), Eq(2U));
+  EXPECT_THAT(*ids.IdsOf("first"), ElementsAre(1U, 2U));
+  EXPECT_THAT(ids.Count(), Eq(3U));
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, ValuesOfOptionsWithIdsCanBeFoundByKey) {
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(CommandBuilder(Command::DEFAULT)
+                           .WithOption(Option::WithKey("size")
+                                           .Long("size")
+                                           .WithValue<int>()
+                                           .Repeatable()
+                                           .Build()))
+          .Build();
+
+  std::array argv{"test", "--size=1", "--size=2"};
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+  const auto &ovm = result.ovm;
+  EXPECT_THAT(ovm.HasOption("size"), IsTrue());
+  EXPECT_THAT(ovm.OccurrencesOf("size"), Eq(2U));
+  EXPECT_THAT(std::any_cast<int>(ovm.ValuesOf("size").back().Value()), Eq(2));
+  EXPECT_THAT(ovm.HasOption("other"), IsFalse());
+  EXPECT_THROW(static_cast<void>(ovm.ValuesOf("other")), std::out_of_range);
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, OptionHandlesGiveTypedValues) {
+  //! [Option handle]
+  auto level_builder = Option::WithKey("level").Long("level").WithValue<int>();
+  auto name_builder =
+      Option::WithKey("name").Long("name").WithValue<std::string>();
+  // Get the handles before the options are built and moved into the command.
+  const auto level = level_builder.Handle();
+  const auto name = name_builder.Handle();
+
+  const auto cli = CliBuilder()
+                       .ProgramName("test")
+                       .WithCommand(CommandBuilder(Command::DEFAULT)
+                                        .WithOption(level_builder.Build())
+                                        .WithOption(name_builder.Build()))
+                       .Build();
+
+  std::array argv{"test", "--level=3"};
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+  // `ValueOf()` gives the value with its type, without looking up the option
+  // by its key.
+  const int &level_value = result.ovm.ValueOf(level);
+  EXPECT_THAT(level_value, Eq(3));
+  EXPECT_THAT(result.ovm.HasOption(name), IsFalse());
+  //! [Option handle]
+  EXPECT_THROW(
+      static_cast<void>(result.ovm.ValueOf(name)), std::out_of_range);
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, ValuesKeepTheirTypeAndOriginalToken) {
+  auto port_builder = Option::WithKey("port").Long("port").WithValue<int>();
+  port_builder.Repeatable();
+  const auto port = port_builder.Handle();
+  auto mode_builder =
+      Option::WithKey("mode").Long("mode").WithValue<std::string>();
+  mode_builder.DefaultValue("fast");
+
+  const auto cli = CliBuilder()
+                       .ProgramName("test")
+                       .WithCommand(CommandBuilder(Command::DEFAULT)
+                                        .WithOption(port_builder.Build())
+                                        .WithOption(mode_builder.Build()))
+                       .Build();
+
+  std::array argv{"test", "--port=80", "--port=443", "--port=8080"};
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+
+  // Through the handle, the values are the ints stored contiguously.
+  const auto ports = result.ovm.ValuesOf(port);
+  EXPECT_THAT(
+      std::vector<int>(ports.begin(), ports.end()), ElementsAre(80, 443, 8080));
+
+  const auto values = result.ovm.ValuesOf("port");
+  ASSERT_THAT(values.size(), Eq(3U));
+  EXPECT_THAT(values[0].GetAs<int>(), Eq(80));
+  EXPECT_THAT(values[0].OriginalToken(), Eq("80"));
+  EXPECT_THAT(values[2].OriginalToken(), Eq("8080"));
+  EXPECT_THAT(values[2].IsDefaulted(), IsFalse());
+  EXPECT_THROW(
+      static_cast<void>(values[0].GetAs<std::string>()), std::bad_any_cast);
+
+  const auto mode = result.ovm.ValuesOf("mode").front();
+  EXPECT_THAT(mode.GetAs<std::string>(), Eq("fast"));
+  EXPECT_THAT(mode.OriginalToken(), Eq("fast"));
+  EXPECT_THAT(mode.IsDefaulted(), IsTrue());
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, ValuesAreViewsValidAsLongAsTheMap) {
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(CommandBuilder(Command::DEFAULT)
+                           .WithOption(Option::WithKey("name")
+                                           .Long("name")
+                                           .WithValue<std::string>()
+                                           .Build()))
+          .Build();
+
+  std::array argv{"test", "--name=first"};
+  std::optional<OptionValue> kept;
+  {
+    auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+    const auto name = result.ovm.ValuesOf("name").front();
+    // Moving the result moves the map, and keeps the values where they are.
+    const auto moved = std::move(result);
+    EXPECT_THAT(name.GetAs<std::string>(), Eq("first"));
+    // A value that must outlive the map is copied out of it.
+    kept.emplace(name.Value(), name.OriginalToken(), name.IsDefaulted());
+  }
+  EXPECT_THAT(kept->GetAs<std::string>(), Eq("first"));
+  EXPECT_THAT(kept->OriginalToken(), Eq("first"));
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, ListValuesAreStoredAsOneVector) {
+  auto ids_builder = Option::WithKey("ids")
+                         .Long("ids")
+                         .WithValue<std::vector<std::uint32_t>>();
+  ids_builder.Delimiter(':');
+  const auto ids = ids_builder.Handle();
+
+  const auto cli =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(
+              CommandBuilder(Command::DEFAULT).WithOption(ids_builder.Build()))
+          .Build();
+
+  std::array argv{"test", "--ids=3:1:0x10"};
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+
+  EXPECT_THAT(result.ovm.OccurrencesOf("ids"), Eq(1U));
+  EXPECT_THAT(result.ovm.ValueOf(ids), ElementsAre(3U, 1U, 16U));
+  EXPECT_THAT(
+      result.ovm.ValuesOf("ids").front().OriginalToken(), Eq("3:1:0x10"));
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, ListValuesAreOnlySplitWithADelimiter) {
+  auto inputs_builder = Option::WithKey("input")
+                            .Long("input")
+                            .WithValue<std::vector<std::string>>();
+  inputs_builder.Repeatable();
+  const auto inputs = inputs_builder.Handle();
+
+  const auto cli = CliBuilder()
+                       .ProgramName("test")
+                       .WithCommand(CommandBuilder(Command::DEFAULT)
+                                        .WithOption(inputs_builder.Build()))
+                       .Build();
+
+  std::array argv{"test", "--input=a,b.txt", "--input=c"};
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+
+  const auto values = result.ovm.ValuesOf(inputs);
+  ASSERT_THAT(values.size(), Eq(2U));
+  EXPECT_THAT(values[0], ElementsAre("a,b.txt"));
+  EXPECT_THAT(values[1], ElementsAre("c"));
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, OptionsWithTheSameKeyInDifferentCommands) {
+  const auto cli = CliBuilder()
+                       .ProgramName("test")
+                       .WithHelpCommand()
+                       .WithCommand(CommandBuilder("one"))
+                       .WithCommand(CommandBuilder("two"))
+                       .Build();
+
+  // Each command has its own `help` option, and the values of the one that
+  // was on the command line are found by key.
+  std::array argv{"test", "two", "--help"};
+  testing::internal::CaptureStdout();
+  const auto result = cli->Parse(static_cast<int>(argv.size()), argv.data());
+  testing::internal::GetCapturedStdout();
+  EXPECT_THAT(result.ovm.HasOption("help"), IsTrue());
+  EXPECT_THAT(result.ovm.OccurrencesOf("help"), Eq(1U));
+}
+
+// NOLINTNEXTLINE
+TEST(OptionValuesMapTest, OptionsCanBeSharedByDifferentClis) {
+  auto level_builder = Option::WithKey("level").Long("level").WithValue<int>();
+  auto size_builder = Option::WithKey("size").Long("size").WithValue<int>();
+  const auto level = level_builder.Handle();
+  const auto size = size_builder.Handle();
+  const std::shared_ptr<Option> level_option = level_builder.Build();
+  const std::shared_ptr<Option> size_option = size_builder.Build();
+  const std::shared_ptr<Option> name_option =
+      Option::WithKey("name").Long("name").WithValue<std::string>().Build();
+
+  // Each `Cli` gives its own ids to the options, so the first option of each
+  // of these two has the same id in both.
+  const auto first = CliBuilder()
+                         .ProgramName("test")
+                         .WithCommand(CommandBuilder("one")
+                                          .WithOption(name_option)
+                                          .WithOption(level_option))
+                         .Build();
+  const auto second =
+      CliBuilder()
+          .ProgramName("test")
+          .WithCommand(CommandBuilder("two").WithOption(size_option))
+          .Build();
+  const auto both = CliBuilder()
+                        .ProgramName("test")
+                        .WithCommand(CommandBuilder("one")
+                                         .WithOption(name_option)
+                                         .WithOption(level_option))
+                        .WithCommand(CommandBuilder("two")
+                                         .WithOption(size_option)
+                                         .WithOption(level_option))
+                        .Build();
+
+  std::array one_argv{"test", "one", "--name=x", "--level=1"};
+  std::array two_argv{"test", "two", "--size=2", "--level=3"};
+  const auto from_first =
+      first->Parse(static_cast<int>(one_argv.size()), one_argv.data());
+  EXPECT_THAT(from_first.ovm.ValueOf(level), Eq(1));
+  // Without the `--level` option, which is not in the second `Cli`.
+  const auto from_second = second->Parse(3, two_argv.data());
+  EXPECT_THAT(from_second.ovm.ValueOf(size), Eq(2));
+  EXPECT_THAT(from_second.ovm.HasOption(level), IsFalse());
+  const auto from_both =
+      both->Parse(static_cast<int>(two_argv.size()), two_argv.data());
+  EXPECT_THAT(from_both.ovm.ValueOf(size), Eq(2));
+  EXPECT_THAT(from_both.ovm.ValueOf(level), Eq(3));
+  EXPECT_THAT(from_both.ovm.HasOption("name"), IsFalse());
+}
+
 } // namespace
 
 } // namespace asap::clap
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/detail/parse_list.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::SizeIs;
+
+namespace asap::clap::detail {
+
+namespace {
+
+// NOLINTNEXTLINE
+TEST(ParseList, ConvertsEachElement) {
+  std::vector<int> output;
+  EXPECT_THAT(ParseList("1,-2,0x10,1_000", ',', output), IsTrue());
+  EXPECT_THAT(output, ElementsAre(1, -2, 16, 1000));
+
+  std::vector<double> ratios;
+  EXPECT_THAT(ParseList("0.5:2", ':', ratios), IsTrue());
+  EXPECT_THAT(ratios, ElementsAre(0.5, 2.0));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseList, EmptyInputIsAnEmptyList) {
+  std::vector<int> output{1, 2};
+  EXPECT_THAT(ParseList("", ',', output), IsTrue());
+  EXPECT_THAT(output, IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(ParseList, EmptyElementsAreGivenToTheValueParser) {
+  std::vector<std::string> names;
+  EXPECT_THAT(ParseList("a,,b,", ',', names), IsTrue());
+  EXPECT_THAT(names, ElementsAre("a", "", "b", ""));
+
+  std::vector<int> numbers{7};
+  EXPECT_THAT(ParseList("1,,2", ',', numbers), IsFalse());
+  EXPECT_THAT(ParseList("1,2,", ',', numbers), IsFalse());
+  EXPECT_THAT(numbers, ElementsAre(7));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseList, FailsIfAnyElementIsNotAValue) {
+  std::vector<std::uint16_t> output{7};
+  EXPECT_THAT(ParseList("1,2,x", ',', output), IsFalse());
+  EXPECT_THAT(ParseList("1,65536", ',', output), IsFalse());
+  EXPECT_THAT(ParseList("1;2", ',', output), IsFalse());
+  EXPECT_THAT(output, ElementsAre(7));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseList, SplitListCutsAtDelimiters) {
+  EXPECT_THAT(
+      SplitList("12,345,6,78", ',', 3), ElementsAre("12,345", "6", "78"));
+  EXPECT_THAT(SplitList("12,345,6,78", ',', 1), ElementsAre("12,345,6,78"));
+  // An element longer than a chunk gives fewer chunks.
+  EXPECT_THAT(SplitList("123456789,1", ',', 4), ElementsAre("123456789", "1"));
+  // The elements of the chunks are those of the list, even empty ones.
+  EXPECT_THAT(SplitList("1,,2", ',', 2), ElementsAre("1,", "2"));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseList, RunInParallelCallsWorkForEachIndex) {
+  std::vector<std::size_t> done(4, 0);
+  RunInParallel(
+      done.size(), [&done](std::size_t index) { done[index] = index; });
+  EXPECT_THAT(done, ElementsAre(0, 1, 2, 3));
+
+  EXPECT_THROW(RunInParallel(3,
+                   [](std::size_t index) {
+                     if (index == 2) {
+                       throw std::runtime_error("failed");
+                     }
+                   }),
+      std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(ParseList, LongListsGiveTheSameValuesInParallel) {
+  // Long enough to be converted in several chunks, if there are several
+  // hardware threads.
+  constexpr std::uint32_t count = 200000;
+  std::string input;
+  for (std::uint32_t value = 0; value < count; ++value) {
+    input += std::to_string(value);
+    input += ',';
+  }
+  input.pop_back();
+  ASSERT_THAT(input.size(), testing::Gt(PARALLEL_LIST_CHUNK));
+
+  std::vector<std::uint32_t> output;
+  ASSERT_THAT(ParseList(input, ',', output), IsTrue());
+  ASSERT_THAT(output, SizeIs(count));
+  for (std::uint32_t value = 0; value < count; ++value) {
+    ASSERT_THAT(output[value], Eq(value));
+  }
+
+  // An invalid element anywhere fails the whole list.
+  input[input.size() / 2] = 'x';
+  EXPECT_THAT(ParseList(input, ',', output), IsFalse());
+  EXPECT_THAT(output, SizeIs(count));
+}
+
+} // namespace
+
+} // namespace asap::clap::detail
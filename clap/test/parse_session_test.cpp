@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/parse_session.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+#include "clap/parse_result.h"
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+namespace asap::clap {
+
+namespace {
+
+auto MakeCli() -> std::unique_ptr<Cli> {
+  return CliBuilder()
+      .ProgramName("daemon")
+      .WithCommand(CommandBuilder("cache", "evict")
+                       .WithOption(Option::WithKey("region")
+                                       .Long("region")
+                                       .WithValue<std::string>()
+                                       .Build())
+                       .WithOption(Option::WithKey("count")
+                                       .Short("n")
+                                       .WithValue<int>()
+                                       .Build()))
+      .WithCommand(
+          CommandBuilder("cache", "stats")
+              .WithOption(Option::WithKey("verbose")
+                              .Short("v")
+                              .WithValue<bool>()
+                              .Build())
+              .WithPositionalArguments(
+                  Option::Rest().WithValue<std::string>().Build()))
+      .Build();
+}
+
+template <std::size_t N>
+auto ParseArgs(ParseSession &session, std::array<const char *, N> &argv)
+    -> ParseResultView {
+  return session.Parse(static_cast<int>(N), argv.data());
+}
+
+// NOLINTNEXTLINE
+TEST(ParseSessionTest, ParsesSeveralCommandLines) {
+  const auto cli = MakeCli();
+  ParseSession session(*cli);
+
+  std::array<const char *, 7> evict{
+      {"daemon", "cache", "evict", "--region", "eu-west", "-n", "5"}};
+  const auto &first = ParseArgs(session, evict);
+  EXPECT_THAT(first.active_command->PathAsString(), Eq("cache evict"));
+  EXPECT_THAT(
+      first.ovm.ValuesOf("region").front().GetAs<std::string>(), Eq("eu-west"));
+  EXPECT_THAT(first.ovm.ValuesOf("count").front().GetAs<int>(), Eq(5));
+
+  std::array<const char *, 6> stats{
+      {"daemon", "cache", "stats", "-v", "hits", "misses"}};
+  const auto &second = ParseArgs(session, stats);
+  EXPECT_THAT(second.active_command->PathAsString(), Eq("cache stats"));
+  EXPECT_THAT(second.ovm.HasOption("verbose"), IsTrue());
+  // Nothing is left over from the previous command line.
+  EXPECT_THAT(second.ovm.HasOption("region"), IsFalse());
+  EXPECT_THAT(second.ovm.OccurrencesOf("count"), Eq(0));
+  const auto &rest = second.ovm.ValuesOf(Option::key_rest);
+  ASSERT_THAT(rest.size(), Eq(2));
+  EXPECT_THAT(rest[0].GetAs<std::string>(), Eq("hits"));
+  EXPECT_THAT(rest[1].GetAs<std::string>(), Eq("misses"));
+
+  const auto &third = ParseArgs(session, evict);
+  EXPECT_THAT(third.active_command->PathAsString(), Eq("cache evict"));
+  EXPECT_THAT(third.ovm.OccurrencesOf("region"), Eq(1));
+  EXPECT_THAT(third.ovm.HasOption(Option::key_rest), IsFalse());
+}
+
+// NOLINTNEXTLINE
+TEST(ParseSessionTest, RecoversFromParsingErrors) {
+  const auto cli = MakeCli();
+  ParseSession session(*cli);
+
+  // Fail in the middle of an option and in the middle of a command path, so
+  // that the parser is left in different states.
+  std::array<const char *, 5> bad_option{
+      {"daemon", "cache", "evict", "--region", "--bogus"}};
+  // NOLINTNEXTLINE(hicpp-avoid-goto, cppcoreguidelines-avoid-goto)
+  EXPECT_THROW(ParseArgs(session, bad_option), CmdLineArgumentsError);
+  std::array<const char *, 3> bad_command{{"daemon", "cache", "purge"}};
+  // NOLINTNEXTLINE(hicpp-avoid-goto, cppcoreguidelines-avoid-goto)
+  EXPECT_THROW(ParseArgs(session, bad_command), CmdLineArgumentsError);
+
+  std::array<const char *, 5> good{
+      {"daemon", "cache", "evict", "--region", "us-east"}};
+  const auto &context = ParseArgs(session, good);
+  EXPECT_THAT(context.active_command->PathAsString(), Eq("cache evict"));
+  EXPECT_THAT(context.ovm.OccurrencesOf("region"), Eq(1));
+  EXPECT_THAT(context.ovm.ValuesOf("region").front().GetAs<std::string>(),
+      Eq("us-east"));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseSessionTest, GivesSameResultsAsCli) {
+  const auto cli = MakeCli();
+  ParseSession session(*cli);
+
+  std::array<const char *, 5> argv{{"daemon", "cache", "stats", "a", "b"}};
+  const auto &from_session = ParseArgs(session, argv);
+  std::vector<std::string> session_rest;
+  for (const auto &value : from_session.ovm.ValuesOf(Option::key_rest)) {
+    session_rest.push_back(value.GetAs<std::string>());
+  }
+
+  const auto from_cli = cli->Parse(static_cast<int>(argv.size()), argv.data());
+  EXPECT_THAT(from_cli.active_command, Eq(from_session.active_command));
+  std::vector<std::string> cli_rest;
+  for (const auto &value : from_cli.ovm.ValuesOf(Option::key_rest)) {
+    cli_rest.push_back(value.GetAs<std::string>());
+  }
+  EXPECT_THAT(session_rest, ElementsAre("a", "b"));
+  EXPECT_THAT(cli_rest, Eq(session_rest));
+}
+
+struct EvictConfig {
+  std::string region;
+  int count{0};
+};
+
+// NOLINTNEXTLINE
+TEST(ParseSessionTest, ParsesIntoBoundConfigurations) {
+  const auto cli =
+      CliBuilder()
+          .ProgramName("daemon")
+          .WithCommand(CommandBuilder("evict")
+                           .WithOption(Option::WithKey("region")
+                                           .Long("region")
+                                           .WithValue<std::string>()
+                                           .Build())
+                           .WithOption(Option::WithKey("count")
+                                           .Short("n")
+                                           .WithValue<int>()
+                                           .Build())
+                           .BindTo<EvictConfig>()
+                           .Bind("region", &EvictConfig::region)
+                           .Bind("count", &EvictConfig::count))
+          .Build();
+  ParseSession session(*cli);
+
+  std::array<const char *, 6> first_args{
+      {"daemon", "evict", "--region", "eu-west", "-n", "5"}};
+  EvictConfig first;
+  const auto result = session.ParseInto(
+      first, static_cast<int>(first_args.size()), first_args.data());
+  EXPECT_THAT(result.program_name, Eq("daemon"));
+  EXPECT_THAT(result.active_command->PathAsString(), Eq("evict"));
+  EXPECT_THAT(first.region, Eq("eu-west"));
+  EXPECT_THAT(first.count, Eq(5));
+  // Bound values do not go to the option values map.
+  EXPECT_THAT(result.ovm.HasOption("region"), IsFalse());
+
+  // Options seen by the previous parse are not seen as repeated.
+  std::array<const char *, 4> second_args{
+      {"daemon", "evict", "--region", "us-east"}};
+  EvictConfig second;
+  static_cast<void>(session.ParseInto(
+      second, static_cast<int>(second_args.size()), second_args.data()));
+  EXPECT_THAT(second.region, Eq("us-east"));
+  EXPECT_THAT(second.count, Eq(0));
+  EXPECT_THAT(first.region, Eq("eu-west"));
+}
+
+} // namespace
+
+} // namespace asap::clap
@@ -6,12 +6,19 @@
 
 #include "clap/detail/parse_value.h"
 
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+using ::testing::DoubleEq;
 using ::testing::Eq;
+using ::testing::IsEmpty;
 using ::testing::IsFalse;
 using ::testing::IsTrue;
 
@@ -227,6 +234,271 @@ TEST_P(ParseCharErrorsTest, ParseWithError) {
   EXPECT_THAT(ParseValue(input, output), IsFalse());
 }
 
+// -----------------------------------------------------------------------------
+
+struct ParseIntegerTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<std::pair<std::string, int64_t>> {};
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(ValidInputValues, ParseIntegerTest,
+    testing::Values(
+        // clang-format off
+        std::make_pair("0", 0),
+        std::make_pair("-0", 0),
+        std::make_pair("+42", 42),
+        std::make_pair("010", 10),
+        std::make_pair("0x2A", 42),
+        std::make_pair("0Xff", 255),
+        std::make_pair("-0x10", -16),
+        std::make_pair("0o17", 15),
+        std::make_pair("0b1010", 10),
+        std::make_pair("-0B1", -1),
+        std::make_pair("1_000_000", 1000000),
+        std::make_pair("0xdead_beef", 0xdeadbeef),
+        std::make_pair("0b1111_0000", 240),
+        std::make_pair("9223372036854775807",
+            std::numeric_limits<int64_t>::max()),
+        std::make_pair("-9223372036854775808",
+            std::numeric_limits<int64_t>::min()),
+        std::make_pair("-0x8000_0000_0000_0000",
+            std::numeric_limits<int64_t>::min())
+    )); // clang-format on
+
+// NOLINTNEXTLINE
+TEST_P(ParseIntegerTest, ParseWithNoError) {
+  const auto &[input, expected] = GetParam();
+  int64_t output{0};
+  EXPECT_THAT(ParseInteger(input, output), Eq(NumberParseError::None));
+  EXPECT_THAT(output, Eq(expected));
+}
+
+struct ParseIntegerErrorsTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::pair<std::string, NumberParseError>> {};
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(InvalidInputValues, ParseIntegerErrorsTest,
+    testing::Values(
+        // clang-format off
+        std::make_pair("", NumberParseError::Empty),
+        std::make_pair("-", NumberParseError::MissingDigits),
+        std::make_pair("0x", NumberParseError::MissingDigits),
+        std::make_pair("--1", NumberParseError::InvalidDigit),
+        std::make_pair(" 1", NumberParseError::InvalidDigit),
+        std::make_pair("12a", NumberParseError::InvalidDigit),
+        std::make_pair("0b102", NumberParseError::InvalidDigit),
+        std::make_pair("0o8", NumberParseError::InvalidDigit),
+        std::make_pair("1.5", NumberParseError::InvalidDigit),
+        std::make_pair("99999999999999999999x",
+            NumberParseError::InvalidDigit),
+        std::make_pair("_1", NumberParseError::MisplacedSeparator),
+        std::make_pair("1_", NumberParseError::MisplacedSeparator),
+        std::make_pair("1__0", NumberParseError::MisplacedSeparator),
+        std::make_pair("0x_1", NumberParseError::MisplacedSeparator),
+        std::make_pair("32768", NumberParseError::OutOfRange),
+        std::make_pair("-32769", NumberParseError::OutOfRange),
+        std::make_pair("0xffff", NumberParseError::OutOfRange),
+        std::make_pair("99999999999999999999", NumberParseError::OutOfRange)
+    )); // clang-format on
+
+// NOLINTNEXTLINE
+TEST_P(ParseIntegerErrorsTest, ParseWithError) {
+  const auto &[input, expected] = GetParam();
+  constexpr int16_t untouched = 7;
+  int16_t output{untouched};
+  EXPECT_THAT(ParseInteger(input, output), Eq(expected));
+  EXPECT_THAT(output, Eq(untouched));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseInteger, UnsignedTypesRejectNegativeNumbers) {
+  uint64_t output{0};
+  EXPECT_THAT(
+      ParseInteger("-1", output), Eq(NumberParseError::NegativeUnsigned));
+  EXPECT_THAT(
+      ParseInteger("-0", output), Eq(NumberParseError::NegativeUnsigned));
+  EXPECT_THAT(ParseInteger("18446744073709551615", output),
+      Eq(NumberParseError::None));
+  EXPECT_THAT(output, Eq(std::numeric_limits<uint64_t>::max()));
+  EXPECT_THAT(ParseInteger("18446744073709551616", output),
+      Eq(NumberParseError::OutOfRange));
+  uint8_t small{0};
+  EXPECT_THAT(ParseInteger("0b1_0000_0000", small),
+      Eq(NumberParseError::OutOfRange));
+}
+
+// -----------------------------------------------------------------------------
+
+struct ParseFloatingPointTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<std::pair<std::string, double>> {};
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(ValidInputValues, ParseFloatingPointTest,
+    testing::Values(
+        // clang-format off
+        std::make_pair("0", 0.0),
+        std::make_pair("0.5", 0.5),
+        std::make_pair("+0.5", 0.5),
+        std::make_pair(".25", 0.25),
+        std::make_pair("-3.5", -3.5),
+        std::make_pair("6.02e23", 6.02e23),
+        std::make_pair("1E-3", 1e-3),
+        std::make_pair("0x1.8p1", 3.0),
+        std::make_pair("-0x10", -16.0)
+    )); // clang-format on
+
+// NOLINTNEXTLINE
+TEST_P(ParseFloatingPointTest, ParseWithNoError) {
+  const auto &[input, expected] = GetParam();
+  double output{0};
+  EXPECT_THAT(ParseFloatingPoint(input, output), Eq(NumberParseError::None));
+  EXPECT_THAT(output, DoubleEq(expected));
+  EXPECT_THAT(ParseValue(input, output), IsTrue());
+}
+
+struct ParseFloatingPointErrorsTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::pair<std::string, NumberParseError>> {};
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(InvalidInputValues, ParseFloatingPointErrorsTest,
+    testing::Values(
+        // clang-format off
+        std::make_pair("", NumberParseError::Empty),
+        std::make_pair("+", NumberParseError::MissingDigits),
+        std::make_pair("0x", NumberParseError::MissingDigits),
+        std::make_pair("+-1", NumberParseError::InvalidDigit),
+        std::make_pair(" 1", NumberParseError::InvalidDigit),
+        std::make_pair("1.5.2", NumberParseError::InvalidDigit),
+        std::make_pair("abc", NumberParseError::InvalidDigit),
+        std::make_pair("0xinf", NumberParseError::InvalidDigit),
+        std::make_pair("0XINF", NumberParseError::InvalidDigit),
+        std::make_pair("0xnan", NumberParseError::InvalidDigit),
+        std::make_pair("-0xnan", NumberParseError::InvalidDigit),
+        std::make_pair("0xg", NumberParseError::InvalidDigit),
+        std::make_pair("1e999", NumberParseError::OutOfRange)
+    )); // clang-format on
+
+// NOLINTNEXTLINE
+TEST_P(ParseFloatingPointErrorsTest, ParseWithError) {
+  const auto &[input, expected] = GetParam();
+  constexpr double untouched = 7.0;
+  double output{untouched};
+  EXPECT_THAT(ParseFloatingPoint(input, output), Eq(expected));
+  EXPECT_THAT(output, DoubleEq(untouched));
+}
+
+// -----------------------------------------------------------------------------
+
+enum class Color { red = 1, Green = 2, BLUE = 3 };
+
+struct ParseEnumTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<std::pair<std::string, Color>> {};
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(ValidInputValues, ParseEnumTest,
+    testing::Values(
+        // clang-format off
+        std::make_pair("red", Color::red),
+        std::make_pair("RED", Color::red),
+        std::make_pair("green", Color::Green),
+        std::make_pair("Blue", Color::BLUE),
+        std::make_pair("2", Color::Green),
+        std::make_pair("0x3", Color::BLUE)
+    )); // clang-format on
+
+// NOLINTNEXTLINE
+TEST_P(ParseEnumTest, ParseWithNoError) {
+  const auto &[input, expected] = GetParam();
+  Color output{Color::red};
+  EXPECT_THAT(ParseValue(input, output), IsTrue());
+  EXPECT_THAT(output, Eq(expected));
+}
+
+struct ParseEnumErrorsTest : public ::testing::Test,
+                             public ::testing::WithParamInterface<std::string> {
+};
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(InvalidInputValues, ParseEnumErrorsTest,
+    testing::Values(
+        // clang-format off
+        "",
+        "redd",
+        "re",
+        "yellow",
+        "4")
+    ); // clang-format on
+
+// NOLINTNEXTLINE
+TEST_P(ParseEnumErrorsTest, ParseWithError) {
+  const auto &input = GetParam();
+  Color output{Color::red};
+  EXPECT_THAT(ParseValue(input, output), IsFalse());
+}
+
+// Names which differ only by their case are matched exactly.
+enum class Shade { Red, RED, dark };
+
+// NOLINTNEXTLINE
+TEST(ParseEnum, NamesEqualIgnoringCaseAreMatchedExactly) {
+  Shade output{Shade::dark};
+  EXPECT_THAT(ParseValue("RED", output), IsTrue());
+  EXPECT_THAT(output, Eq(Shade::RED));
+  EXPECT_THAT(ParseValue("Red", output), IsTrue());
+  EXPECT_THAT(output, Eq(Shade::Red));
+  EXPECT_THAT(ParseValue("dark", output), IsTrue());
+  EXPECT_THAT(output, Eq(Shade::dark));
+  for (const auto *input : {"red", "DARK", "rEd"}) {
+    EXPECT_THAT(ParseValue(input, output), IsFalse()) << input;
+  }
+
+  FlagSet<Shade> shades;
+  EXPECT_THAT(ParseValue("RED,dark", shades), IsTrue());
+  EXPECT_THAT(shades, Eq(FlagSet<Shade>{Shade::RED, Shade::dark}));
+  EXPECT_THAT(ParseValue("red", shades), IsFalse());
+}
+
+// -----------------------------------------------------------------------------
+
+// NOLINTNEXTLINE
+TEST(ParseFlagSet, ParsesCommaSeparatedNamesInAnyCase) {
+  FlagSet<Color> output;
+  EXPECT_THAT(ParseValue("blue,RED", output), IsTrue());
+  EXPECT_THAT(output, Eq(FlagSet<Color>{Color::red, Color::BLUE}));
+  EXPECT_THAT(output.Test(Color::Green), IsFalse());
+  EXPECT_THAT(output.Count(), Eq(2));
+
+  std::ostringstream printed;
+  printed << output;
+  EXPECT_THAT(printed.str(), Eq("red,BLUE"));
+}
+
+// NOLINTNEXTLINE
+TEST(ParseFlagSet, EmptyValueIsAnEmptySet) {
+  FlagSet<Color> output{Color::red};
+  EXPECT_THAT(ParseValue("", output), IsTrue());
+  EXPECT_THAT(output.None(), IsTrue());
+  std::ostringstream printed;
+  printed << output;
+  EXPECT_THAT(printed.str(), IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(ParseFlagSet, RejectsUnknownOrEmptyNames) {
+  const FlagSet<Color> initial{Color::Green};
+  for (const auto *input : {"red,yellow", "red,", ",red", "red,,blue", "1"}) {
+    FlagSet<Color> output{initial};
+    EXPECT_THAT(ParseValue(input, output), IsFalse()) << input;
+    EXPECT_THAT(output, Eq(initial)) << input;
+  }
+}
+
 } // namespace
 
 } // namespace asap::clap::detail
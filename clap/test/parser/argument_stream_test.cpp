@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "parser/argument_stream.h"
+#include "parser/tokenizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::ElementsAre;
+using testing::Eq;
+
+namespace asap::clap::parser {
+
+namespace {
+
+using namespace std::string_literals;
+
+/*
+ * Make a source producing the given data in chunks of at most `chunk_size`
+ * bytes, to simulate a pipe.
+ */
+auto ChunkedSource(std::string data, std::size_t chunk_size,
+    ArgumentDelimiter delimiter = ArgumentDelimiter::Nul) -> ArgumentSource {
+  return ArgumentSource::FromCallback(
+      [data = std::move(data), chunk_size, position = std::size_t{0}](
+          char *buffer, std::size_t size) mutable {
+        const auto count =
+            std::min({size, chunk_size, data.size() - position});
+        std::memcpy(buffer, data.data() + position, count);
+        position += count;
+        return count;
+      },
+      delimiter);
+}
+
+auto AllArguments(ArgumentStream &stream) -> std::vector<std::string> {
+  std::vector<std::string> args;
+  std::string_view arg;
+  while (stream.NextArgument(arg)) {
+    args.emplace_back(arg);
+  }
+  return args;
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, EmptySource) {
+  ArgumentStream stream{ChunkedSource("", 1)};
+  EXPECT_THAT(AllArguments(stream).size(), Eq(0));
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, NulDelimitedArguments) {
+  ArgumentStream stream{ChunkedSource("-x\0with space\0\0last"s, 3)};
+  EXPECT_THAT(
+      AllArguments(stream), ElementsAre("-x", "with space", "", "last"));
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, NewlineDelimitedArguments) {
+  ArgumentStream stream{
+      ChunkedSource("first\nsecond\n", 1, ArgumentDelimiter::Newline)};
+  EXPECT_THAT(AllArguments(stream), ElementsAre("first", "second"));
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, ArgumentsStraddlingBlocks) {
+  // Arguments of varying length, some longer than a block, read in odd sized
+  // chunks so that arguments keep straddling the end of the blocks.
+  std::vector<std::string> expected;
+  std::string data;
+  for (std::size_t index = 0; index < 200; ++index) {
+    expected.emplace_back(
+        (index % 50 == 0) ? 3 * ArgumentStream::BLOCK_SIZE : 1000 + index,
+        static_cast<char>('a' + index % 26));
+    data.append(expected.back()).push_back('\0');
+  }
+  ArgumentStream stream{ChunkedSource(data, 4093)};
+  EXPECT_THAT(AllArguments(stream), Eq(expected));
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, ArgumentsRemainValid) {
+  std::string data;
+  for (std::size_t index = 0; index < 100000; ++index) {
+    data.append(std::to_string(index)).push_back('\0');
+  }
+  ArgumentStream stream{ChunkedSource(data, 10000)};
+  std::vector<std::string_view> args;
+  std::string_view arg;
+  while (stream.NextArgument(arg)) {
+    args.push_back(arg);
+  }
+  ASSERT_THAT(args.size(), Eq(100000));
+  for (std::size_t index = 0; index < args.size(); ++index) {
+    ASSERT_THAT(args[index], Eq(std::to_string(index)));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, TokenizerReadsSourceLazily) {
+  // The source fails if it is read past the first chunk, so the first tokens
+  // can only be obtained if the tokenizer does not read the whole input.
+  bool first_read = true;
+  auto source = ArgumentSource::FromCallback(
+      [&first_read](char *buffer, std::size_t size) -> std::size_t {
+        if (!first_read) {
+          throw std::runtime_error("input is not ready");
+        }
+        first_read = false;
+        const auto data = "--opt=value\0file"s;
+        const auto count = std::min(size, data.size());
+        std::memcpy(buffer, data.data(), count);
+        return count;
+      });
+  const Tokenizer tokenizer{{"command"}, std::move(source)};
+
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::Value, "command"}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::LongOption, "opt"}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::EqualSign, "="}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::Value, "value"}));
+  EXPECT_THROW(tokenizer.NextToken(), TokenizerError);
+}
+
+// NOLINTNEXTLINE
+TEST(ArgumentStream, TokenizerExpandsResponseFilesOnlyIfEnabled) {
+  const Tokenizer tokenizer{{}, ChunkedSource("@__no_such_file__\0-"s, 5)};
+  EXPECT_THAT(tokenizer.NextToken(),
+      Eq(Token{TokenType::Value, "@__no_such_file__"}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::LoneDash, "-"}));
+  EXPECT_THAT(tokenizer.NextToken().first, Eq(TokenType::EndOfInput));
+  EXPECT_THAT(tokenizer.HasMoreTokens(), Eq(false));
+}
+
+} // namespace
+
+} // namespace asap::clap::parser
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "parser/classifier.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::Eq;
+using testing::SizeIs;
+
+namespace asap::clap::parser {
+
+namespace {
+
+constexpr auto NO_EQUAL_SIGN = ArgumentsClassification::NO_EQUAL_SIGN;
+
+// NOLINTNEXTLINE
+TEST(ClassifyArguments, NoArguments) {
+  const auto classification = ClassifyArguments({});
+  EXPECT_THAT(classification.types, SizeIs(0));
+  EXPECT_THAT(classification.equal_signs, SizeIs(0));
+}
+
+// NOLINTNEXTLINE
+TEST(ClassifyArguments, ClassifiesEachArgument) {
+  const auto classification = ClassifyArguments({"", "value", "-", "--",
+      "-abc", "--name", "--name=value", "--=", "--=x=y", "-a=b", "=x"});
+
+  EXPECT_THAT(classification.types,
+      testing::ElementsAre(TokenType::EndOfInput, TokenType::Value,
+          TokenType::LoneDash, TokenType::DashDash, TokenType::ShortOption,
+          TokenType::LongOption, TokenType::LongOption, TokenType::LongOption,
+          TokenType::LongOption, TokenType::ShortOption, TokenType::Value));
+  EXPECT_THAT(classification.equal_signs,
+      testing::ElementsAre(NO_EQUAL_SIGN, NO_EQUAL_SIGN, NO_EQUAL_SIGN,
+          NO_EQUAL_SIGN, NO_EQUAL_SIGN, NO_EQUAL_SIGN, 6, NO_EQUAL_SIGN, 4,
+          NO_EQUAL_SIGN, NO_EQUAL_SIGN));
+}
+
+// NOLINTNEXTLINE
+TEST(ClassifyArguments, LargeListsOfArguments) {
+  // Mostly values, with a few options and empty arguments scattered around
+  // (including at batch boundaries), and a tail that does not fill a batch.
+  constexpr std::size_t count = 1000;
+  std::vector<std::string_view> args(count, "some/path/to/a/file.txt");
+  args[0] = "--first=1";
+  args[31] = "-x";
+  args[32] = "";
+  args[500] = "--";
+  args[998] = "-";
+  args[999] = "--last";
+
+  const auto classification = ClassifyArguments(args);
+  ASSERT_THAT(classification.types, SizeIs(count));
+  for (std::size_t index = 0; index < count; ++index) {
+    switch (index) {
+    case 0:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::LongOption));
+      EXPECT_THAT(classification.equal_signs[index], Eq(7));
+      break;
+    case 31:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::ShortOption));
+      break;
+    case 32:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::EndOfInput));
+      break;
+    case 500:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::DashDash));
+      break;
+    case 998:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::LoneDash));
+      break;
+    case 999:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::LongOption));
+      EXPECT_THAT(classification.equal_signs[index], Eq(NO_EQUAL_SIGN));
+      break;
+    default:
+      EXPECT_THAT(classification.types[index], Eq(TokenType::Value))
+          << "argument at index " << index;
+    }
+  }
+}
+
+} // namespace
+
+} // namespace asap::clap::parser
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "parser/command_trie.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "clap/fluent/dsl.h"
+
+using testing::Eq;
+using testing::IsFalse;
+using testing::IsNull;
+using testing::IsTrue;
+using testing::NotNull;
+
+namespace asap::clap::parser {
+
+namespace {
+
+// NOLINTNEXTLINE
+TEST(CommandTrie, FindsCommandsOneSegmentAtATime) {
+  const CommandTrie::CommandsList commands{CommandBuilder(Command::DEFAULT),
+      CommandBuilder("remote"), CommandBuilder("remote", "add"),
+      CommandBuilder("config", "user", "name")};
+  const CommandTrie trie(commands);
+
+  CommandTrie::NodeId remote{};
+  ASSERT_THAT(trie.FindChild(CommandTrie::ROOT, "remote", remote), IsTrue());
+  ASSERT_THAT(trie.CommandAt(remote), NotNull());
+  EXPECT_THAT(trie.CommandAt(remote), Eq(&commands[1]));
+  CommandTrie::NodeId add{};
+  ASSERT_THAT(trie.FindChild(remote, "add", add), IsTrue());
+  EXPECT_THAT(trie.CommandAt(add), Eq(&commands[2]));
+  EXPECT_THAT(trie.FindChild(add, "origin", add), IsFalse());
+
+  // Intermediate segments of a command path do not have a command.
+  CommandTrie::NodeId config{};
+  ASSERT_THAT(trie.FindChild(CommandTrie::ROOT, "config", config), IsTrue());
+  EXPECT_THAT(trie.CommandAt(config), IsNull());
+  CommandTrie::NodeId user{};
+  EXPECT_THAT(trie.FindChild(CommandTrie::ROOT, "user", user), IsFalse());
+  ASSERT_THAT(trie.FindChild(config, "user", user), IsTrue());
+  EXPECT_THAT(trie.CommandAt(user), IsNull());
+  CommandTrie::NodeId name{};
+  ASSERT_THAT(trie.FindChild(user, "name", name), IsTrue());
+  EXPECT_THAT(trie.CommandAt(name), Eq(&commands[3]));
+}
+
+// NOLINTNEXTLINE
+TEST(CommandTrie, KeepsTheDefaultCommand) {
+  const CommandTrie::CommandsList commands{
+      CommandBuilder("run"), CommandBuilder(Command::DEFAULT)};
+  const CommandTrie trie(commands);
+  EXPECT_THAT(trie.DefaultCommand(), Eq(&commands[1]));
+  EXPECT_THAT(trie.CommandAt(CommandTrie::ROOT), IsNull());
+
+  const CommandTrie::CommandsList no_default{CommandBuilder("run")};
+  EXPECT_THAT(CommandTrie(no_default).DefaultCommand(), IsNull());
+}
+
+// NOLINTNEXTLINE
+TEST(CommandTrie, LastCommandWithSamePathWins) {
+  const CommandTrie::CommandsList commands{
+      CommandBuilder("do", "it"), CommandBuilder("do", "it")};
+  const CommandTrie trie(commands);
+  CommandTrie::NodeId node{};
+  ASSERT_THAT(trie.FindChild(CommandTrie::ROOT, "do", node), IsTrue());
+  ASSERT_THAT(trie.FindChild(node, "it", node), IsTrue());
+  EXPECT_THAT(trie.CommandAt(node), Eq(&commands[1]));
+}
+
+} // namespace
+
+} // namespace asap::clap::parser
@@ -0,0 +1,294 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Reference state machine based implementation of the command line
+ * arguments tokenizer.
+ */
+
+#include "./fsm_tokenizer.h"
+
+#include <functional>
+#include <utility>
+
+#include <fsm/fsm.h>
+
+using asap::fsm::ByDefault;
+using asap::fsm::Continue;
+using asap::fsm::DoNothing;
+using asap::fsm::Maybe;
+using asap::fsm::On;
+using asap::fsm::OneOf;
+using asap::fsm::StateMachine;
+using asap::fsm::Status;
+using asap::fsm::TransitionTo;
+using asap::fsm::Will;
+
+namespace asap::clap::parser::reference {
+
+namespace {
+
+class InputChar {
+public:
+  InputChar(char character, std::size_t position)
+      : value{character}, offset{position} {
+  }
+
+  [[nodiscard]] auto Value() const -> char {
+    return value;
+  }
+
+  [[nodiscard]] auto Position() const -> std::size_t {
+    return offset;
+  }
+
+private:
+  char value;
+  std::size_t offset;
+};
+struct InputEnd {};
+
+/*
+ * Tokens are reported as a (position, length) pair relative to the start of
+ * the argument being tokenized, so that the tokenizer can produce views into
+ * that argument instead of copies of its characters.
+ */
+using TokenConsumer = std::function<void(
+    TokenType token_type, std::size_t position, std::size_t length)>;
+
+struct InitialState;
+struct ValueState;
+struct OptionState;
+struct ShortOptionState;
+struct LongOptionState;
+struct DashDashState;
+struct FinalState;
+
+struct FinalState : public Will<ByDefault<DoNothing>> {
+  [[maybe_unused]] static auto OnEnter(const InputEnd & /*event*/) -> Status {
+    return Continue{};
+  }
+};
+
+struct InitialState : public ByDefault<TransitionTo<FinalState>> {
+  using ByDefault::Handle;
+
+  template <typename Event>
+  static auto OnLeave(const Event & /*event*/) -> Status {
+    return Continue{};
+  }
+
+  [[maybe_unused]] static auto Handle(const InputChar &event)
+      -> OneOf<TransitionTo<ValueState>, TransitionTo<OptionState>> {
+    switch (event.Value()) {
+    case '-':
+      return TransitionTo<OptionState>{};
+    default:
+      return TransitionTo<ValueState>{};
+    }
+  }
+};
+
+struct ValueState : public On<InputEnd, TransitionTo<FinalState>> {
+  using On::Handle;
+
+  explicit ValueState(TokenConsumer callback)
+      : consume_token_{std::move(callback)} {
+  }
+
+  [[maybe_unused]] auto OnEnter(const InputChar &event) -> Status {
+    start_ = event.Position();
+    length_ = 1;
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto OnLeave(const InputEnd & /*event*/) -> Status {
+    consume_token_(TokenType::Value, start_, length_);
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto Handle(const InputChar & /*event*/) -> DoNothing {
+    ++length_;
+    return DoNothing{};
+  }
+
+private:
+  std::size_t start_{0};
+  std::size_t length_{0};
+  TokenConsumer consume_token_;
+};
+
+struct OptionState {
+
+  explicit OptionState(TokenConsumer callback)
+      : consume_token_{std::move(callback)} {
+  }
+
+  [[maybe_unused]] static auto OnEnter(const InputChar & /*event*/) -> Status {
+    return Continue{};
+  }
+
+  template <typename Event>
+  static auto OnLeave(const Event & /*event*/) -> Status {
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto Handle([[maybe_unused]] const InputEnd &event)
+      -> TransitionTo<FinalState> {
+    consume_token_(TokenType::LoneDash, 0, 1);
+    return TransitionTo<FinalState>{};
+  }
+
+  [[maybe_unused]] static auto Handle(const InputChar &event)
+      -> OneOf<TransitionTo<DashDashState>, TransitionTo<ShortOptionState>> {
+    switch (event.Value()) {
+    case '-':
+      return TransitionTo<DashDashState>{};
+    default:
+      return TransitionTo<ShortOptionState>{};
+    }
+  }
+
+private:
+  TokenConsumer consume_token_;
+};
+
+struct ShortOptionState : public On<InputEnd, TransitionTo<FinalState>> {
+  using On::Handle;
+
+  explicit ShortOptionState(TokenConsumer callback)
+      : consume_token_{std::move(callback)} {
+  }
+
+  [[maybe_unused]] auto OnEnter(const InputChar &event) -> Status {
+    consume_token_(TokenType::ShortOption, event.Position(), 1);
+    return Continue{};
+  }
+
+  template <typename Event>
+  static auto OnLeave(const Event & /*event*/) -> Status {
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto Handle(const InputChar &event) -> DoNothing {
+    consume_token_(TokenType::ShortOption, event.Position(), 1);
+    return DoNothing{};
+  }
+
+private:
+  TokenConsumer consume_token_;
+};
+
+struct DashDashState : On<InputChar, TransitionTo<LongOptionState>> {
+  using On::Handle;
+
+  explicit DashDashState(TokenConsumer callback)
+      : consume_token_{std::move(callback)} {
+  }
+
+  [[maybe_unused]] static auto OnEnter(const InputChar & /*event*/) -> Status {
+    return Continue{};
+  }
+
+  template <typename Event>
+  static auto OnLeave(const Event & /*event*/) -> Status {
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto Handle([[maybe_unused]] const InputEnd &event)
+      -> TransitionTo<FinalState> {
+    consume_token_(TokenType::DashDash, 0, 2);
+    return TransitionTo<FinalState>{};
+  }
+
+private:
+  TokenConsumer consume_token_;
+};
+
+struct LongOptionState : public On<InputEnd, TransitionTo<FinalState>> {
+  using On::Handle;
+
+  explicit LongOptionState(TokenConsumer callback)
+      : consume_token_{std::move(callback)} {
+  }
+
+  [[maybe_unused]] auto OnEnter(const InputChar &event) -> Status {
+    start_ = event.Position();
+    length_ = 1;
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto OnLeave(const InputEnd & /*event*/) -> Status {
+    // If the option was followed by an '=' sign, its name has already been
+    // consumed.
+    if (!after_equal_sign) {
+      consume_token_(TokenType::LongOption, start_, length_);
+    }
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto OnLeave(const InputChar & /*event*/) -> Status {
+    after_equal_sign = false;
+    return Continue{};
+  }
+
+  [[maybe_unused]] auto Handle(const InputChar &event)
+      -> Maybe<TransitionTo<ValueState>> {
+    switch (event.Value()) {
+    case '=':
+      if (after_equal_sign) {
+        // Any '=' after the first one is part of the value
+        return TransitionTo<ValueState>{};
+      }
+      consume_token_(TokenType::LongOption, start_, length_);
+      consume_token_(TokenType::EqualSign, event.Position(), 1);
+      after_equal_sign = true;
+      break;
+    default:
+      if (after_equal_sign) {
+        return TransitionTo<ValueState>{};
+      }
+      ++length_;
+    }
+    return DoNothing{};
+  }
+
+private:
+  std::size_t start_{0};
+  std::size_t length_{0};
+  bool after_equal_sign{false};
+  TokenConsumer consume_token_;
+};
+
+} // namespace
+
+auto FsmTokenize(std::string_view arg) -> std::vector<Token> {
+  std::vector<Token> tokens;
+
+  const TokenConsumer consume_token = [&tokens, arg](TokenType token_type,
+                                          std::size_t position,
+                                          std::size_t length) -> void {
+    tokens.emplace_back(token_type, arg.substr(position, length));
+  };
+
+  StateMachine<InitialState, ValueState, OptionState, ShortOptionState,
+      DashDashState, LongOptionState, FinalState>
+      machine{InitialState{}, ValueState{consume_token},
+          OptionState{consume_token}, ShortOptionState{consume_token},
+          DashDashState{consume_token}, LongOptionState{consume_token},
+          FinalState{}};
+
+  for (std::size_t position = 0; position < arg.size(); ++position) {
+    machine.Handle(InputChar{arg[position], position});
+  }
+  machine.Handle(InputEnd{});
+
+  return tokens;
+}
+
+} // namespace asap::clap::parser::reference
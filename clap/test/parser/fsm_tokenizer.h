@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Reference state machine based implementation of the command line
+ * arguments tokenizer, used to verify the production tokenizer.
+ */
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "parser/tokenizer.h"
+
+namespace asap::clap::parser::reference {
+
+/*!
+ * \brief Tokenize a single command line argument, one character at a time,
+ * using a finite state machine.
+ *
+ * This is the original implementation of the tokenizer, kept as a reference to
+ * check that the table-driven scanner in `Tokenizer` produces exactly the same
+ * tokens.
+ */
+auto FsmTokenize(std::string_view arg) -> std::vector<Token>;
+
+} // namespace asap::clap::parser::reference
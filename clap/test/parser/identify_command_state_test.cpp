@@ -17,16 +17,11 @@ namespace {
 
 class IdentifyCommandStateTest : public StateTest {
 protected:
-  void SetUp() override {
-    StateTest::SetUp();
-    state_ = std::make_unique<IdentifyCommandState>();
-  }
-
-  void EnterState(const Token &token, const ParserContextPtr &context) const {
+  void EnterState(const Token &token) const {
     const auto &[token_type, token_value] = token;
     EXPECT_THAT(token_type, Eq(TokenType::Value));
     const auto first_event = TokenEvent<TokenType::Value>(token_value);
-    state_->OnEnter(first_event, context);
+    state_->OnEnter(first_event);
   }
 
   void LeaveState() const override {
@@ -34,24 +29,30 @@ protected:
     state_->OnLeave(last_event);
   }
 
-  [[nodiscard]] auto state() const
-      -> const std::unique_ptr<IdentifyCommandState> & {
+  [[nodiscard]] auto state() -> std::unique_ptr<IdentifyCommandState> & {
     return state_;
   }
 
   void DoCheckStateAfterLastToken(const TestValueType &test_value) {
-    const auto &[command_paths, args, action_check, state_check] = test_value;
-
-    const Tokenizer tokenizer(args);
+    const auto &command_paths = std::get<0>(test_value);
     const auto commands = BuildCommands(command_paths);
     OptionValuesMap ovm;
     Command::Ptr command;
     const CommandLineContext base_context("test", command, ovm);
-    const auto context = ParserContext::New(base_context, commands);
-    EnterState(tokenizer.NextToken(), context);
+    const CommandTrie command_trie(commands);
+    ParserContext context(base_context, command_trie);
+    state_ = std::make_unique<IdentifyCommandState>(context);
+    RunScenario(test_value, context);
+  }
+
+  void RunScenario(const TestValueType &test_value, ParserContext &context) {
+    const auto &[command_paths, args, action_check, state_check] = test_value;
+
+    const Tokenizer tokenizer({args.cbegin(), args.cend()});
+    EnterState(tokenizer.NextToken());
     while (true) {
       auto token = tokenizer.NextToken();
-      if (!ProcessToken(token, state(), action_check, state_check)) {
+      if (!ProcessToken(token, state(), context, action_check, state_check)) {
         break;
       }
     }
@@ -73,7 +74,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios,
         TestValueType{
             {"just"},
             {"just"},
-            FinalStateTransitionTestData{"just"},
+            FinalStateTransitionTestData{"just", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
@@ -85,49 +86,49 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios,
         TestValueType{
             {"just"},
             {"just", "--hi"},
-            ParseOptionsTransitionTestData{"just", {}},
+            ParseLongOptionTransitionTestData{"just", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"just"},
             {"just", "--"},
-            DashDashTransitionTestData{"just"},
+            DashDashTransitionTestData{"just", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"just", "just do"},
             {"just", "do"},
-            FinalStateTransitionTestData{"just do"},
+            FinalStateTransitionTestData{"just do", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"just do", "just do it"},
             {"just", "do"},
-            FinalStateTransitionTestData{"just do"},
+            FinalStateTransitionTestData{"just do", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"just", "just do it"},
             {"just", "do", "it"},
-            FinalStateTransitionTestData{"just do it"},
+            FinalStateTransitionTestData{"just do it", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"just", "just do it", "just do nothing"},
             {"just", "do", "it"},
-            FinalStateTransitionTestData{"just do it"},
+            FinalStateTransitionTestData{"just do it", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"justice", "just"},
             {"just"},
-            FinalStateTransitionTestData{"just"},
+            FinalStateTransitionTestData{"just", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType{
             {"default", "just", "just do it", "just it"},
             {"just", "it"},
-            FinalStateTransitionTestData{"just it"},
+            FinalStateTransitionTestData{"just it", {}},
             IdentifyCommandStateTestData{}
         } // clang-format on
         ));
@@ -140,19 +141,19 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenariosWithOptions,
         TestValueType {
             {"just", "just do it"},
             {"just", "-f", "--test"},
-            ParseOptionsTransitionTestData{"just", {}},
+            ParseShortOptionTransitionTestData{"just", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
             {"just", "just do it"},
             {"just", "do", "it", "-v"},
-            ParseOptionsTransitionTestData{"just do it", {}},
+            ParseShortOptionTransitionTestData{"just do it", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
             {"just", "just do it"},
             {"just", "--", "it", "-v"},
-            DashDashTransitionTestData{"just"},
+            DashDashTransitionTestData{"just", {}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
@@ -171,31 +172,31 @@ INSTANTIATE_TEST_SUITE_P(BacktrackScenarios,
         TestValueType {
             {"default", "just do it"},
             {"just", "do", "--test"},
-            ParseOptionsTransitionTestData{"default", {"just", "do"}},
+            ParseLongOptionTransitionTestData{"default", {"just", "do"}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
             {"default", "just do it"},
             {"just", "do", "--"},
-            ParseOptionsTransitionTestData{"default", {"just", "do"}},
+            DashDashTransitionTestData{"default", {"just", "do"}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
             {"default", "just do it"},
             {"just", "do"},
-            ParseOptionsTransitionTestData{"default", {"just", "do"}},
+            FinalStateTransitionTestData{"default", {"just", "do"}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
             {"default", "just do it"},
             {"just"},
-            ParseOptionsTransitionTestData{"default", {"just"}},
+            FinalStateTransitionTestData{"default", {"just"}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
             {"default", "just do it"},
             {"just", "--", "something"},
-            ParseOptionsTransitionTestData{"default", {"just"}},
+            DashDashTransitionTestData{"default", {"just"}},
             IdentifyCommandStateTestData{}
         },
         TestValueType {
@@ -261,10 +262,19 @@ TEST_P(IdentifyCommandStateErrorsTest, CheckStateAfterLastToken) {
 // NOLINTNEXTLINE
 TEST_F(IdentifyCommandStateTest, OnLeaveResetsTheState) {
   const auto test_value = TestValueType{{"default", "just do it"},
-      {"just", "do"}, ParseOptionsTransitionTestData{"default", {"just", "do"}},
+      {"just", "do"},
+      FinalStateTransitionTestData{"default", {"just", "do"}},
       IdentifyCommandStateTestData{}};
-  DoCheckStateAfterLastToken(test_value);
-  DoCheckStateAfterLastToken(test_value);
+  const auto commands = BuildCommands(std::get<0>(test_value));
+  OptionValuesMap ovm;
+  Command::Ptr command;
+  const CommandLineContext base_context("test", command, ovm);
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  state() = std::make_unique<IdentifyCommandState>(context);
+  RunScenario(test_value, context);
+  context.positional_tokens.clear();
+  RunScenario(test_value, context);
 }
 } // namespace
 
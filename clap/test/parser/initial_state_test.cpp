@@ -13,7 +13,7 @@ namespace {
 
 class InitialStateTest : public StateTest {
 protected:
-  void SetupInitialState(ParserContextPtr &context) {
+  void SetupInitialState(ParserContext &context) {
     state_ = std::make_unique<InitialState>(context);
   }
 
@@ -24,17 +24,18 @@ protected:
   void DoCheckStateAfterLastToken(const TestValueType &test_value) {
     const auto &[command_paths, args, action_check, state_check] = test_value;
 
-    const Tokenizer tokenizer(args);
+    const Tokenizer tokenizer({args.cbegin(), args.cend()});
     const auto commands = BuildCommands(command_paths);
     OptionValuesMap ovm;
     Command::Ptr command;
     const CommandLineContext base_context("test", command, ovm);
-    auto context = ParserContext::New(base_context, commands);
+    const CommandTrie command_trie(commands);
+    ParserContext context(base_context, command_trie);
     SetupInitialState(context);
     std::get<InitialStateTestData>(state_check).Check(state());
     while (true) {
       auto token = tokenizer.NextToken();
-      if (!ProcessToken(token, state(), action_check, state_check)) {
+      if (!ProcessToken(token, state(), context, action_check, state_check)) {
         break;
       }
     }
@@ -55,7 +56,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, InitialStateTransitionsTest,
         TestValueType {
             {"default"},
             {},
-            FinalStateTransitionTestData{"default"},
+            FinalStateTransitionTestData{"default", {}},
             InitialStateTestData{{
               StateTest::predefined_commands().at("default")
             }}
@@ -63,7 +64,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, InitialStateTransitionsTest,
         TestValueType {
             {"default", "just"},
             {},
-            FinalStateTransitionTestData{"default"},
+            FinalStateTransitionTestData{"default", {}},
             InitialStateTestData{{
               StateTest::predefined_commands().at("default"),
               StateTest::predefined_commands().at("just")
@@ -72,7 +73,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, InitialStateTransitionsTest,
         TestValueType {
             {"default"},
             {"--xx"},
-            ParseOptionsTransitionTestData{"default", {}},
+            ParseLongOptionTransitionTestData{"default", {}},
             InitialStateTestData{{
               StateTest::predefined_commands().at("default")
             }}
@@ -80,7 +81,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, InitialStateTransitionsTest,
         TestValueType {
             {"default"},
             {"--x"},
-            ParseOptionsTransitionTestData{"default", {}},
+            ParseLongOptionTransitionTestData{"default", {}},
             InitialStateTestData{{
               StateTest::predefined_commands().at("default")
             }}
@@ -88,7 +89,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, InitialStateTransitionsTest,
         TestValueType {
             {"default"},
             {"--"},
-            DashDashTransitionTestData{"default"},
+            DashDashTransitionTestData{"default", {}},
             InitialStateTestData{{
               StateTest::predefined_commands().at("default")
             }}
@@ -96,7 +97,7 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, InitialStateTransitionsTest,
         TestValueType {
             {"default"},
             {"-"},
-            ParseOptionsTransitionTestData{"default", {}},
+            ParseShortOptionTransitionTestData{"default", {}},
             InitialStateTestData{{
               StateTest::predefined_commands().at("default")
             }}
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "parser/line_splitter.h"
+#include "parser/tokenizer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::ElementsAreArray;
+using testing::Eq;
+using testing::IsTrue;
+
+namespace asap::clap::parser {
+
+namespace {
+
+auto AllArguments(std::string_view line) -> std::vector<std::string> {
+  LineSplitter splitter{line};
+  std::vector<std::string> args;
+  std::string_view arg;
+  while (splitter.NextArgument(arg)) {
+    args.emplace_back(arg);
+  }
+  return args;
+}
+
+// NOLINTNEXTLINE
+class LineSplitterTest
+    : public ::testing::TestWithParam<
+          std::pair<std::string, std::vector<std::string>>> {};
+
+// NOLINTNEXTLINE
+TEST_P(LineSplitterTest, SplitsLikeAPosixShell) {
+  const auto &[line, expected] = GetParam();
+  EXPECT_THAT(AllArguments(line), ElementsAreArray(expected));
+}
+
+// NOLINTNEXTLINE
+INSTANTIATE_TEST_SUITE_P(SplitLine, LineSplitterTest,
+    // clang-format off
+    ::testing::Values(
+        std::make_pair("", std::vector<std::string>{}),
+        std::make_pair(" \t\n ", std::vector<std::string>{}),
+        std::make_pair("cache evict --region \"eu west\" -n 5",
+            std::vector<std::string>{
+                "cache", "evict", "--region", "eu west", "-n", "5"}),
+        std::make_pair("  leading and   trailing  ",
+            std::vector<std::string>{"leading", "and", "trailing"}),
+        std::make_pair("'single $quoted \\ \"text\"'",
+            std::vector<std::string>{"single $quoted \\ \"text\""}),
+        std::make_pair("\"a \\\"b\\\" \\$c \\\\ \\d\"",
+            std::vector<std::string>{"a \"b\" $c \\ \\d"}),
+        std::make_pair("es\\ caped\\'s \\\"x",
+            std::vector<std::string>{"es caped's", "\"x"}),
+        std::make_pair("con'cat'\"en\"ated --opt=\"a b\"",
+            std::vector<std::string>{"concatenated", "--opt=a b"}),
+        std::make_pair("one\\\ntwo \\\n three \"fo\\\nur\"",
+            std::vector<std::string>{"onetwo", "three", "four"}),
+        std::make_pair("'' \"\" x",
+            std::vector<std::string>{"", "", "x"})));
+// clang-format on
+
+// NOLINTNEXTLINE
+TEST(LineSplitter, PlainArgumentsAreViewsIntoTheLine) {
+  const std::string line = "plain 'quoted' --opt=value";
+  LineSplitter splitter{line};
+  std::string_view arg;
+  ASSERT_THAT(splitter.NextArgument(arg), IsTrue());
+  EXPECT_THAT(arg.data(), Eq(line.data()));
+  ASSERT_THAT(splitter.NextArgument(arg), IsTrue());
+  EXPECT_THAT(arg, Eq("quoted"));
+  ASSERT_THAT(splitter.NextArgument(arg), IsTrue());
+  EXPECT_THAT(arg.data(), Eq(line.data() + 15));
+}
+
+// NOLINTNEXTLINE
+TEST(LineSplitter, MalformedLines) {
+  for (const auto *line : {"a 'unterminated", "a \"unterminated\\\"",
+           "a dangling\\"}) {
+    LineSplitter splitter{line};
+    std::string_view arg;
+    ASSERT_THAT(splitter.NextArgument(arg), IsTrue()) << line;
+    EXPECT_THROW(splitter.NextArgument(arg), TokenizerError) << line;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LineSplitter, TokenizerSplitsLine) {
+  const Tokenizer tokenizer{
+      {"first"}, LineSplitter{"-ab --region \"eu west\""}};
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::Value, "first"}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::ShortOption, "a"}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::ShortOption, "b"}));
+  EXPECT_THAT(
+      tokenizer.NextToken(), Eq(Token{TokenType::LongOption, "region"}));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::Value, "eu west"}));
+  EXPECT_THAT(tokenizer.NextToken().first, Eq(TokenType::EndOfInput));
+}
+
+// NOLINTNEXTLINE
+TEST(LineSplitter, TokenizerReportsMalformedLine) {
+  const Tokenizer tokenizer{{}, LineSplitter{"-a 'unterminated"}};
+  EXPECT_THROW(tokenizer.NextToken(), TokenizerError);
+}
+
+} // namespace
+
+} // namespace asap::clap::parser
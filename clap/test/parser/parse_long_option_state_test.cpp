@@ -16,6 +16,7 @@
 #include "fsm/fsm.h"
 
 using testing::Eq;
+using testing::HasSubstr;
 using testing::IsTrue;
 
 namespace asap::clap::parser::detail {
@@ -55,19 +56,15 @@ public:
   }
 
 protected:
-  void SetUp() override {
-    StateTest::SetUp();
-    state_ = std::make_unique<ParseLongOptionState>();
-  }
-
-  [[nodiscard]] auto EnterState(const Token &token,
-      const ParserContextPtr &context) const -> fsm::Status {
-    ASAP_EXPECT(context->active_command);
+  [[nodiscard]] auto EnterState(const Token &token, ParserContext &context)
+      -> fsm::Status {
+    ASAP_EXPECT(context.active_command);
+    state_ = std::make_unique<ParseLongOptionState>(context);
 
     const auto &[token_type, token_value] = token;
     EXPECT_THAT(token_type, Eq(TokenType::LongOption));
     const auto first_event = TokenEvent<TokenType::LongOption>(token_value);
-    return state_->OnEnter(first_event, context);
+    return state_->OnEnter(first_event);
   }
 
   void LeaveState() const override {
@@ -81,18 +78,19 @@ protected:
   void DoCheckStateAfterLastToken(const TestValueType &test_value) {
     const auto &[command_paths, args, action_check, state_check] = test_value;
 
-    const Tokenizer tokenizer(args);
+    const Tokenizer tokenizer({args.cbegin(), args.cend()});
     const auto commands = BuildCommands(command_paths);
     Command::Ptr command;
     const CommandLineContext base_context("test", command, ovm_);
-    const auto context = ParserContext::New(base_context, commands);
-    context->active_command = predefined_commands().at("with-options");
+    const CommandTrie command_trie(commands);
+    ParserContext context(base_context, command_trie);
+    context.active_command = predefined_commands().at("with-options");
     auto token = tokenizer.NextToken();
     // NOLINTNEXTLINE(hicpp-avoid-goto, cppcoreguidelines-avoid-goto)
     EXPECT_NO_THROW(auto status = EnterState(token, context));
     while (true) {
       token = tokenizer.NextToken();
-      if (!ProcessToken(token, state(), action_check, state_check)) {
+      if (!ProcessToken(token, state(), context, action_check, state_check)) {
         break;
       }
     }
@@ -115,7 +113,7 @@ INSTANTIATE_TEST_SUITE_P(OptionTakesNoValue,
         TestValueType{
             {"with-options"},
             {"--no-value", "2"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"opt_no_val", "--no-value", 1, {"true"}}
         }
     )); // clang-format on
@@ -128,19 +126,19 @@ INSTANTIATE_TEST_SUITE_P(OptionTakesOptionalValue,
         TestValueType{
             {"with-options"},
             {"--first-option"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"first_opt", "--no-value", 1, {"1"}}
         },
         TestValueType{
             {"with-options"},
             {"--first-option", "222"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"first_opt", "--no-value", 1, {"222"}}
         },
         TestValueType{
             {"with-options"},
             {"--first-option=333"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"first_opt", "--no-value", 1, {"333"}}
         }
     )); // clang-format on
@@ -179,19 +177,79 @@ TEST_P(ParseLongOptionStateUnrecognizedOptionTest, FailWithAnException) {
   auto test_value = GetParam();
   const auto &[command_paths, args, action_check, state_check] = test_value;
 
-  Tokenizer tokenizer(args);
+  Tokenizer tokenizer({args.cbegin(), args.cend()});
   const auto commands = BuildCommands(command_paths);
   OptionValuesMap ovm;
   Command::Ptr command;
   const CommandLineContext base_context("test", command, ovm);
-  auto context = ParserContext::New(base_context, commands);
-  context->active_command = predefined_commands().at("with-options");
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  context.active_command = predefined_commands().at("with-options");
   auto token = tokenizer.NextToken();
   auto status = EnterState(token, context);
   EXPECT_THAT(
       std::holds_alternative<fsm::TerminateWithError>(status), IsTrue());
 }
 
+// NOLINTNEXTLINE
+TEST_F(ParseLongOptionStateTest, AbbreviatedLongOptions) {
+  const Command::Ptr abbrev_command{
+      CommandBuilder("abbrev")
+          .WithOption(Option::WithKey("verbose")
+                          .Long("verbose")
+                          .WithValue<bool>()
+                          .Build())
+          .WithOption(Option::WithKey("verbose_level")
+                          .Long("verbose-level")
+                          .WithValue<int>()
+                          .Build())
+          .WithOption(Option::WithKey("version")
+                          .Long("version")
+                          .WithValue<bool>()
+                          .Build())
+          .WithOption(
+              Option::WithKey("color").Long("color").WithValue<bool>().Build())
+          .Build()};
+  const CommandsList commands{abbrev_command};
+  OptionValuesMap ovm;
+  Command::Ptr command;
+  const CommandLineContext base_context("test", command, ovm);
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  context.active_command = abbrev_command;
+
+  // Abbreviations are only accepted when explicitly allowed.
+  auto status = EnterState({TokenType::LongOption, "col"}, context);
+  EXPECT_THAT(
+      std::holds_alternative<fsm::TerminateWithError>(status), IsTrue());
+
+  context.allow_abbreviated_long_options = true;
+  status = EnterState({TokenType::LongOption, "col"}, context);
+  ASSERT_THAT(std::holds_alternative<fsm::Continue>(status), IsTrue());
+  EXPECT_THAT(context.active_option->Key(), Eq("color"));
+
+  // The exact name of an option is preferred, even if it is also the prefix of
+  // other options.
+  status = EnterState({TokenType::LongOption, "verbose"}, context);
+  ASSERT_THAT(std::holds_alternative<fsm::Continue>(status), IsTrue());
+  EXPECT_THAT(context.active_option->Key(), Eq("verbose"));
+
+  status = EnterState({TokenType::LongOption, "verbose-"}, context);
+  ASSERT_THAT(std::holds_alternative<fsm::Continue>(status), IsTrue());
+  EXPECT_THAT(context.active_option->Key(), Eq("verbose_level"));
+
+  status = EnterState({TokenType::LongOption, "ver"}, context);
+  ASSERT_THAT(
+      std::holds_alternative<fsm::TerminateWithError>(status), IsTrue());
+  EXPECT_THAT(std::get<fsm::TerminateWithError>(status).error_message,
+      HasSubstr("'--ver' is ambiguous; possibilities: --verbose "
+                "--verbose-level --version"));
+
+  status = EnterState({TokenType::LongOption, "size"}, context);
+  EXPECT_THAT(
+      std::holds_alternative<fsm::TerminateWithError>(status), IsTrue());
+}
+
 } // namespace
 
 } // namespace asap::clap::parser::detail
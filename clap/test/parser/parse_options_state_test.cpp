@@ -15,6 +15,7 @@
 
 #include "clap/fluent/dsl.h"
 
+using testing::ElementsAre;
 using testing::IsTrue;
 
 namespace asap::clap::parser::detail {
@@ -47,43 +48,9 @@ public:
   }
 
 protected:
-  void SetUp() override {
-    StateTest::SetUp();
-    state_ = std::make_unique<ParseOptionsState>();
-  }
-
-  [[nodiscard]] auto EnterState(
-      const Token &token, const ParserContextPtr &context) const -> Status {
-    ASAP_EXPECT(context->active_command);
-
-    const auto &[token_type, token_value] = token;
-    switch (token_type) {
-    case TokenType::ShortOption: {
-      const auto first_event = TokenEvent<TokenType::ShortOption>(token_value);
-      return state_->OnEnter(first_event, context);
-    }
-    case TokenType::LongOption: {
-      const auto first_event = TokenEvent<TokenType::LongOption>(token_value);
-      return state_->OnEnter(first_event, context);
-    }
-    case TokenType::LoneDash: {
-      const auto first_event = TokenEvent<TokenType::LoneDash>(token_value);
-      return state_->OnEnter(first_event, context);
-    }
-    case TokenType::DashDash: {
-      const auto first_event = TokenEvent<TokenType::DashDash>(token_value);
-      return state_->OnEnter(first_event, context);
-    }
-    case TokenType::Value: {
-      const auto first_event = TokenEvent<TokenType::Value>(token_value);
-      return state_->OnEnter(first_event, context);
-    }
-      // The following token types are not allowed
-    case TokenType::EqualSign:
-    case TokenType::EndOfInput:
-    default:;
-    }
-    return TerminateWithError{"Illegal token used to enter ParseOptionsState"};
+  void SetupState(ParserContext &context) {
+    ASAP_EXPECT(context.active_command);
+    state_ = std::make_unique<ParseOptionsState>(context);
   }
 
   auto state() -> std::unique_ptr<ParseOptionsState> & {
@@ -105,31 +72,31 @@ INSTANTIATE_TEST_SUITE_P(WellFormedScenarios, ParseOptionsStateTransitionsTest,
         TestValueType{
             {"with-options"},
             {"-f"},
-            ParseShortOptionTransitionTestData{"with-options"},
+            ParseShortOptionTransitionTestData{"with-options", {}},
             ParseOptionsStateTestData{{}}
         },
         TestValueType{
             {"with-options"},
             {"--first-option"},
-            ParseLongOptionTransitionTestData{"with-options"},
+            ParseLongOptionTransitionTestData{"with-options", {}},
             ParseOptionsStateTestData{{}}
         },
         TestValueType{
             {"with-options"},
             {"--not-an-option"},
-            ParseLongOptionTransitionTestData{"with-options"},
+            ParseLongOptionTransitionTestData{"with-options", {}},
             ParseOptionsStateTestData{{}}
         },
         TestValueType{
             {"with-options"},
             {"--"},
-            DashDashTransitionTestData{"with-options"},
+            DashDashTransitionTestData{"with-options", {}},
             ParseOptionsStateTestData{{}}
         },
         TestValueType{
             {"with-options"},
             {"-"},
-            ParseShortOptionTransitionTestData{"with-options"},
+            ParseShortOptionTransitionTestData{"with-options", {}},
             ParseOptionsStateTestData{{}}
         },
         TestValueType{
@@ -145,67 +112,55 @@ TEST_P(ParseOptionsStateTransitionsTest, CheckStateAfterLastToken) {
   auto test_value = GetParam();
   const auto &[command_paths, args, action_check, state_check] = test_value;
 
-  Tokenizer tokenizer(args);
+  Tokenizer tokenizer({args.cbegin(), args.cend()});
   const auto commands = BuildCommands(command_paths);
   OptionValuesMap ovm;
   Command::Ptr command;
   const CommandLineContext base_context("test", command, ovm);
-  auto context = ParserContext::New(base_context, commands);
-  context->active_command = predefined_commands().at("with-options");
-  auto token = tokenizer.NextToken();
-  auto status = EnterState(token, context);
-  EXPECT_THAT(std::holds_alternative<ReissueEvent>(status), IsTrue());
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  context.active_command = predefined_commands().at("with-options");
+  SetupState(context);
   while (true) {
-    token = tokenizer.NextToken();
-    // We will never enter ParseOptionsState with an EndOfInput token, and all
-    // test scenarios will have at least one token.
+    auto token = tokenizer.NextToken();
+    // All test scenarios have at least one token, and the one before the end
+    // of input is the one being tested.
     if (token.first == TokenType::EndOfInput) {
       break;
     }
-    if (!ProcessToken(token, state(), action_check, state_check)) {
+    if (!ProcessToken(token, state(), context, action_check, state_check)) {
       break;
     }
   }
 }
 
-// Contracts are not enforced in release builds
-#if defined(ASAP_IS_DEBUG_BUILD)
 // NOLINTNEXTLINE
-TEST(ParseOptionsStateContractTests, EnteringWithEndOfInputBreaksContract) {
-  const auto state = std::make_unique<ParseOptionsState>();
-  const auto event = TokenEvent<TokenType::EndOfInput>("");
+TEST_F(ParseOptionsStateTest, EnteringWithValueStoresPositionalToken) {
+  const auto commands = BuildCommands({"with-options"});
   OptionValuesMap ovm;
   Command::Ptr command;
   const CommandLineContext base_context("test", command, ovm);
-  auto context = ParserContext::New(
-      base_context, {StateTest::predefined_commands().at("default")});
-  CHECK_VIOLATES_CONTRACT(state->OnEnter(event, context));
-}
-
-// NOLINTNEXTLINE
-TEST(ParseOptionsStateContractTests, EnteringWithEmptyContextBreaksContract) {
-  const auto state = std::make_unique<ParseOptionsState>();
-  const auto event = TokenEvent<TokenType::Value>("xxx");
-  CHECK_VIOLATES_CONTRACT(state->OnEnter(event, {}));
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  context.active_command = predefined_commands().at("with-options");
+  SetupState(context);
+  const auto status = state()->OnEnter(TokenEvent<TokenType::Value>("value"));
+  EXPECT_THAT(std::holds_alternative<Continue>(status), IsTrue());
+  EXPECT_THAT(context.positional_tokens, ElementsAre("value"));
 }
 
+// Contracts are not enforced in release builds
+#if defined(ASAP_IS_DEBUG_BUILD)
 // NOLINTNEXTLINE
 TEST(ParseOptionsStateContractTests,
     EnteringWithContextButNoActiveCommandBreaksContract) {
-  const auto state = std::make_unique<ParseOptionsState>();
-  const auto event = TokenEvent<TokenType::Value>("xxx");
   OptionValuesMap ovm;
   Command::Ptr command;
   const CommandLineContext base_context("test", command, ovm);
-  auto context = ParserContext::New(
-      base_context, {StateTest::predefined_commands().at("default")});
-  CHECK_VIOLATES_CONTRACT(state->OnEnter(event, {}));
-}
-
-// NOLINTNEXTLINE
-TEST(ParseOptionsStateContractTests,
-    EnteringWithNoContextButNoExistingContextBreaksContract) {
-  const auto state = std::make_unique<ParseOptionsState>();
+  const CommandsList commands{StateTest::predefined_commands().at("default")};
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  const auto state = std::make_unique<ParseOptionsState>(context);
   const auto event = TokenEvent<TokenType::Value>("xxx");
   CHECK_VIOLATES_CONTRACT(state->OnEnter(event));
 }
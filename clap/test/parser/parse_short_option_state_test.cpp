@@ -53,14 +53,10 @@ public:
   }
 
 protected:
-  void SetUp() override {
-    StateTest::SetUp();
-    state_ = std::make_unique<ParseShortOptionState>();
-  }
-
-  [[nodiscard]] auto EnterState(const Token &token,
-      const ParserContextPtr &context) const -> fsm::Status {
-    ASAP_EXPECT(context->active_command);
+  [[nodiscard]] auto EnterState(const Token &token, ParserContext &context)
+      -> fsm::Status {
+    ASAP_EXPECT(context.active_command);
+    state_ = std::make_unique<ParseShortOptionState>(context);
 
     const auto &[token_type, token_value] = token;
     EXPECT_THAT((token_type == TokenType::ShortOption ||
@@ -69,11 +65,11 @@ protected:
 
     if (token_type == TokenType::ShortOption) {
       const auto first_event = TokenEvent<TokenType::ShortOption>(token_value);
-      return state_->OnEnter(first_event, context);
+      return state_->OnEnter(first_event);
     }
     if (token_type == TokenType::LoneDash) {
       const auto first_event = TokenEvent<TokenType::LoneDash>(token_value);
-      return state_->OnEnter(first_event, context);
+      return state_->OnEnter(first_event);
     }
     return fsm::TerminateWithError{"Illegal Token"};
   }
@@ -89,18 +85,19 @@ protected:
   void DoCheckStateAfterLastToken(const TestValueType &test_value) {
     const auto &[command_paths, args, action_check, state_check] = test_value;
 
-    const Tokenizer tokenizer(args);
+    const Tokenizer tokenizer({args.cbegin(), args.cend()});
     const auto commands = BuildCommands(command_paths);
     Command::Ptr command;
     const CommandLineContext base_context("test", command, ovm_);
-    const auto context = ParserContext::New(base_context, commands);
-    context->active_command = predefined_commands().at("with-options");
+    const CommandTrie command_trie(commands);
+    ParserContext context(base_context, command_trie);
+    context.active_command = predefined_commands().at("with-options");
     auto token = tokenizer.NextToken();
     // NOLINTNEXTLINE(hicpp-avoid-goto, cppcoreguidelines-avoid-goto)
     EXPECT_NO_THROW(auto status = EnterState(token, context));
     while (true) {
       token = tokenizer.NextToken();
-      if (!ProcessToken(token, state(), action_check, state_check)) {
+      if (!ProcessToken(token, state(), context, action_check, state_check)) {
         break;
       }
     }
@@ -124,7 +121,7 @@ INSTANTIATE_TEST_SUITE_P(OptionTakesNoValue,
         TestValueType{
             {"with-options"},
             {"-n"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"opt_no_val", "-n", 1, {"true"}}
         }
     )); // clang-format on
@@ -137,13 +134,13 @@ INSTANTIATE_TEST_SUITE_P(OptionTakesOptionalValue,
         TestValueType{
             {"with-options"},
             {"-f"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"first_opt", "-f", 1, {"1"}}
         },
         TestValueType{
             {"with-options"},
             {"-f", "2"},
-            ParseOptionsTransitionTestData{},
+            FinalStateTransitionTestData{"with-options", {}},
             ParseShortOptionStateTestData{"first_opt", "-f", 1, {"2"}}
         }
     )); // clang-format on
@@ -188,13 +185,14 @@ TEST_P(ParseShortOptionStateUnrecognizedOptionTest, FailWithAnException) {
   auto test_value = GetParam();
   const auto &[command_paths, args, action_check, state_check] = test_value;
 
-  Tokenizer tokenizer(args);
+  Tokenizer tokenizer({args.cbegin(), args.cend()});
   const auto commands = BuildCommands(command_paths);
   OptionValuesMap ovm;
   Command::Ptr command;
   const CommandLineContext base_context("test", command, ovm);
-  auto context = ParserContext::New(base_context, commands);
-  context->active_command = predefined_commands().at("with-options");
+  const CommandTrie command_trie(commands);
+  ParserContext context(base_context, command_trie);
+  context.active_command = predefined_commands().at("with-options");
   auto token = tokenizer.NextToken();
   auto status = EnterState(token, context);
   EXPECT_THAT(
@@ -0,0 +1,189 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "parser/response_file.h"
+#include "parser/tokenizer.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::ElementsAre;
+using testing::Eq;
+using testing::IsNull;
+using testing::NotNull;
+
+namespace asap::clap::parser {
+
+namespace {
+
+class ResponseFileTest : public ::testing::Test {
+protected:
+  void TearDown() override {
+    for (const auto &path : files_) {
+      std::filesystem::remove(path);
+    }
+  }
+
+  auto WriteFile(const std::string &name, const std::string &contents)
+      -> std::string {
+    const auto path = (std::filesystem::temp_directory_path() /
+                       ("asap_clap_response_file_test_" + name))
+                          .string();
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+    files_.push_back(path);
+    return path;
+  }
+
+  static auto Split(ResponseFile &file, ResponseFileSyntax syntax)
+      -> std::vector<std::string> {
+    std::vector<std::string> args;
+    std::string_view arg;
+    while (file.NextArgument(syntax, arg)) {
+      args.emplace_back(arg);
+    }
+    return args;
+  }
+
+  static auto AllTokenValues(const Tokenizer &tokenizer)
+      -> std::vector<std::string> {
+    std::vector<std::string> values;
+    for (auto token = tokenizer.NextToken();
+         token.first != TokenType::EndOfInput; token = tokenizer.NextToken()) {
+      values.emplace_back(token.second);
+    }
+    return values;
+  }
+
+private:
+  std::vector<std::string> files_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, OpenMissingFileFails) {
+  EXPECT_THAT(ResponseFile::Open("__no_such_response_file__"), IsNull());
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, EmptyFileHasNoArguments) {
+  const auto file = ResponseFile::Open(WriteFile("empty", ""));
+  ASSERT_THAT(file, NotNull());
+  EXPECT_THAT(Split(*file, ResponseFileSyntax::Gnu).size(), Eq(0));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, GnuQuotingRules) {
+  const auto file = ResponseFile::Open(WriteFile("gnu",
+      "  -x --opt=value\n"
+      "'single quoted' \"double quoted\"\t"
+      "esc\\ aped \"a\\\"b\" 'it'\\''s' mi\"x\"'ed'\r\n"
+      "\"\" last"));
+  ASSERT_THAT(file, NotNull());
+  EXPECT_THAT(Split(*file, ResponseFileSyntax::Gnu),
+      ElementsAre("-x", "--opt=value", "single quoted", "double quoted",
+          "esc aped", "a\"b", "it's", "mixed", "", "last"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, WindowsQuotingRules) {
+  const auto file = ResponseFile::Open(WriteFile("windows",
+      "C:\\path\\to\\file \"with spaces\" 'not quoted'\r\n"
+      "a\\\\\"b c\" d\\\"e \"f\"\"g\" trailing\\\\"));
+  ASSERT_THAT(file, NotNull());
+  EXPECT_THAT(Split(*file, ResponseFileSyntax::Windows),
+      ElementsAre("C:\\path\\to\\file", "with spaces", "'not", "quoted'",
+          "a\\b c", "d\"e", "f\"g", "trailing\\\\"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, UnescapingDoesNotModifyTheFile) {
+  const auto path = WriteFile("unchanged", "\"quoted value\"");
+  {
+    const auto file = ResponseFile::Open(path);
+    ASSERT_THAT(file, NotNull());
+    EXPECT_THAT(
+        Split(*file, ResponseFileSyntax::Gnu), ElementsAre("quoted value"));
+  }
+  std::ifstream file(path, std::ios::binary);
+  const std::string contents{std::istreambuf_iterator<char>(file), {}};
+  EXPECT_THAT(contents, Eq("\"quoted value\""));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, TokenizerExpandsNestedResponseFiles) {
+  const auto inner = WriteFile("inner", "--inner=1 \"inner value\"");
+  const auto outer = WriteFile("outer", "-a @" + inner + " outer");
+  const std::string outer_arg = "@" + outer;
+  const std::vector<std::string_view> args{"first", outer_arg, "last"};
+
+  const Tokenizer tokenizer{args, ResponseFileOptions{}};
+  EXPECT_THAT(AllTokenValues(tokenizer),
+      ElementsAre("first", "a", "inner", "=", "1", "inner value", "outer",
+          "last"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, TokenizerKeepsUnreadableResponseFilesLiterally) {
+  const std::vector<std::string_view> args{"@__no_such_response_file__", "@"};
+
+  const Tokenizer tokenizer{args, ResponseFileOptions{}};
+  EXPECT_THAT(AllTokenValues(tokenizer),
+      ElementsAre("@__no_such_response_file__", "@"));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, TokenizerDoesNotExpandWhenNotEnabled) {
+  const auto path = WriteFile("disabled", "-a");
+  const std::string arg = "@" + path;
+
+  const Tokenizer tokenizer{{arg}};
+  EXPECT_THAT(AllTokenValues(tokenizer), ElementsAre(arg));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, TokenizerEnforcesNestingLimit) {
+  // A response file that includes itself. Arguments are pulled in batches,
+  // so the error surfaces as soon as the first token is requested.
+  const auto path = (std::filesystem::temp_directory_path() /
+                     "asap_clap_response_file_test_recursive")
+                        .string();
+  WriteFile("recursive", "value @" + path);
+  const std::string arg = "@" + path;
+
+  const Tokenizer tokenizer{
+      {arg}, ResponseFileOptions{ResponseFileSyntax::Gnu, 3}};
+  EXPECT_THROW(tokenizer.NextToken(), TokenizerError);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ResponseFileTest, ReleasedTokensAreDropped) {
+  std::string contents;
+  constexpr std::size_t count = 20000;
+  for (std::size_t index = 0; index < count; ++index) {
+    contents.append("value ");
+  }
+  const auto path = WriteFile("large", contents);
+  const std::string arg = "@" + path;
+
+  const Tokenizer tokenizer{{arg}, ResponseFileOptions{}};
+  std::size_t index = 0;
+  for (auto token = tokenizer.TokenAt(index);
+       token.first != TokenType::EndOfInput; token = tokenizer.TokenAt(index)) {
+    EXPECT_THAT(token.second, Eq("value"));
+    tokenizer.Release(++index);
+  }
+  EXPECT_THAT(index, Eq(count));
+  const auto &buffer = tokenizer.TokenizeAll();
+  EXPECT_THAT(buffer.Offset(), testing::Gt(0U));
+  EXPECT_THAT(buffer.Size(), testing::Lt(count / 2));
+}
+
+} // namespace
+
+} // namespace asap::clap::parser
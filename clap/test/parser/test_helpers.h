@@ -95,7 +95,7 @@ protected:
 
   template <typename State>
   [[nodiscard]] auto ProcessToken(const Token &token, State &state,
-      const ExpectedTransitionData &action_data,
+      const ParserContext &context, const ExpectedTransitionData &action_data,
       const ExpectedStateData &state_data) const -> bool {
     const auto &[token_type, token_value] = token;
     switch (token_type) {
@@ -104,7 +104,7 @@ protected:
           state->Handle(TokenEvent<TokenType::ShortOption>{token_value});
       auto continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -116,7 +116,7 @@ protected:
           state->Handle(TokenEvent<TokenType::LongOption>{token_value});
       bool continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -127,7 +127,7 @@ protected:
       auto action = state->Handle(TokenEvent<TokenType::LoneDash>{token_value});
       bool continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -139,7 +139,7 @@ protected:
           state->Handle(TokenEvent<TokenType::EqualSign>{token_value});
       bool continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -150,7 +150,7 @@ protected:
       auto action = state->Handle(TokenEvent<TokenType::DashDash>{token_value});
       bool continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -161,7 +161,7 @@ protected:
       auto action = state->Handle(TokenEvent<TokenType::Value>{token_value});
       bool continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         this->LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -173,7 +173,7 @@ protected:
           state->Handle(TokenEvent<TokenType::EndOfInput>{token_value});
       bool continue_after_check_state{true};
       const bool continue_after_check_action =
-          CheckAction(action, token_type, action_data);
+          CheckAction(action, token_type, context, action_data);
       if (!continue_after_check_action) {
         LeaveState();
         continue_after_check_state = CheckState(state, state_data);
@@ -187,10 +187,13 @@ protected:
 
   template <typename ActionType>
   [[nodiscard]] static auto CheckAction(const ActionType &action,
-      TokenType token_type, const ExpectedTransitionData &data) -> bool {
+      TokenType token_type, const ParserContext &context,
+      const ExpectedTransitionData &data) -> bool {
     if (!action.template IsA<DoNothing>() ||
         token_type == TokenType::EndOfInput) {
-      std::visit([&action](auto &test_data) { test_data.Check(action); }, data);
+      std::visit([&action, &context](
+                     auto &test_data) { test_data.Check(action, context); },
+          data);
       return false; // do not continue processing tokens
     }
     return true; // continue processing tokens
@@ -205,77 +208,89 @@ protected:
 };
 
 struct FinalStateTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(const ActionType &action, const ParserContext &context) const {
     EXPECT_THAT(action.template IsA<fsm::TransitionTo<FinalState>>(),
         ::testing::IsTrue());
-    const auto &action_data = std::any_cast<ParserContextPtr>(action.data());
-    EXPECT_THAT(action_data->active_command,
+    EXPECT_THAT(context.active_command,
         ::testing::Eq(StateTest::predefined_commands().at(command_path)));
+    EXPECT_THAT(context.positional_tokens,
+        ::testing::ElementsAreArray(positional_tokens));
   }
   std::string command_path;
+  std::vector<std::string> positional_tokens;
 };
 
 struct ParseOptionsTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(const ActionType &action, const ParserContext &context) const {
     EXPECT_THAT(action.template IsA<fsm::TransitionTo<ParseOptionsState>>(),
         ::testing::IsTrue());
-    if (action.data().has_value()) {
-      const auto &action_data = std::any_cast<ParserContextPtr>(action.data());
-      EXPECT_THAT(action_data->active_command,
-          ::testing::Eq(StateTest::predefined_commands().at(command_path)));
-      EXPECT_THAT(
-          action_data->positional_tokens, ::testing::Eq(positional_tokens));
-    }
+    EXPECT_THAT(context.active_command,
+        ::testing::Eq(StateTest::predefined_commands().at(command_path)));
+    EXPECT_THAT(context.positional_tokens,
+        ::testing::ElementsAreArray(positional_tokens));
   }
   std::string command_path;
   std::vector<std::string> positional_tokens;
 };
 
 struct ParseShortOptionTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(const ActionType &action, const ParserContext &context) const {
     EXPECT_THAT(action.template IsA<fsm::TransitionTo<ParseShortOptionState>>(),
         ::testing::IsTrue());
-    const auto &action_data = std::any_cast<ParserContextPtr>(action.data());
-    EXPECT_THAT(action_data->active_command,
+    EXPECT_THAT(context.active_command,
         ::testing::Eq(StateTest::predefined_commands().at(command_path)));
+    EXPECT_THAT(context.positional_tokens,
+        ::testing::ElementsAreArray(positional_tokens));
   }
   std::string command_path;
+  std::vector<std::string> positional_tokens;
 };
 
 struct ParseLongOptionTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(const ActionType &action, const ParserContext &context) const {
     EXPECT_THAT(action.template IsA<fsm::TransitionTo<ParseLongOptionState>>(),
         ::testing::IsTrue());
-    const auto &action_data = std::any_cast<ParserContextPtr>(action.data());
-    EXPECT_THAT(action_data->active_command,
+    EXPECT_THAT(context.active_command,
         ::testing::Eq(StateTest::predefined_commands().at(command_path)));
+    EXPECT_THAT(context.positional_tokens,
+        ::testing::ElementsAreArray(positional_tokens));
   }
   std::string command_path;
+  std::vector<std::string> positional_tokens;
 };
 
 struct DashDashTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(const ActionType &action, const ParserContext &context) const {
     EXPECT_THAT(action.template IsA<fsm::TransitionTo<DashDashState>>(),
         ::testing::IsTrue());
-    const auto &action_data = std::any_cast<ParserContextPtr>(action.data());
-    EXPECT_THAT(action_data->active_command,
+    EXPECT_THAT(context.active_command,
         ::testing::Eq(StateTest::predefined_commands().at(command_path)));
+    EXPECT_THAT(context.positional_tokens,
+        ::testing::ElementsAreArray(positional_tokens));
   }
   std::string command_path;
+  std::vector<std::string> positional_tokens;
 };
 
 struct IdentifyCommandTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(const ActionType &action, const ParserContext &context) const {
     EXPECT_THAT(action.template IsA<fsm::TransitionTo<IdentifyCommandState>>(),
         ::testing::IsTrue());
-    const auto &action_data = std::any_cast<ParserContextPtr>(action.data());
-    EXPECT_THAT(action_data->commands, ::testing::Eq(commands));
+    EXPECT_THAT(context.commands, ::testing::Eq(commands));
   }
   CommandsList commands;
 };
 
 struct ReportErrorTransitionTestData {
-  template <typename ActionType> void Check(const ActionType &action) const {
+  template <typename ActionType>
+  void Check(
+      const ActionType &action, const ParserContext & /*context*/) const {
     EXPECT_THAT(action.template IsA<fsm::ReportError>(), ::testing::IsTrue());
     const auto &action_data = std::any_cast<std::string>(action.data());
     EXPECT_THAT(action_data, ::testing::HasSubstr(error));
@@ -285,7 +300,8 @@ struct ReportErrorTransitionTestData {
 
 struct DoNothingTransitionTestData {
   template <typename ActionType>
-  static void Check(const ActionType & /*action*/) {
+  static void Check(
+      const ActionType & /*action*/, const ParserContext & /*context*/) {
     // Do nothing
   }
 };
@@ -299,7 +315,7 @@ struct InitialStateTestData {
 template <>
 inline void asap::clap::parser::detail::InitialStateTestData::Check(
     const std::unique_ptr<InitialState> &state) const {
-  EXPECT_THAT(state->context()->commands, ::testing::Eq(commands));
+  EXPECT_THAT(state->context().commands, ::testing::Eq(commands));
 }
 
 struct FinalStateTestData {
@@ -316,7 +332,8 @@ struct ParseOptionsStateTestData {
 template <>
 inline void asap::clap::parser::detail::ParseOptionsStateTestData::Check(
     const std::unique_ptr<ParseOptionsState> &state) const {
-  EXPECT_THAT(state->context_->positional_tokens, ::testing::Eq(value_tokens));
+  EXPECT_THAT(state->context_.positional_tokens,
+      ::testing::ElementsAreArray(value_tokens));
 }
 
 struct ParseShortOptionStateTestData {
@@ -332,15 +349,15 @@ struct ParseShortOptionStateTestData {
 template <>
 inline void asap::clap::parser::detail::ParseShortOptionStateTestData::Check(
     const std::unique_ptr<ParseShortOptionState> &state) const {
-  const auto &option_name = state->context_->active_option->Key();
+  const auto &option_name = state->context_.active_option->Key();
   EXPECT_THAT(option_name, ::testing::Eq(active_option));
   EXPECT_THAT(
-      state->context_->active_option_flag, ::testing::Eq(active_option_flag));
-  EXPECT_THAT(state->context_->ovm.OccurrencesOf(option_name),
+      state->context_.active_option_flag, ::testing::Eq(active_option_flag));
+  EXPECT_THAT(state->context_.ovm.OccurrencesOf(option_name),
       ::testing::Eq(values_size));
   if (value.has_value() && values_size > 0) {
     const auto &last_value =
-        state->context_->ovm.ValuesOf(option_name).back().OriginalToken();
+        state->context_.ovm.ValuesOf(option_name).back().OriginalToken();
     EXPECT_THAT(last_value, ::testing::Eq(value));
   }
 }
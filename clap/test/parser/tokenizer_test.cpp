@@ -9,6 +9,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "./fsm_tokenizer.h"
+
+using testing::ContainerEq;
 using testing::Eq;
 using testing::Ne;
 
@@ -20,6 +23,16 @@ using ParamType = std::pair<std::string, std::vector<Token>>;
 
 class TokenizerTest : public ::testing::TestWithParam<ParamType> {};
 
+auto AllTokens(std::string_view argument) -> std::vector<Token> {
+  const Tokenizer tokenizer{{argument}};
+  std::vector<Token> tokens;
+  for (auto token = tokenizer.NextToken(); token.first != TokenType::EndOfInput;
+       token = tokenizer.NextToken()) {
+    tokens.push_back(token);
+  }
+  return tokens;
+}
+
 // NOLINTNEXTLINE
 TEST_P(TokenizerTest, ProduceExpectedTokens) {
   const auto &[argument, tokens] = GetParam();
@@ -31,6 +44,13 @@ TEST_P(TokenizerTest, ProduceExpectedTokens) {
         EXPECT_THAT(token.first, Eq(expected_token.first));
         EXPECT_THAT(token.second, Eq(expected_token.second));
       });
+  EXPECT_THAT(tokenizer.NextToken().first, Eq(TokenType::EndOfInput));
+}
+
+// NOLINTNEXTLINE
+TEST_P(TokenizerTest, ReferenceImplementationProducesExpectedTokens) {
+  const auto &[argument, tokens] = GetParam();
+  EXPECT_THAT(reference::FsmTokenize(argument), ContainerEq(tokens));
 }
 
 // NOLINTNEXTLINE
@@ -88,6 +108,19 @@ INSTANTIATE_TEST_SUITE_P(ValidArguments, TokenizerTest,
             {TokenType::EqualSign, "="},
             {TokenType::Value, "v=x"},
         }),
+        std::make_pair<std::string, std::vector<Token>>("--opt==v", {
+            {TokenType::LongOption, "opt"},
+            {TokenType::EqualSign, "="},
+            {TokenType::Value, "=v"},
+        }),
+        std::make_pair<std::string, std::vector<Token>>("--=", {
+            {TokenType::LongOption, "="}
+        }),
+        std::make_pair<std::string, std::vector<Token>>("--=v=x", {
+            {TokenType::LongOption, "=v"},
+            {TokenType::EqualSign, "="},
+            {TokenType::Value, "x"},
+        }),
         std::make_pair<std::string, std::vector<Token>>("--opt=a,b,c", {
             {TokenType::LongOption, "opt"},
             {TokenType::EqualSign, "="},
@@ -127,6 +160,99 @@ TEST_F(TokenizerTest, NextTokenWithNoToken) {
     ASSERT_THAT(tokenizer.NextToken().first, Ne(TokenType::EndOfInput));
     ASSERT_THAT(tokenizer.NextToken().first, Eq(TokenType::EndOfInput));
   }
+  {
+    const Tokenizer tokenizer{{"", "hello", ""}};
+
+    ASSERT_THAT(tokenizer.NextToken().first, Eq(TokenType::Value));
+    ASSERT_THAT(tokenizer.NextToken().first, Eq(TokenType::EndOfInput));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TokenizerTest, TokensAreViewsIntoArguments) {
+  const std::string argument{"--opt=value"};
+  const Tokenizer tokenizer{{argument}};
+
+  const auto option = tokenizer.NextToken().second;
+  EXPECT_THAT(option.data(), Eq(argument.data() + 2));
+  tokenizer.NextToken();
+  const auto value = tokenizer.NextToken().second;
+  EXPECT_THAT(value.data(), Eq(argument.data() + 6));
+  EXPECT_THAT(value.size(), Eq(5));
+}
+
+// NOLINTNEXTLINE
+TEST_F(TokenizerTest, SameTokensAsReferenceImplementation) {
+  // Exhaustively generate all arguments up to a certain length from an
+  // alphabet made of the characters that matter to the tokenizer, and check
+  // that the scanner and the reference state machine agree on all of them.
+  constexpr std::string_view alphabet{"-=a"};
+  constexpr std::size_t max_length = 7;
+  std::vector<std::string> arguments{""};
+  std::size_t generation_start = 0;
+  for (std::size_t length = 1; length <= max_length; ++length) {
+    const auto generation_end = arguments.size();
+    for (auto index = generation_start; index < generation_end; ++index) {
+      for (const auto character : alphabet) {
+        arguments.push_back(arguments[index] + character);
+      }
+    }
+    generation_start = generation_end;
+  }
+
+  for (const auto &argument : arguments) {
+    EXPECT_THAT(
+        AllTokens(argument), ContainerEq(reference::FsmTokenize(argument)))
+        << "argument: '" << argument << "'";
+  }
+
+  // Same thing, but with all the arguments tokenized together, with and
+  // without the batch classification of arguments.
+  for (const auto upfront : {false, true}) {
+    Tokenizer tokenizer{{arguments.cbegin(), arguments.cend()}};
+    tokenizer.ClassifyUpfront(upfront);
+    for (const auto &argument : arguments) {
+      for (const auto &expected_token : reference::FsmTokenize(argument)) {
+        EXPECT_THAT(tokenizer.NextToken(), Eq(expected_token))
+            << "argument: '" << argument << "', upfront: " << upfront;
+      }
+    }
+    EXPECT_THAT(tokenizer.NextToken().first, Eq(TokenType::EndOfInput));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TokenizerTest, TokenizeAllFillsTokenBuffer) {
+  const Tokenizer tokenizer{{"-ab", "", "--opt=value", "file"}};
+
+  const auto &tokens = tokenizer.TokenizeAll();
+  EXPECT_THAT(tokens.Types(),
+      testing::ElementsAre(TokenType::ShortOption, TokenType::ShortOption,
+          TokenType::LongOption, TokenType::EqualSign, TokenType::Value,
+          TokenType::Value));
+  ASSERT_THAT(tokens.Spans().size(), Eq(tokens.Size()));
+  EXPECT_THAT(tokens.Spans()[1].argument, Eq(0U));
+  EXPECT_THAT(tokens.Spans()[1].offset, Eq(2U));
+  EXPECT_THAT(tokens.Spans()[4].argument, Eq(2U));
+  EXPECT_THAT(tokens.Spans()[4].offset, Eq(6U));
+  EXPECT_THAT(tokens.Spans()[4].length, Eq(5U));
+  EXPECT_THAT(tokens.Spans()[5].argument, Eq(3U));
+
+  EXPECT_THAT(tokenizer.TokenAt(2), Eq(Token{TokenType::LongOption, "opt"}));
+  EXPECT_THAT(tokenizer.TokenAt(4), Eq(Token{TokenType::Value, "value"}));
+  EXPECT_THAT(tokenizer.TokenAt(tokens.Size()).first,
+      Eq(TokenType::EndOfInput));
+}
+
+// NOLINTNEXTLINE
+TEST_F(TokenizerTest, TokenizeAllAfterNextToken) {
+  const Tokenizer tokenizer{{"first", "second"}};
+
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::Value, "first"}));
+  const auto &tokens = tokenizer.TokenizeAll();
+  EXPECT_THAT(tokens.Size(), Eq(2));
+  EXPECT_THAT(tokenizer.NextToken(), Eq(Token{TokenType::Value, "second"}));
+  EXPECT_THAT(tokenizer.HasMoreTokens(), testing::IsFalse());
 }
 
 // NOLINTNEXTLINE
@@ -139,7 +265,7 @@ TEST(TokenizerExample, ComplexCommandLine) {
   std::map<TokenType, std::vector<std::string>> tokens;
   while (tokenizer.HasMoreTokens()) {
     const auto [token_type, token_value] = tokenizer.NextToken();
-    tokens[token_type].push_back(token_value);
+    tokens[token_type].emplace_back(token_value);
   }
   //! [Tokenizer example]
   EXPECT_THAT(tokens.at(TokenType::Value).size(), Eq(5));
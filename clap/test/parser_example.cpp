@@ -78,7 +78,8 @@ TEST(ParserExample, ComplexCommandLine) {
   OptionValuesMap ovm;
   Command::Ptr command;
   const CommandLineContext context("parser-test", command, ovm);
-  CmdLineParser parser(context, tokenizer, commands);
+  const CommandTrie command_trie(commands);
+  CmdLineParser parser(context, tokenizer, command_trie);
   const auto success = parser.Parse();
   ASSERT_THAT(success, IsTrue());
 }
@@ -0,0 +1,216 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+#include "clap/schema.h"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "clap/cli.h"
+#include "clap/fluent/dsl.h"
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+using ::testing::Optional;
+
+namespace asap::clap::schema {
+
+namespace {
+
+enum class Color { red, green, blue };
+
+constexpr auto test_schema = Command(
+    Option<bool>("verbose").Short("v").Long("verbose"),
+    Option<int>("level").Short("l").Long("level"),
+    Option<Color>("color").Long("color"),
+    Option<std::vector<std::string>>("include").Short("I").Long("include"),
+    Rest<std::vector<std::string>>("files"));
+
+constexpr auto VERBOSE = test_schema.IndexOf("verbose");
+constexpr auto LEVEL = test_schema.IndexOf("level");
+constexpr auto COLOR = test_schema.IndexOf("color");
+constexpr auto INCLUDE = test_schema.IndexOf("include");
+constexpr auto FILES = test_schema.IndexOf("files");
+
+// The equivalent of `test_schema` described with the dynamic API, except for
+// the positional arguments.
+auto MakeDynamicCli() -> std::unique_ptr<Cli> {
+  return CliBuilder()
+      .ProgramName("test")
+      .WithCommand(
+          CommandBuilder(Command::DEFAULT)
+              .WithOption(Option::WithKey("verbose")
+                              .Short("v")
+                              .Long("verbose")
+                              .WithValue<bool>()
+                              .ImplicitValue(true, "true")
+                              .Build())
+              .WithOption(Option::WithKey("level")
+                              .Short("l")
+                              .Long("level")
+                              .WithValue<int>()
+                              .Build())
+              .WithOption(Option::WithKey("include")
+                              .Short("I")
+                              .Long("include")
+                              .WithValue<std::string>()
+                              .Repeatable()
+                              .Build()))
+      .Build();
+}
+
+template <std::size_t size>
+auto Parse(std::array<const char *, size> argv) {
+  return test_schema.Parse(static_cast<int>(argv.size()), argv.data());
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, TablesAreComputedAtCompileTime) {
+  static_assert(VERBOSE == 0 && FILES == 4);
+  using ValuesType = decltype(test_schema)::ValuesType;
+  static_assert(std::is_same_v<
+      decltype(std::declval<const ValuesType &>().Get<LEVEL>()),
+      const std::optional<int> &>);
+  static_assert(std::is_same_v<
+      decltype(std::declval<const ValuesType &>().Get<INCLUDE>()),
+      const std::vector<std::string> &>);
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, ParseValuesToTheirTypes) {
+  const auto values = Parse(std::array{"test", "-v", "--level=3", "--color",
+      "blue", "-I", "a", "one", "--include=b", "two"});
+
+  EXPECT_THAT(values.Get<VERBOSE>(), Optional(IsTrue()));
+  EXPECT_THAT(values.Get<LEVEL>(), Optional(Eq(3)));
+  EXPECT_THAT(values.Get<COLOR>(), Optional(Eq(Color::blue)));
+  EXPECT_THAT(values.Get<INCLUDE>(), ElementsAre("a", "b"));
+  EXPECT_THAT(values.Get<FILES>(), ElementsAre("one", "two"));
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, OptionsNotOnTheCommandLineHaveNoValue) {
+  const auto values = Parse(std::array{"test"});
+
+  EXPECT_THAT(values.Get<VERBOSE>().has_value(), IsFalse());
+  EXPECT_THAT(values.Get<LEVEL>().has_value(), IsFalse());
+  EXPECT_THAT(values.Get<INCLUDE>(), IsEmpty());
+  EXPECT_THAT(values.Get<FILES>(), IsEmpty());
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, FlagsTakeTheNextValueOnlyIfItIsABoolean) {
+  auto values = Parse(std::array{"test", "-v", "no", "file"});
+  EXPECT_THAT(values.Get<VERBOSE>(), Optional(IsFalse()));
+  EXPECT_THAT(values.Get<FILES>(), ElementsAre("file"));
+
+  values = Parse(std::array{"test", "--verbose", "file"});
+  EXPECT_THAT(values.Get<VERBOSE>(), Optional(IsTrue()));
+  EXPECT_THAT(values.Get<FILES>(), ElementsAre("file"));
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, ShortOptionsCluster) {
+  const auto values = Parse(std::array{"test", "-vl", "7"});
+  EXPECT_THAT(values.Get<VERBOSE>(), Optional(IsTrue()));
+  EXPECT_THAT(values.Get<LEVEL>(), Optional(Eq(7)));
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, ErrorsAreTheSameAsWithTheDynamicCli) {
+  const auto cli = MakeDynamicCli();
+  const std::vector<std::vector<const char *>> command_lines{
+      {"test", "--unknown"},
+      {"test", "-x"},
+      {"test", "--level"},
+      {"test", "--level=high"},
+      {"test", "-l", "high"},
+      {"test", "--level=1", "-l", "2"},
+      {"test", "-v", "--verbose"},
+  };
+  for (auto argv : command_lines) {
+    const auto argc = static_cast<int>(argv.size());
+
+    testing::internal::CaptureStderr();
+    EXPECT_THROW(static_cast<void>(cli->Parse(argc, argv.data())),
+        CmdLineArgumentsError);
+    const auto expected = testing::internal::GetCapturedStderr();
+
+    testing::internal::CaptureStderr();
+    EXPECT_THROW(static_cast<void>(test_schema.Parse(argc, argv.data())),
+        CmdLineArgumentsError);
+    EXPECT_THAT(testing::internal::GetCapturedStderr(), Eq(expected));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, UnexpectedPositionalArgumentsWithoutRest) {
+  static constexpr auto no_rest =
+      Command(Option<bool>("verbose").Short("v").Long("verbose"));
+  std::array argv{"test", "-v", "one", "two"};
+
+  testing::internal::CaptureStderr();
+  EXPECT_THROW(static_cast<void>(no_rest.Parse(
+                   static_cast<int>(argv.size()), argv.data())),
+      CmdLineArgumentsError);
+  EXPECT_THAT(testing::internal::GetCapturedStderr(),
+      Eq("test:  arguments 'one, two' are not expected by any option.\n"));
+}
+
+constexpr auto test_program = Program({"prog", "1.2.3", "A test program."},
+    Command(Option<bool>("verbose").Short("v").Long("verbose").About(
+                "Print more."),
+        Option<int>("level").Long("level").UserFriendlyName("n").About(
+            "The level.")));
+
+// NOLINTNEXTLINE
+TEST(Schema, ProgramViewIsAvailableAtCompileTime) {
+  constexpr auto view = test_program.View();
+  static_assert(view.ProgramName() == "prog");
+  static_assert(view.Version() == "1.2.3");
+  static_assert(view.About() == "A test program.");
+  static_assert(view.OptionsCount() == 2);
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, ProgramHandlesHelpAndVersion) {
+  std::array help{"prog", "--help"};
+  testing::internal::CaptureStdout();
+  EXPECT_THAT(test_program.Parse(2, help.data()).has_value(), IsFalse());
+  const auto help_text = testing::internal::GetCapturedStdout();
+  EXPECT_THAT(help_text, HasSubstr("SYNOPSIS"));
+  EXPECT_THAT(help_text, HasSubstr("--level=<n>"));
+  EXPECT_THAT(help_text, HasSubstr("Print more."));
+
+  std::array version{"prog", "version"};
+  testing::internal::CaptureStdout();
+  EXPECT_THAT(test_program.Parse(2, version.data()).has_value(), IsFalse());
+  EXPECT_THAT(testing::internal::GetCapturedStdout(),
+      Eq("prog version 1.2.3\n\n"));
+}
+
+// NOLINTNEXTLINE
+TEST(Schema, ProgramShortNamesTakePrecedenceOverVersion) {
+  std::array argv{"prog", "-v"};
+  const auto values = test_program.Parse(2, argv.data());
+  ASSERT_THAT(values.has_value(), IsTrue());
+  EXPECT_THAT(values->Get<0>(), Optional(IsTrue()));
+}
+
+} // namespace
+
+} // namespace asap::clap::schema
@@ -12,6 +12,8 @@
 #include <gtest/gtest.h>
 
 using ::testing::Eq;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
 
 namespace asap::clap::detail {
 
@@ -21,6 +23,17 @@ namespace {
 TEST(StringUtils, ToLower) {
   EXPECT_THAT(
       detail::ToLower("True Enable DisABLe"), Eq("true enable disable"));
+  EXPECT_THAT(detail::ToLower("\xC9T\xC9 @[`{"), Eq("\xC9t\xC9 @[`{"));
+}
+
+// NOLINTNEXTLINE
+TEST(StringUtils, EqualsIgnoringCase) {
+  EXPECT_THAT(detail::EqualsIgnoringCase("Enable", "eNABLE"), IsTrue());
+  EXPECT_THAT(detail::EqualsIgnoringCase("", ""), IsTrue());
+  EXPECT_THAT(detail::EqualsIgnoringCase("enable", "enabled"), IsFalse());
+  // Only ASCII letters are folded.
+  EXPECT_THAT(detail::EqualsIgnoringCase("[", "{"), IsFalse());
+  EXPECT_THAT(detail::EqualsIgnoringCase("@", "`"), IsFalse());
 }
 
 } // namespace
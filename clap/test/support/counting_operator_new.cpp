@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+// Distributed under the 3-Clause BSD License. See accompanying file LICENSE or
+// copy at https://opensource.org/licenses/BSD-3-Clause).
+// SPDX-License-Identifier: BSD-3-Clause
+//===----------------------------------------------------------------------===//
+
+/*!
+ * \file
+ *
+ * \brief Replacements of the global `operator new` and `operator delete` that
+ * feed the allocation counters of `clap/debug/allocation_stats.h`.
+ *
+ * Replacement allocation functions must be defined once for the whole
+ * program: this file is compiled into the test and benchmark programs which
+ * count their allocations, and never into a program that already replaces
+ * them. It is not part of the library, and the tests which use it have their
+ * own executable, so that the other tests run with the standard allocation
+ * functions.
+ *
+ * The replacements are defined in their own translation unit, so that the
+ * compiler does not see them together with the code which allocates, and does
+ * not pair the `operator new` of that code with `std::free()`.
+ */
+
+#include "clap/debug/allocation_stats.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Allocate `size` bytes with `allocate`, calling the new handler until it
+// succeeds, as the standard `operator new` does.
+template <typename Allocate>
+auto CountedAllocate(std::size_t size, Allocate allocate) -> void * {
+  asap::clap::debug::RecordAllocation(size);
+  if (size == 0) {
+    size = 1;
+  }
+  for (;;) {
+    if (void *memory = allocate(size)) {
+      return memory;
+    }
+    const auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc{};
+    }
+    handler();
+  }
+}
+
+auto CountedAllocate(std::size_t size) -> void * {
+  return CountedAllocate(size, [](std::size_t bytes) {
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+    return std::malloc(bytes);
+  });
+}
+
+auto CountedAllocate(std::size_t size, std::align_val_t alignment) -> void * {
+  const auto align = static_cast<std::size_t>(alignment);
+  return CountedAllocate(size, [align](std::size_t bytes) {
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, align);
+#else
+    // `aligned_alloc` wants a size which is a multiple of the alignment.
+    bytes = (bytes + align - 1) / align * align;
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+    return std::aligned_alloc(align, bytes);
+#endif
+  });
+}
+
+void CountedFree(void *memory) noexcept {
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+  std::free(memory);
+}
+
+void CountedAlignedFree(void *memory) noexcept {
+#if defined(_WIN32)
+  _aligned_free(memory);
+#else
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc, hicpp-no-malloc)
+  std::free(memory);
+#endif
+}
+
+} // namespace
+
+auto operator new(std::size_t size) -> void * {
+  return CountedAllocate(size);
+}
+
+auto operator new[](std::size_t size) -> void * {
+  return CountedAllocate(size);
+}
+
+auto operator new(std::size_t size, const std::nothrow_t & /*tag*/) noexcept
+    -> void * {
+  try {
+    return CountedAllocate(size);
+  } catch (const std::bad_alloc & /*error*/) {
+    return nullptr;
+  }
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t & /*tag*/) noexcept
+    -> void * {
+  try {
+    return CountedAllocate(size);
+  } catch (const std::bad_alloc & /*error*/) {
+    return nullptr;
+  }
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void * {
+  return CountedAllocate(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void * {
+  return CountedAllocate(size, alignment);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment,
+    const std::nothrow_t & /*tag*/) noexcept -> void * {
+  try {
+    return CountedAllocate(size, alignment);
+  } catch (const std::bad_alloc & /*error*/) {
+    return nullptr;
+  }
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment,
+    const std::nothrow_t & /*tag*/) noexcept -> void * {
+  try {
+    return CountedAllocate(size, alignment);
+  } catch (const std::bad_alloc & /*error*/) {
+    return nullptr;
+  }
+}
+
+void operator delete(void *memory) noexcept {
+  CountedFree(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+  CountedFree(memory);
+}
+
+void operator delete(void *memory, std::size_t /*size*/) noexcept {
+  CountedFree(memory);
+}
+
+void operator delete[](void *memory, std::size_t /*size*/) noexcept {
+  CountedFree(memory);
+}
+
+void operator delete(void *memory, std::align_val_t /*alignment*/) noexcept {
+  CountedAlignedFree(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t /*alignment*/) noexcept {
+  CountedAlignedFree(memory);
+}
+
+void operator delete(void *memory, std::size_t /*size*/,
+    std::align_val_t /*alignment*/) noexcept {
+  CountedAlignedFree(memory);
+}
+
+void operator delete[](void *memory, std::size_t /*size*/,
+    std::align_val_t /*alignment*/) noexcept {
+  CountedAlignedFree(memory);
+}